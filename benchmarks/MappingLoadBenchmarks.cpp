@@ -0,0 +1,80 @@
+#include "MappingBinaryFormat.h"
+#include "MappingPersistence.h"
+#include "MappingSerializer.h"
+#include "catch2/benchmark/catch_benchmark_all.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+namespace
+{
+    // A busy layout: every control carries a few CC and note mappings
+    MidiMappingSet makeLayout (int seed)
+    {
+        MidiMappingSet set;
+
+        auto fill = [seed] (auto& group, bool isButton) {
+            for (size_t i = 0; i < group.size(); ++i)
+            {
+                for (int m = 0; m < 4; ++m)
+                {
+                    MidiMapping mapping;
+                    mapping.type = m % 2 == 0 ? MidiMapping::Type::ControlChange : MidiMapping::Type::Note;
+                    mapping.channel = 1 + (seed + m) % 16;
+                    mapping.ccNumber = static_cast<int> ((i * 4 + (size_t) m + (size_t) seed) % 128);
+                    mapping.noteNumber = 36 + m;
+                    mapping.minValue = 0.0f;
+                    mapping.maxValue = 127.0f;
+                    mapping.isButton = isButton;
+                    group[i].push_back (mapping);
+                }
+            }
+        };
+
+        fill (set.axisMappings, false);
+        fill (set.buttonMappings, true);
+        fill (set.gyroMappings, false);
+        fill (set.accelerometerMappings, false);
+        fill (set.touchpadMappings, false);
+        return set;
+    }
+}
+
+TEST_CASE ("Mapping load paths")
+{
+    // Hundreds of layouts x 4 pads, as in a large preset library
+    constexpr int numLayouts = 400 * 4;
+
+    juce::TemporaryFile jsonFile (".json");
+    juce::TemporaryFile binaryFile (".bin");
+
+    auto layout = makeLayout (7);
+    REQUIRE (MappingPersistence::writeMappings (jsonFile.getFile(), layout));
+    REQUIRE (MappingBinaryFormat::writeFile (layout, binaryFile.getFile()));
+
+    // Both paths must produce the same mappings
+    REQUIRE (MappingSerializer::readFile (jsonFile.getFile()) == layout);
+    REQUIRE (MappingBinaryView (binaryFile.getFile()).toMappingSet() == layout);
+
+    BENCHMARK ("JSON parse into mapping set")
+    {
+        size_t total = 0;
+        for (int i = 0; i < numLayouts; ++i)
+            total += MappingSerializer::readFile (jsonFile.getFile())->buttonMappings[0].size();
+        return total;
+    };
+
+    BENCHMARK ("Binary mmap, decode into mapping set")
+    {
+        size_t total = 0;
+        for (int i = 0; i < numLayouts; ++i)
+            total += MappingBinaryView (binaryFile.getFile()).toMappingSet().buttonMappings[0].size();
+        return total;
+    };
+
+    BENCHMARK ("Binary mmap, used in place")
+    {
+        size_t total = 0;
+        for (int i = 0; i < numLayouts; ++i)
+            total += MappingBinaryView (binaryFile.getFile()).getMappings (MappingBinaryFormat::buttonSlotBase).size();
+        return total;
+    };
+}
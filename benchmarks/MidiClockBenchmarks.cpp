@@ -0,0 +1,131 @@
+#include "MidiClock.h"
+#include "MidiOutputManager.h"
+#include "catch2/catch_test_macros.hpp"
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    constexpr double tickInterval = 60000.0 / (120.0 * MidiClock::ticksPerQuarterNote);
+
+    // What the clock hands the output, with the time it was due and the time it was handed over
+    struct Recorder : MidiOutputManager::Destination
+    {
+        struct Sent
+        {
+            juce::MidiMessage message;
+            double due = 0.0;
+            double handedOver = 0.0;
+        };
+
+        void send (const juce::MidiMessage& message, double millisecondCounter) override
+        {
+            sent.push_back ({ message, millisecondCounter, juce::Time::getMillisecondCounterHiRes() });
+        }
+
+        std::vector<Sent> sent;
+    };
+}
+
+TEST_CASE ("MIDI clock jitter on the real scheduling path")
+{
+    auto& output = MidiOutputManager::getInstance();
+    auto& clock = MidiClock::getInstance();
+
+    Recorder recorder;
+    recorder.sent.reserve (4096);
+    output.setDestination (&recorder);
+
+    clock.setSource (MidiClock::Source::Internal);
+    clock.setTempo (120.0);
+    clock.setSendClock (true);
+    clock.start();
+
+    // The clock's own timer runs on the message loop, with whatever lateness the system gives it
+    juce::MessageManager::getInstance()->runDispatchLoopUntil (3000);
+
+    clock.stop();
+    clock.setSendClock (false);
+    output.setDestination (nullptr);
+
+    REQUIRE (recorder.sent.size() > 2);
+    REQUIRE (recorder.sent.front().message.isMidiStart());
+    auto origin = recorder.sent.front().due;
+
+    // How far each tick's time is off the ideal grid, and how late it was handed
+    // over: a tick handed over after its time can only go out late
+    double maximumError = 0.0;
+    double maximumLate = 0.0;
+    double minimumLead = 1.0e9;
+    int lateTicks = 0;
+    int ticks = 0;
+
+    for (const auto& sent : recorder.sent)
+    {
+        if (!sent.message.isMidiClock())
+            continue;
+
+        maximumError = juce::jmax (maximumError, std::abs (sent.due - (origin + ticks * tickInterval)));
+        maximumLate = juce::jmax (maximumLate, sent.handedOver - sent.due);
+        minimumLead = juce::jmin (minimumLead, sent.due - sent.handedOver);
+        lateTicks += sent.handedOver > sent.due ? 1 : 0;
+        ++ticks;
+    }
+
+    WARN ("Ticks: " << ticks << ", off the grid by at most " << maximumError << " ms");
+    WARN ("Handed over at least " << minimumLead << " ms ahead; " << lateTicks << " late, by at most " << maximumLate << " ms");
+
+    // About three seconds of ticks, every one exactly on the grid and, stalls aside, ahead of time
+    CHECK (ticks > 3000.0 / tickInterval * 0.9);
+    CHECK (maximumError < 1.0e-6);
+    CHECK (lateTicks <= ticks / 20);
+}
+
+TEST_CASE ("MIDI clock tempo changes do not drift")
+{
+    // An hour of ticks with a tempo change every beat, back and forth
+    constexpr juce::int64 numTicks = 120 * 60 * MidiClock::ticksPerQuarterNote;
+
+    MidiClock::TickGrid grid;
+    grid.interval = tickInterval;
+
+    double accumulated = 0.0;
+    double exact = 0.0;
+
+    for (juce::int64 tick = 0; tick < numTicks; ++tick)
+    {
+        auto interval = (tick / MidiClock::ticksPerQuarterNote) % 2 == 0 ? tickInterval : tickInterval * 0.75;
+        if (tick % MidiClock::ticksPerQuarterNote == 0)
+            grid.setInterval (tick, interval);
+
+        // Exact in integer ticks of each tempo, then scaled once
+        exact = static_cast<double> (tick / (2 * MidiClock::ticksPerQuarterNote)) * 1.75 * MidiClock::ticksPerQuarterNote * tickInterval
+              + static_cast<double> (juce::jmin (tick % (2 * MidiClock::ticksPerQuarterNote), juce::int64 { MidiClock::ticksPerQuarterNote })) * tickInterval
+              + static_cast<double> (juce::jmax (juce::int64 { 0 }, tick % (2 * MidiClock::ticksPerQuarterNote) - MidiClock::ticksPerQuarterNote)) * tickInterval * 0.75;
+
+        if (tick > 0)
+            accumulated += (tick - 1) % (2 * MidiClock::ticksPerQuarterNote) < MidiClock::ticksPerQuarterNote ? tickInterval : tickInterval * 0.75;
+
+        CHECK (std::abs (grid.getTickTime (tick) - exact) < 1.0e-6);
+    }
+
+    WARN ("Drift after an hour: anchored " << std::abs (grid.getTickTime (numTicks - 1) - exact)
+          << " ms, accumulated " << std::abs (accumulated - exact) << " ms");
+}
+
+TEST_CASE ("MIDI clock quantise grid")
+{
+    MidiClock::TickGrid grid;
+    grid.interval = tickInterval;
+
+    constexpr int sixteenth = MidiClock::ticksPerQuarterNote / 4;
+    auto step = sixteenth * tickInterval;
+
+    CHECK (grid.getNextGridTime (0.0, sixteenth) == 0.0);
+    CHECK (std::abs (grid.getNextGridTime (1.0, sixteenth) - step) < 1.0e-9);
+    CHECK (std::abs (grid.getNextGridTime (step, sixteenth) - step) < 1.0e-9);
+
+    // Still on the same lines after a tempo change at a line
+    grid.setInterval (sixteenth * 4, tickInterval / 2.0);
+    CHECK (std::abs (grid.getNextGridTime (4.0 * step + 1.0, sixteenth) - (4.5 * step)) < 1.0e-9);
+}
@@ -0,0 +1,54 @@
+#include "MotionGestureRecognizer.h"
+#include "catch2/benchmark/catch_benchmark_all.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr double gravity = 9.81;
+
+    struct Sample
+    {
+        float gyro[3];
+        float accel[3];
+        std::uint64_t timestampNs;
+    };
+}
+
+TEST_CASE ("Motion gesture cost per sample")
+{
+    // One second of noisy motion for four pads at 1 kHz, both sensors
+    constexpr int numPads = 4;
+    constexpr int samplesPerPad = 1000;
+
+    std::mt19937 random (3);
+    std::normal_distribution<float> noise (0.0f, 3.0f);
+    std::vector<Sample> samples;
+
+    for (int i = 0; i < samplesPerPad; ++i)
+        samples.push_back ({ { noise (random), noise (random), noise (random) },
+                             { noise (random), static_cast<float> (gravity) + noise (random), noise (random) },
+                             static_cast<std::uint64_t> (i + 1) * 1'000'000 });
+
+    std::vector<MotionGestureRecognizer> pads (numPads);
+
+    BENCHMARK ("Four pads, one second at 1 kHz")
+    {
+        int changes = 0;
+        for (const auto& sample : samples)
+        {
+            for (auto& pad : pads)
+            {
+                changes += pad.addGyro (sample.gyro, sample.timestampNs) != 0;
+                changes += pad.addAccel (sample.accel, sample.timestampNs) != 0;
+            }
+        }
+
+        // The next run starts its own stream
+        for (auto& pad : pads)
+            pad.reset();
+
+        return changes;
+    };
+}
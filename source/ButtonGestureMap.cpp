@@ -0,0 +1,380 @@
+#include "ButtonGestureMap.h"
+#include "MidiOutputManager.h"
+#include <algorithm>
+
+namespace
+{
+    // Same order as GamepadManager reads the buttons
+    const char* const buttonNames[GamepadManager::MAX_BUTTONS] = {
+        "A", "B", "X", "Y", "Back", "Guide", "Start", "LeftStick", "RightStick",
+        "L1", "R1", "Up", "Down", "Left", "Right"
+    };
+
+    const char* const kindNames[] = { "layer", "chord", "doubleTap", "longPress" };
+
+    constexpr ButtonGestureMap::ButtonMask allButtons = (1u << GamepadManager::MAX_BUTTONS) - 1;
+
+    constexpr ButtonGestureMap::ButtonMask bit(int button) noexcept
+    {
+        return ButtonGestureMap::ButtonMask { 1 } << button;
+    }
+}
+
+//==============================================================================
+// Rows are states (Idle, Pending, WaitSecond, Active), columns are events
+// (None, Complete, Broken, Timeout). States a kind never enters fall back to Idle.
+const ButtonGestureMap::TransitionTable ButtonGestureMap::transitions = []
+{
+    using S = State;
+    using O = Output;
+    using T = Timer;
+
+    constexpr Transition reset { S::Idle, O::None, T::Clear };
+    constexpr std::array<Transition, 4> unused { reset, reset, reset, reset };
+
+    // Layers and chords are on for exactly as long as their buttons are held
+    constexpr std::array<std::array<Transition, 4>, 4> momentary {{
+        /* Idle */       {{ { S::Idle, O::None, T::Keep }, { S::Active, O::On, T::Clear }, { S::Idle, O::None, T::Keep }, reset }},
+        /* Pending */    unused,
+        /* WaitSecond */ unused,
+        /* Active */     {{ { S::Active, O::None, T::Keep }, { S::Active, O::None, T::Keep }, { S::Idle, O::Off, T::Clear }, { S::Active, O::None, T::Keep } }},
+    }};
+
+    constexpr std::array<std::array<Transition, 4>, 4> doubleTap {{
+        /* Idle */       {{ { S::Idle, O::None, T::Keep }, { S::Pending, O::None, T::Arm }, { S::Idle, O::None, T::Keep }, reset }},
+        // First press: releasing in time waits for the second, holding too long is not a tap
+        /* Pending */    {{ { S::Pending, O::None, T::Keep }, { S::Pending, O::None, T::Keep }, { S::WaitSecond, O::None, T::Keep }, reset }},
+        /* WaitSecond */ {{ { S::WaitSecond, O::None, T::Keep }, { S::Active, O::On, T::Clear }, { S::WaitSecond, O::None, T::Keep }, reset }},
+        /* Active */     {{ { S::Active, O::None, T::Keep }, { S::Active, O::None, T::Keep }, { S::Idle, O::Off, T::Clear }, { S::Active, O::None, T::Keep } }},
+    }};
+
+    constexpr std::array<std::array<Transition, 4>, 4> longPress {{
+        /* Idle */       {{ { S::Idle, O::None, T::Keep }, { S::Pending, O::None, T::Arm }, { S::Idle, O::None, T::Keep }, reset }},
+        /* Pending */    {{ { S::Pending, O::None, T::Keep }, { S::Pending, O::None, T::Keep }, reset, { S::Active, O::On, T::Clear } }},
+        /* WaitSecond */ unused,
+        /* Active */     {{ { S::Active, O::None, T::Keep }, { S::Active, O::None, T::Keep }, { S::Idle, O::Off, T::Clear }, { S::Active, O::None, T::Keep } }},
+    }};
+
+    return TransitionTable { momentary, momentary, doubleTap, longPress };
+}();
+
+//==============================================================================
+ButtonGestureMap::ButtonGestureMap()
+{
+    // A shift layer on L1 plus one of each other gesture, disabled until configured
+    std::vector<Rule> defaults;
+
+    for (int button = 0; button < 4; ++button)
+    {
+        Rule layer;
+        layer.kind = Kind::Layer;
+        layer.buttons = bit(findButton("L1"));
+        layer.trigger = button;
+        layer.action.number = 102 + button;
+        defaults.push_back(layer);
+    }
+
+    Rule chord;
+    chord.kind = Kind::Chord;
+    chord.buttons = bit(findButton("Back")) | bit(findButton("Start"));
+    chord.action.number = 106;
+    defaults.push_back(chord);
+
+    Rule doubleTap;
+    doubleTap.kind = Kind::DoubleTap;
+    doubleTap.buttons = bit(findButton("R1"));
+    doubleTap.action.number = 107;
+    defaults.push_back(doubleTap);
+
+    Rule longPress;
+    longPress.kind = Kind::LongPress;
+    longPress.buttons = bit(findButton("Start"));
+    longPress.action.number = 108;
+    defaults.push_back(longPress);
+
+    setRules(std::move(defaults));
+}
+
+int ButtonGestureMap::getDefaultTimeMs(Kind kind) noexcept
+{
+    switch (kind)
+    {
+        case Kind::Chord:     return 60;
+        case Kind::DoubleTap: return 300;
+        case Kind::LongPress: return 500;
+        case Kind::Layer:
+        case Kind::count:     break;
+    }
+
+    return 0;
+}
+
+bool ButtonGestureMap::setRules(std::vector<Rule> newRules)
+{
+    auto isValid = [](const Rule& rule)
+    {
+        if (rule.buttons == 0 || (rule.buttons & ~allButtons) != 0 || !juce::isPositiveAndNotGreaterThan(rule.timeMs, 10000)
+            || !juce::isPositiveAndBelow(static_cast<int>(rule.kind), static_cast<int>(Kind::count))
+            || rule.action.channel < 1 || rule.action.channel > 16
+            || !juce::isPositiveAndBelow(rule.action.number, 128) || !juce::isPositiveAndBelow(rule.action.value, 128))
+            return false;
+
+        if (rule.kind == Kind::Layer)
+            return juce::isPositiveAndBelow(rule.trigger, GamepadManager::MAX_BUTTONS) && (rule.buttons & bit(rule.trigger)) == 0;
+
+        return true;
+    };
+
+    if (newRules.size() > static_cast<size_t>(maxRules) || !std::all_of(newRules.begin(), newRules.end(), isValid))
+    {
+        juce::Logger::writeToLog("Ignoring invalid button gesture rules");
+        return false;
+    }
+
+    // Notes held by the old rules would never be released otherwise
+    releaseAll();
+
+    rules = std::move(newRules);
+    numCompiled = static_cast<int>(rules.size());
+    layerModifiers = 0;
+
+    for (size_t i = 0; i < rules.size(); ++i)
+    {
+        const auto& rule = rules[i];
+        auto& target = compiled[i];
+        target = {};
+        target.kind = rule.kind;
+        target.action = rule.action;
+        target.timeout = (rule.timeMs > 0 ? rule.timeMs : getDefaultTimeMs(rule.kind)) * 0.001;
+
+        if (rule.kind == Kind::Layer)
+        {
+            target.edge = bit(rule.trigger);
+            target.condition = rule.buttons | target.edge;
+            layerModifiers |= rule.buttons;
+        }
+        else
+        {
+            target.edge = rule.buttons;
+            target.condition = rule.buttons;
+        }
+    }
+
+    return true;
+}
+
+void ButtonGestureMap::setEnabled(bool shouldBeEnabled)
+{
+    if (!shouldBeEnabled)
+        releaseAll();
+
+    enabled = shouldBeEnabled;
+}
+
+ButtonGestureMap::Event ButtonGestureMap::getEvent(const CompiledRule& rule, ButtonMask held, ButtonMask pressed,
+                                                   double timeSeconds) const noexcept
+{
+    bool allHeld = (held & rule.condition) == rule.condition;
+
+    if (allHeld && (pressed & rule.edge) != 0)
+    {
+        if (rule.kind != Kind::Chord)
+            return Event::Complete;
+
+        // Chord members must all have gone down within the window
+        auto firstPress = timeSeconds;
+        GamepadManager::forEachButton(rule.condition, [&](int button)
+        {
+            firstPress = juce::jmin(firstPress, pressTimes[static_cast<size_t>(button)]);
+        });
+
+        if (timeSeconds - firstPress <= rule.timeout)
+            return Event::Complete;
+    }
+
+    if (rule.deadline > 0.0 && timeSeconds >= rule.deadline)
+        return Event::Timeout;
+
+    return allHeld ? Event::None : Event::Broken;
+}
+
+ButtonGestureMap::ButtonMask ButtonGestureMap::process(ButtonMask held, double timeSeconds) noexcept
+{
+    if (!enabled)
+        return 0;
+
+    held &= allButtons;
+    auto changed = held ^ previousHeld;
+    auto pressed = held & changed;
+    auto released = previousHeld & changed;
+    previousHeld = held;
+
+    GamepadManager::forEachButton(pressed, [&](int button) { pressTimes[static_cast<size_t>(button)] = timeSeconds; });
+
+    ButtonMask shifted = 0;
+    waitingRules = 0;
+
+    for (int i = 0; i < numCompiled; ++i)
+    {
+        auto& rule = compiled[static_cast<size_t>(i)];
+        auto event = getEvent(rule, held, pressed, timeSeconds);
+        const auto& transition = transitions[static_cast<size_t>(rule.kind)]
+                                            [static_cast<size_t>(rule.state)]
+                                            [static_cast<size_t>(event)];
+
+        rule.state = transition.next;
+
+        if (transition.timer == Timer::Arm)
+            rule.deadline = timeSeconds + rule.timeout;
+        else if (transition.timer == Timer::Clear)
+            rule.deadline = 0.0;
+
+        if (transition.output != Output::None)
+            sendAction(rule.action, transition.output == Output::On);
+
+        if (rule.deadline > 0.0)
+            waitingRules |= std::uint64_t { 1 } << i;
+
+        // While its modifiers are held the trigger belongs to the layer
+        if (rule.kind == Kind::Layer && (held & (rule.condition & ~rule.edge)) == (rule.condition & ~rule.edge))
+            shifted |= rule.edge;
+    }
+
+    // A swallowed press also swallows its release, wherever the modifiers are by then
+    auto suppressedPresses = (shifted | layerModifiers) & pressed;
+    auto suppressedReleases = (swallowed | layerModifiers) & released;
+    swallowed = (swallowed | suppressedPresses) & held;
+
+    return suppressedPresses | suppressedReleases;
+}
+
+bool ButtonGestureMap::isActive(int rule) const noexcept
+{
+    return juce::isPositiveAndBelow(rule, numCompiled) && compiled[static_cast<size_t>(rule)].state == State::Active;
+}
+
+void ButtonGestureMap::sendAction(const Action& action, bool on)
+{
+    if (action.type == Action::Type::Note)
+        MidiOutputManager::getInstance().sendNoteOn(action.channel, action.number, on ? static_cast<float>(action.value) / 127.0f : 0.0f);
+    else
+        MidiOutputManager::getInstance().sendControlChange(action.channel, action.number, on ? action.value : 0);
+}
+
+void ButtonGestureMap::releaseAll()
+{
+    for (int i = 0; i < numCompiled; ++i)
+    {
+        auto& rule = compiled[static_cast<size_t>(i)];
+        if (rule.state == State::Active)
+            sendAction(rule.action, false);
+
+        rule.state = State::Idle;
+        rule.deadline = 0.0;
+    }
+
+    previousHeld = 0;
+    swallowed = 0;
+    waitingRules = 0;
+}
+
+juce::String ButtonGestureMap::getButtonName(int button)
+{
+    return juce::isPositiveAndBelow(button, GamepadManager::MAX_BUTTONS) ? juce::String(buttonNames[button]) : juce::String();
+}
+
+int ButtonGestureMap::findButton(const juce::String& name)
+{
+    for (int button = 0; button < GamepadManager::MAX_BUTTONS; ++button)
+        if (name.equalsIgnoreCase(buttonNames[button]))
+            return button;
+
+    // Plain indices are accepted too
+    if (name.containsOnly("0123456789") && name.isNotEmpty())
+        return juce::isPositiveAndBelow(name.getIntValue(), GamepadManager::MAX_BUTTONS) ? name.getIntValue() : -1;
+
+    return -1;
+}
+
+juce::var ButtonGestureMap::toVar() const
+{
+    juce::Array<juce::var> ruleArray;
+
+    for (const auto& rule : rules)
+    {
+        juce::Array<juce::var> buttons;
+        GamepadManager::forEachButton(rule.buttons, [&](int button) { buttons.add(getButtonName(button)); });
+
+        juce::DynamicObject::Ptr actionObj = new juce::DynamicObject();
+        actionObj->setProperty("type", rule.action.type == Action::Type::Note ? "note" : "cc");
+        actionObj->setProperty("channel", rule.action.channel);
+        actionObj->setProperty("number", rule.action.number);
+        actionObj->setProperty("value", rule.action.value);
+
+        juce::DynamicObject::Ptr ruleObj = new juce::DynamicObject();
+        ruleObj->setProperty("kind", kindNames[static_cast<size_t>(rule.kind)]);
+        ruleObj->setProperty("buttons", buttons);
+        if (rule.kind == Kind::Layer)
+            ruleObj->setProperty("trigger", getButtonName(rule.trigger));
+        if (rule.timeMs > 0)
+            ruleObj->setProperty("timeMs", rule.timeMs);
+        ruleObj->setProperty("action", juce::var(actionObj));
+        ruleArray.add(juce::var(ruleObj));
+    }
+
+    juce::DynamicObject::Ptr obj = new juce::DynamicObject();
+    obj->setProperty("enabled", enabled);
+    obj->setProperty("rules", ruleArray);
+    return juce::var(obj);
+}
+
+bool ButtonGestureMap::fromVar(const juce::var& state)
+{
+    auto* obj = state.getDynamicObject();
+    auto* ruleArray = obj != nullptr ? obj->getProperty("rules").getArray() : nullptr;
+    if (ruleArray == nullptr)
+        return false;
+
+    std::vector<Rule> newRules;
+    for (const auto& ruleVar : *ruleArray)
+    {
+        Rule rule;
+
+        auto kindName = ruleVar.getProperty("kind", {}).toString();
+        auto kind = std::find_if(std::begin(kindNames), std::end(kindNames),
+                                 [&](const char* candidate) { return kindName == candidate; });
+        if (kind == std::end(kindNames))
+            return false;
+
+        rule.kind = static_cast<Kind>(std::distance(std::begin(kindNames), kind));
+
+        if (auto* buttons = ruleVar.getProperty("buttons", {}).getArray())
+        {
+            for (const auto& button : *buttons)
+            {
+                auto index = findButton(button.toString());
+                if (index < 0)
+                    return false;
+
+                rule.buttons |= bit(index);
+            }
+        }
+
+        rule.trigger = findButton(ruleVar.getProperty("trigger", {}).toString());
+        rule.timeMs = static_cast<int>(ruleVar.getProperty("timeMs", 0));
+
+        auto action = ruleVar.getProperty("action", {});
+        rule.action.type = action.getProperty("type", "cc").toString() == "note" ? Action::Type::Note : Action::Type::ControlChange;
+        rule.action.channel = static_cast<int>(action.getProperty("channel", 1));
+        rule.action.number = static_cast<int>(action.getProperty("number", 0));
+        rule.action.value = static_cast<int>(action.getProperty("value", 127));
+
+        newRules.push_back(rule);
+    }
+
+    if (!setRules(std::move(newRules)))
+        return false;
+
+    setEnabled(static_cast<bool>(obj->getProperty("enabled")));
+    return true;
+}
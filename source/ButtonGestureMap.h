@@ -0,0 +1,139 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "GamepadManager.h"
+
+/**
+ * Modifier layers, chords, double taps and long presses on the gamepad buttons.
+ *
+ * Rules are compiled into fixed arrays of button masks, and every rule steps
+ * through one shared transition table indexed by its kind, its state and the
+ * event seen this frame. A frame is a few mask operations per rule plus one
+ * pass over the buttons that were pressed, and it never allocates.
+ *
+ * Each rule drives one MIDI action: on when the gesture is recognised, off
+ * when its buttons are let go. Layer modifiers and the buttons they shift are
+ * reported back so their plain button mappings stay silent.
+ */
+class ButtonGestureMap
+{
+public:
+    using ButtonMask = GamepadManager::ButtonMask;
+
+    enum class Kind
+    {
+        Layer,      // trigger pressed while every modifier is held
+        Chord,      // all buttons pressed within a short window, in any order
+        DoubleTap,  // button pressed twice in quick succession
+        LongPress,  // button held for a while
+        count
+    };
+
+    struct Action
+    {
+        enum class Type
+        {
+            Note,
+            ControlChange
+        };
+
+        Type type = Type::ControlChange;
+        int channel = 1;
+        int number = 0;     // Note or CC number
+        int value = 127;    // Velocity or CC value while active; CCs return to 0
+
+        bool operator==(const Action&) const = default;
+    };
+
+    struct Rule
+    {
+        Kind kind = Kind::Chord;
+        ButtonMask buttons = 0;  // Layer: modifiers; otherwise every button of the gesture
+        int trigger = -1;        // Layer only
+        int timeMs = 0;          // Chord window, tap gap or hold time; 0 uses the default
+        Action action;
+
+        bool operator==(const Rule&) const = default;
+    };
+
+    static constexpr int maxRules = 32;
+
+    ButtonGestureMap();
+
+    // Validates and compiles the rules; the previous rules stay on failure
+    bool setRules(std::vector<Rule> newRules);
+    const std::vector<Rule>& getRules() const noexcept { return rules; }
+
+    void setEnabled(bool shouldBeEnabled);
+    bool isEnabled() const noexcept { return enabled; }
+
+    // Evaluate one input frame. Returns the buttons whose press or release this
+    // frame belongs to a gesture and must not reach their own mappings.
+    ButtonMask process(ButtonMask held, double timeSeconds) noexcept;
+
+    // True while a rule waits for a timeout, so frames must keep coming without input
+    bool isWaiting() const noexcept { return waitingRules != 0; }
+
+    // True from the frame a rule's gesture is recognised until it is let go
+    bool isActive(int rule) const noexcept;
+
+    // End every active gesture, e.g. on disconnect or when the rules change
+    void releaseAll();
+
+    static juce::String getButtonName(int button);
+    static int findButton(const juce::String& name);
+
+    // Persisted next to the mappings as JSON
+    juce::var toVar() const;
+    bool fromVar(const juce::var& state);
+
+private:
+    enum class State : std::uint8_t { Idle, Pending, WaitSecond, Active, count };
+    enum class Event : std::uint8_t { None, Complete, Broken, Timeout, count };
+    enum class Output : std::uint8_t { None, On, Off };
+    enum class Timer : std::uint8_t { Keep, Arm, Clear };
+
+    struct Transition
+    {
+        State next;
+        Output output;
+        Timer timer;
+    };
+
+    using TransitionTable = std::array<std::array<std::array<Transition, static_cast<size_t>(Event::count)>,
+                                                  static_cast<size_t>(State::count)>,
+                                       static_cast<size_t>(Kind::count)>;
+    static const TransitionTable transitions;
+
+    struct CompiledRule
+    {
+        Kind kind = Kind::Chord;
+        ButtonMask condition = 0;   // Everything that has to be held
+        ButtonMask edge = 0;        // A press of one of these can complete the gesture
+        double timeout = 0.0;
+        Action action;
+
+        State state = State::Idle;
+        double deadline = 0.0;
+    };
+
+    static int getDefaultTimeMs(Kind kind) noexcept;
+    Event getEvent(const CompiledRule& rule, ButtonMask held, ButtonMask pressed, double timeSeconds) const noexcept;
+    static void sendAction(const Action& action, bool on);
+
+    std::vector<Rule> rules;
+    std::array<CompiledRule, maxRules> compiled;
+    int numCompiled = 0;
+    ButtonMask layerModifiers = 0;
+
+    ButtonMask previousHeld = 0;
+    ButtonMask swallowed = 0;       // Held buttons whose press was suppressed
+    std::uint64_t waitingRules = 0;
+    std::array<double, GamepadManager::MAX_BUTTONS> pressTimes {};
+    bool enabled = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ButtonGestureMap)
+};
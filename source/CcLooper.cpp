@@ -0,0 +1,237 @@
+#include "CcLooper.h"
+#include "MidiClock.h"
+#include "MidiOutputManager.h"
+#include <cmath>
+#include <limits>
+
+double CcLooper::Lane::getLength() const noexcept
+{
+    return static_cast<double>(beats * MidiClock::ticksPerQuarterNote);
+}
+
+CcLooper::CcLooper()
+{
+    for (auto& lane : lanes)
+        lane.events.resize(maxEventsPerLane);
+}
+
+CcLooper::~CcLooper()
+{
+    stopTimer();
+}
+
+void CcLooper::toggleLane(int lane)
+{
+    if (!juce::isPositiveAndBelow(lane, numLanes))
+        return;
+
+    switch (lanes[static_cast<size_t>(lane)].state)
+    {
+        case State::Idle:
+            if (!MidiClock::getInstance().isRunning())
+                juce::Logger::writeToLog("Loop lane " + juce::String(lane + 1) + " waits for the MIDI clock to run");
+
+            setState(lane, State::Armed);
+            break;
+
+        case State::Armed:
+        case State::Recording:
+        case State::Playing:
+            setState(lane, State::Idle);
+            break;
+    }
+
+    logStateChanges();
+}
+
+void CcLooper::clearAll()
+{
+    for (int lane = 0; lane < numLanes; ++lane)
+        if (lanes[static_cast<size_t>(lane)].state != State::Idle)
+            setState(lane, State::Idle);
+
+    logStateChanges();
+}
+
+CcLooper::State CcLooper::getState(int lane) const noexcept
+{
+    return juce::isPositiveAndBelow(lane, numLanes) ? lanes[static_cast<size_t>(lane)].state : State::Idle;
+}
+
+void CcLooper::setLoopBeats(int lane, int beats)
+{
+    // A new length only applies to the next recording
+    if (juce::isPositiveAndBelow(lane, numLanes) && lanes[static_cast<size_t>(lane)].state == State::Idle)
+        lanes[static_cast<size_t>(lane)].beats = juce::jlimit(1, 64, beats);
+}
+
+int CcLooper::getLoopBeats(int lane) const noexcept
+{
+    return juce::isPositiveAndBelow(lane, numLanes) ? lanes[static_cast<size_t>(lane)].beats : 0;
+}
+
+void CcLooper::capture(int channel, int controller, int value) noexcept
+{
+    double position = 0.0;
+    bool hasPosition = false;
+
+    for (int index = 0; index < numLanes; ++index)
+    {
+        auto& lane = lanes[static_cast<size_t>(index)];
+        if (lane.state != State::Armed && lane.state != State::Recording)
+            continue;
+
+        // The clock is only read when a lane wants the event
+        if (!hasPosition && !(hasPosition = getPosition(position)))
+            return;
+
+        advance(index, position);
+
+        if (lane.state == State::Recording && lane.numEvents < maxEventsPerLane)
+        {
+            auto& event = lane.events[static_cast<size_t>(lane.numEvents++)];
+            event.position = position - lane.recordStart;
+            event.channel = static_cast<std::uint8_t>(channel);
+            event.controller = static_cast<std::uint8_t>(controller);
+            event.value = static_cast<std::uint8_t>(juce::jlimit(0, 127, value));
+        }
+    }
+}
+
+void CcLooper::timerCallback()
+{
+    // Including changes made while capturing, which must not allocate
+    logStateChanges();
+
+    double position = 0.0;
+    if (!getPosition(position))
+        return;
+
+    for (int index = 0; index < numLanes; ++index)
+    {
+        auto& lane = lanes[static_cast<size_t>(index)];
+        advance(index, position);
+
+        if (lane.state != State::Playing)
+            continue;
+
+        auto length = lane.getLength();
+        auto phase = position - std::floor(position / length) * length;
+
+        if (position < lane.lastPosition)
+        {
+            // The clock was restarted or moved back; pick up from the new phase without catching up
+            lane.nextEvent = 0;
+            while (lane.nextEvent < lane.numEvents && lane.events[static_cast<size_t>(lane.nextEvent)].position < phase)
+                ++lane.nextEvent;
+        }
+        else if (std::floor(position / length) > std::floor(lane.lastPosition / length))
+        {
+            // Wrapped: finish the previous pass first
+            playUntil(lane, length);
+            lane.nextEvent = 0;
+        }
+
+        playUntil(lane, phase);
+        lane.lastPosition = position;
+    }
+}
+
+void CcLooper::advance(int index, double position)
+{
+    auto& lane = lanes[static_cast<size_t>(index)];
+    auto length = lane.getLength();
+
+    if (lane.state == State::Armed)
+    {
+        // Recording starts on the next multiple of the length, so every loop lines up with
+        // the bar; a start that is not ahead within one loop is stale from a clock restart
+        if (lane.recordStart < position - length || lane.recordStart > position + length)
+            lane.recordStart = std::ceil(position / length) * length;
+
+        if (position >= lane.recordStart)
+            setState(index, State::Recording);
+    }
+    else if (lane.state == State::Recording)
+    {
+        if (position < lane.recordStart)
+        {
+            setState(index, State::Armed);
+            advance(index, position);
+        }
+        else if (position >= lane.recordStart + length)
+        {
+            lane.lastPosition = lane.recordStart + length;
+            setState(index, State::Playing);
+        }
+    }
+}
+
+void CcLooper::playUntil(Lane& lane, double phase)
+{
+    auto& midiOutput = MidiOutputManager::getInstance();
+
+    for (; lane.nextEvent < lane.numEvents; ++lane.nextEvent)
+    {
+        const auto& event = lane.events[static_cast<size_t>(lane.nextEvent)];
+        if (event.position > phase)
+            break;
+
+        midiOutput.sendControlChangeCoalesced(event.channel, event.controller, event.value);
+    }
+}
+
+void CcLooper::logStateChanges()
+{
+    for (int index = 0; index < numLanes; ++index)
+    {
+        auto& lane = lanes[static_cast<size_t>(index)];
+        if (lane.state == lane.loggedState)
+            continue;
+
+        lane.loggedState = lane.state;
+        juce::Logger::writeToLog("Loop lane " + juce::String(index + 1) + ": " + getStateName(lane.state)
+                                 + (lane.state == State::Playing ? " (" + juce::String(lane.numEvents) + " events)" : juce::String()));
+    }
+}
+
+void CcLooper::setState(int index, State newState)
+{
+    auto& lane = lanes[static_cast<size_t>(index)];
+    lane.state = newState;
+
+    if (newState == State::Armed)
+        lane.recordStart = std::numeric_limits<double>::lowest();
+
+    if (newState == State::Armed || newState == State::Idle)
+        lane.numEvents = 0;
+
+    lane.nextEvent = 0;
+
+    bool anyActive = false;
+    for (const auto& other : lanes)
+        anyActive = anyActive || other.state != State::Idle;
+
+    if (anyActive && !isTimerRunning())
+        startTimer(timerIntervalMs);
+    else if (!anyActive)
+        stopTimer();
+}
+
+bool CcLooper::getPosition(double& position) noexcept
+{
+    return MidiClock::getInstance().getTickPosition(juce::Time::getMillisecondCounterHiRes(), position);
+}
+
+juce::String CcLooper::getStateName(State state)
+{
+    switch (state)
+    {
+        case State::Armed:     return "armed";
+        case State::Recording: return "recording";
+        case State::Playing:   return "playing";
+        case State::Idle:      break;
+    }
+
+    return "idle";
+}
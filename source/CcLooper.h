@@ -0,0 +1,85 @@
+#pragma once
+
+#include <juce_events/juce_events.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Loops of mapped CC output, e.g. a gyro gesture repeating while both hands
+ * do something else.
+ *
+ * Each lane records the CCs the mappings produce for a whole number of
+ * beats, starting on a multiple of its length in clock ticks, and then plays
+ * them back at the same positions for as long as the MIDI clock runs. Events
+ * are stored by clock position, not time, so loops follow tempo changes and
+ * stay in phase with the clock. Recording only appends to buffers allocated
+ * up front; playback runs on its own timer and goes through the same CC
+ * coalescing as live input, so a loop and a live control on one CC merge.
+ */
+class CcLooper : private juce::Timer
+{
+public:
+    static constexpr int numLanes = 4;
+    static constexpr int maxEventsPerLane = 8192;
+
+    enum class State
+    {
+        Idle,
+        Armed,      // Waiting for the start of the next loop to record
+        Recording,
+        Playing
+    };
+
+    CcLooper();
+    ~CcLooper() override;
+
+    // Idle arms, armed or recording goes back to idle, playing stops and clears
+    void toggleLane(int lane);
+    void clearAll();
+    State getState(int lane) const noexcept;
+
+    void setLoopBeats(int lane, int beats);
+    int getLoopBeats(int lane) const noexcept;
+
+    // A CC the mappings just sent (message thread); never allocates
+    void capture(int channel, int controller, int value) noexcept;
+
+    static juce::String getStateName(State state);
+
+private:
+    struct Event
+    {
+        double position = 0.0;  // Clock ticks from the start of the loop
+        std::uint8_t channel = 1;
+        std::uint8_t controller = 0;
+        std::uint8_t value = 0;
+    };
+
+    struct Lane
+    {
+        State state = State::Idle;
+        int beats = 4;
+        double recordStart = 0.0;   // Clock position where recording starts
+        double lastPosition = 0.0;
+        std::vector<Event> events;
+        int numEvents = 0;
+        int nextEvent = 0;          // Next to play in this pass of the loop
+        State loggedState = State::Idle;
+
+        double getLength() const noexcept;
+    };
+
+    void timerCallback() override;
+    void advance(int index, double position);
+    static void playUntil(Lane& lane, double phase);
+    void setState(int index, State newState);   // Logged later, so capture() stays allocation free
+    void logStateChanges();
+    static bool getPosition(double& position) noexcept;
+
+    static constexpr int timerIntervalMs = 2;
+
+    std::array<Lane, numLanes> lanes;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CcLooper)
+};
@@ -0,0 +1,275 @@
+#include "FeedbackMap.h"
+#include "PerformanceStats.h"
+#include "TraceRecorder.h"
+#include <algorithm>
+
+namespace
+{
+    constexpr const char* sourceNames[] = { "note", "cc" };
+    constexpr const char* targetNames[] = { "rumble", "rumbleLow", "rumbleHigh", "led" };
+
+    template <typename Enum, size_t size>
+    bool findName(const char* const (&names)[size], const juce::String& name, Enum& result)
+    {
+        auto found = std::find_if(std::begin(names), std::end(names), [&](const char* candidate) { return name == candidate; });
+        if (found == std::end(names))
+            return false;
+
+        result = static_cast<Enum>(std::distance(std::begin(names), found));
+        return true;
+    }
+}
+
+FeedbackMap::FeedbackMap(GamepadManager& manager)
+    : gamepadManager(manager)
+{
+    // A click track on the GM side stick and kick, and a CC for the lightbar; disabled until configured
+    Rule click;
+    click.number = 37;
+    click.target = Rule::Target::RumbleHigh;
+    click.durationMs = 30;
+
+    Rule kick;
+    kick.number = 36;
+    kick.target = Rule::Target::RumbleLow;
+    kick.durationMs = 60;
+
+    Rule light;
+    light.source = Rule::Source::ControlChange;
+    light.number = 20;
+    light.target = Rule::Target::Led;
+    light.colour = 0x0000ff;
+
+    setRules({ click, kick, light });
+}
+
+FeedbackMap::~FeedbackMap()
+{
+    stopTimer();
+}
+
+bool FeedbackMap::setRules(std::vector<Rule> newRules)
+{
+    auto isValid = [](const Rule& rule)
+    {
+        return juce::isPositiveAndNotGreaterThan(rule.channel, 16)
+            && juce::isPositiveAndBelow(rule.number, 128)
+            && juce::isPositiveAndBelow(rule.pad, GamepadManager::MAX_GAMEPADS)
+            && juce::isPositiveAndNotGreaterThan(rule.durationMs, 10000)
+            && rule.colour <= 0xffffff;
+    };
+
+    if (newRules.size() > static_cast<size_t>(maxRules) || !std::all_of(newRules.begin(), newRules.end(), isValid))
+    {
+        juce::Logger::writeToLog("Ignoring invalid MIDI feedback rules");
+        return false;
+    }
+
+    releaseAll();
+    rules = std::move(newRules);
+
+    // Rules for any channel are copied to all sixteen, so a lookup never needs a second probe
+    std::vector<std::pair<size_t, size_t>> keyed;
+    for (size_t i = 0; i < rules.size(); ++i)
+    {
+        const auto& rule = rules[i];
+        for (int channel = 1; channel <= 16; ++channel)
+            if (rule.channel == 0 || rule.channel == channel)
+                keyed.emplace_back(getKey(rule.source, channel, rule.number), i);
+    }
+
+    std::stable_sort(keyed.begin(), keyed.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    compiled.clear();
+    compiled.reserve(keyed.size());
+    spans = {};
+
+    for (const auto& [key, index] : keyed)
+    {
+        auto& span = spans[key];
+        if (span.count++ == 0)
+            span.first = static_cast<std::uint16_t>(compiled.size());
+
+        compiled.push_back(rules[index]);
+    }
+
+    return true;
+}
+
+void FeedbackMap::setEnabled(bool shouldBeEnabled)
+{
+    if (!shouldBeEnabled)
+        releaseAll();
+
+    enabled = shouldBeEnabled;
+}
+
+size_t FeedbackMap::getKey(Rule::Source source, int channel, int number) noexcept
+{
+    return (static_cast<size_t>(source) * 16 + static_cast<size_t>(channel - 1)) * 128 + static_cast<size_t>(number);
+}
+
+void FeedbackMap::handleMessage(const MidiInputManager::Message& message)
+{
+    GAMEPAD_TRACE_SCOPE("FeedbackMap::handleMessage");
+
+    if (!enabled)
+        return;
+
+    auto source = message.isController() ? Rule::Source::ControlChange : Rule::Source::Note;
+    auto strength = message.isNoteOff() ? 0.0f : message.data2 / 127.0f;
+    const auto& span = spans[getKey(source, message.getChannel(), message.data1 & 0x7f)];
+
+    for (auto i = span.first; i < span.first + span.count; ++i)
+        apply(compiled[i], strength, message.timeMs);
+}
+
+void FeedbackMap::apply(const Rule& rule, float strength, double arrivalMs)
+{
+    auto& pad = pads[static_cast<size_t>(rule.pad)];
+
+    if (rule.target == Rule::Target::Led)
+    {
+        auto channel = [&](int shift) { return static_cast<std::uint8_t>(((rule.colour >> shift) & 0xff) * strength); };
+        pad.led = { channel(16), channel(8), channel(0) };
+
+        if (!pad.ledDirty && !pad.rumbleDirty)
+            pad.oldestChangeMs = arrivalMs;
+        pad.ledDirty = true;
+    }
+    else
+    {
+        if (rule.target != Rule::Target::RumbleHigh)
+            pad.low = strength;
+        if (rule.target != Rule::Target::RumbleLow)
+            pad.high = strength;
+        pad.rumbleMs = rule.durationMs;
+
+        if (!pad.ledDirty && !pad.rumbleDirty)
+            pad.oldestChangeMs = arrivalMs;
+        pad.rumbleDirty = true;
+    }
+
+    auto now = juce::Time::getMillisecondCounterHiRes();
+    if (now - pad.lastWriteMs >= minimumWriteIntervalMs)
+        flush(rule.pad, now);
+    else if (!isTimerRunning())
+        startTimer(1);
+}
+
+void FeedbackMap::flush(int index, double now)
+{
+    auto& pad = pads[static_cast<size_t>(index)];
+    if (!pad.rumbleDirty && !pad.ledDirty)
+        return;
+
+    if (pad.rumbleDirty)
+        gamepadManager.setRumble(index, pad.low, pad.high, pad.rumbleMs);
+
+    if (pad.ledDirty)
+        gamepadManager.setLed(index, pad.led[0], pad.led[1], pad.led[2]);
+
+    pad.rumbleDirty = pad.ledDirty = false;
+    pad.touched = true;
+    pad.lastWriteMs = now;
+
+    auto latencyMs = now - pad.oldestChangeMs;
+    PerformanceStats::getInstance().recordStageDuration(PerformanceStats::Stage::MidiToFeedback,
+                                                        static_cast<std::int64_t>(juce::jmax(0.0, latencyMs) * 1.0e6));
+}
+
+void FeedbackMap::timerCallback()
+{
+    auto now = juce::Time::getMillisecondCounterHiRes();
+    bool anyWaiting = false;
+
+    for (int index = 0; index < GamepadManager::MAX_GAMEPADS; ++index)
+    {
+        auto& pad = pads[static_cast<size_t>(index)];
+        if (!pad.rumbleDirty && !pad.ledDirty)
+            continue;
+
+        if (now - pad.lastWriteMs >= minimumWriteIntervalMs)
+            flush(index, now);
+        else
+            anyWaiting = true;
+    }
+
+    if (!anyWaiting)
+        stopTimer();
+}
+
+void FeedbackMap::releaseAll()
+{
+    stopTimer();
+
+    // Only pads this map has written to; the others keep whatever lightbar they have
+    for (int index = 0; index < GamepadManager::MAX_GAMEPADS; ++index)
+    {
+        auto& pad = pads[static_cast<size_t>(index)];
+        if (pad.touched)
+        {
+            gamepadManager.setRumble(index, 0.0f, 0.0f, 0);
+            gamepadManager.setLed(index, 0, 0, 0);
+        }
+
+        pad = {};
+    }
+}
+
+juce::var FeedbackMap::toVar() const
+{
+    juce::Array<juce::var> ruleArray;
+
+    for (const auto& rule : rules)
+    {
+        juce::DynamicObject::Ptr ruleObj = new juce::DynamicObject();
+        ruleObj->setProperty("source", sourceNames[static_cast<size_t>(rule.source)]);
+        ruleObj->setProperty("channel", rule.channel);
+        ruleObj->setProperty("number", rule.number);
+        ruleObj->setProperty("target", targetNames[static_cast<size_t>(rule.target)]);
+        ruleObj->setProperty("pad", rule.pad);
+        if (rule.target == Rule::Target::Led)
+            ruleObj->setProperty("colour", juce::String::toHexString(static_cast<int>(rule.colour)).paddedLeft('0', 6));
+        else
+            ruleObj->setProperty("durationMs", rule.durationMs);
+        ruleArray.add(juce::var(ruleObj));
+    }
+
+    juce::DynamicObject::Ptr obj = new juce::DynamicObject();
+    obj->setProperty("enabled", enabled);
+    obj->setProperty("rules", ruleArray);
+    return juce::var(obj);
+}
+
+bool FeedbackMap::fromVar(const juce::var& state)
+{
+    auto* obj = state.getDynamicObject();
+    auto* ruleArray = obj != nullptr ? obj->getProperty("rules").getArray() : nullptr;
+    if (ruleArray == nullptr)
+        return false;
+
+    std::vector<Rule> newRules;
+    for (const auto& ruleVar : *ruleArray)
+    {
+        Rule rule;
+
+        if (!findName(sourceNames, ruleVar.getProperty("source", "note").toString(), rule.source)
+            || !findName(targetNames, ruleVar.getProperty("target", {}).toString(), rule.target))
+            return false;
+
+        rule.channel = static_cast<int>(ruleVar.getProperty("channel", 0));
+        rule.number = static_cast<int>(ruleVar.getProperty("number", 0));
+        rule.pad = static_cast<int>(ruleVar.getProperty("pad", 0));
+        rule.durationMs = static_cast<int>(ruleVar.getProperty("durationMs", 60));
+        rule.colour = static_cast<std::uint32_t>(ruleVar.getProperty("colour", "ffffff").toString().getHexValue32());
+
+        newRules.push_back(rule);
+    }
+
+    if (!setRules(std::move(newRules)))
+        return false;
+
+    setEnabled(static_cast<bool>(obj->getProperty("enabled")));
+    return true;
+}
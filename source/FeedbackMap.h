@@ -0,0 +1,109 @@
+#pragma once
+
+#include <juce_events/juce_events.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "GamepadManager.h"
+#include "MidiInputManager.h"
+
+/**
+ * Incoming notes and CCs to rumble and lightbar, e.g. a click track from the
+ * DAW felt in the hands.
+ *
+ * Rules are compiled into one flat array plus a span per note or CC number
+ * on each channel, so a message costs one table lookup and a walk over the
+ * rules it triggers. Writes to a pad go out at most once per interval: a
+ * Bluetooth controller takes every rumble or LED change as a full output
+ * report, and flooding the link delays input as well. Changes inside the
+ * interval are merged, the newest value of each motor and the LED winning,
+ * and written when the interval has passed.
+ */
+class FeedbackMap : private juce::Timer
+{
+public:
+    struct Rule
+    {
+        enum class Source
+        {
+            Note,           // Velocity sets the strength; note off ends it
+            ControlChange   // Value sets the strength
+        };
+
+        enum class Target
+        {
+            Rumble,         // Both motors
+            RumbleLow,
+            RumbleHigh,
+            Led             // Colour scaled by the strength
+        };
+
+        Source source = Source::Note;
+        int channel = 0;            // 1-16, or 0 for any
+        int number = 0;             // Note or CC number
+        Target target = Target::Rumble;
+        int pad = 0;                // Gamepad slot
+        int durationMs = 60;        // Longest a rumble lasts without another message
+        std::uint32_t colour = 0xffffff;
+
+        bool operator==(const Rule&) const = default;
+    };
+
+    static constexpr int maxRules = 256;
+    static constexpr double minimumWriteIntervalMs = 10.0;
+
+    explicit FeedbackMap(GamepadManager& manager);
+    ~FeedbackMap() override;
+
+    // Validates and compiles the rules; the previous rules stay on failure
+    bool setRules(std::vector<Rule> newRules);
+    const std::vector<Rule>& getRules() const noexcept { return rules; }
+
+    void setEnabled(bool shouldBeEnabled);
+    bool isEnabled() const noexcept { return enabled; }
+
+    // Message thread
+    void handleMessage(const MidiInputManager::Message& message);
+
+    // Stop every motor and turn the LEDs off
+    void releaseAll();
+
+    // Persisted next to the mappings as JSON
+    juce::var toVar() const;
+    bool fromVar(const juce::var& state);
+
+private:
+    struct Span
+    {
+        std::uint16_t first = 0;
+        std::uint16_t count = 0;
+    };
+
+    struct PadOutput
+    {
+        float low = 0.0f;
+        float high = 0.0f;
+        int rumbleMs = 0;
+        std::array<std::uint8_t, 3> led {};
+
+        bool rumbleDirty = false;
+        bool ledDirty = false;
+        double oldestChangeMs = 0.0;    // Arrival of the first message waiting in this write
+        double lastWriteMs = 0.0;
+        bool touched = false;           // Written to since the last release
+    };
+
+    static size_t getKey(Rule::Source source, int channel, int number) noexcept;
+    void apply(const Rule& rule, float strength, double arrivalMs);
+    void flush(int index, double now);
+    void timerCallback() override;
+
+    GamepadManager& gamepadManager;
+    std::vector<Rule> rules;
+    std::vector<Rule> compiled;
+    std::array<Span, 2 * 16 * 128> spans {};
+    std::array<PadOutput, GamepadManager::MAX_GAMEPADS> pads;
+    bool enabled = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FeedbackMap)
+};
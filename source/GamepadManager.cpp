@@ -1,4 +1,30 @@
 #include "GamepadManager.h"
+#include "PerformanceStats.h"
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // SDL's button for each of our button indices
+    constexpr std::array<SDL_GamepadButton, GamepadManager::MAX_BUTTONS> sdlButtons {
+        SDL_GAMEPAD_BUTTON_SOUTH,           // A
+        SDL_GAMEPAD_BUTTON_EAST,            // B
+        SDL_GAMEPAD_BUTTON_WEST,            // X
+        SDL_GAMEPAD_BUTTON_NORTH,           // Y
+        SDL_GAMEPAD_BUTTON_BACK,
+        SDL_GAMEPAD_BUTTON_GUIDE,
+        SDL_GAMEPAD_BUTTON_START,
+        SDL_GAMEPAD_BUTTON_LEFT_STICK,
+        SDL_GAMEPAD_BUTTON_RIGHT_STICK,
+        SDL_GAMEPAD_BUTTON_LEFT_SHOULDER,
+        SDL_GAMEPAD_BUTTON_RIGHT_SHOULDER,
+        SDL_GAMEPAD_BUTTON_DPAD_UP,
+        SDL_GAMEPAD_BUTTON_DPAD_DOWN,
+        SDL_GAMEPAD_BUTTON_DPAD_LEFT,
+        SDL_GAMEPAD_BUTTON_DPAD_RIGHT
+    };
+}
 
 GamepadManager::GamepadManager()
 {
@@ -78,7 +104,11 @@ void GamepadManager::updateGamepadStates()
         return;
     }
     
-    // Process SDL events (important for device hot-plugging)
+    GAMEPAD_TRACE_SCOPE("GamepadManager::updateGamepadStates");
+    PerformanceStats::ScopedTiming timing(PerformanceStats::Stage::UpdateGamepadStates);
+    
+    // Process SDL events (important for device hot-plugging); axes and
+    // sensors arrive through them, each sample with its own timestamp
     handleSDLEvents();
     
     bool stateChanged = false;
@@ -118,100 +148,19 @@ void GamepadManager::updateGamepadStates()
                 }
             }
             
-            // Update axes
-            for (size_t axis = 0; axis < MAX_AXES; ++axis)
+            // Update buttons
+            ButtonMask buttons = 0;
+            for (size_t button = 0; button < MAX_BUTTONS; ++button)
             {
-                SDL_GamepadAxis sdlAxis = SDL_GAMEPAD_AXIS_INVALID;
-                
-                // Map our axes indices to SDL axes
-                switch (axis)
-                {
-                    case 0: sdlAxis = SDL_GAMEPAD_AXIS_LEFTX; break;
-                    case 1: sdlAxis = SDL_GAMEPAD_AXIS_LEFTY; break;
-                    case 2: sdlAxis = SDL_GAMEPAD_AXIS_RIGHTX; break;
-                    case 3: sdlAxis = SDL_GAMEPAD_AXIS_RIGHTY; break;
-                    case 4: sdlAxis = SDL_GAMEPAD_AXIS_LEFT_TRIGGER; break;
-                    case 5: sdlAxis = SDL_GAMEPAD_AXIS_RIGHT_TRIGGER; break;
-                    default: break;
-                }
-                
-                if (sdlAxis != SDL_GAMEPAD_AXIS_INVALID)
-                {
-                    // SDL axes range from -32768 to 32767, normalize to -1.0 to 1.0
-                    float axisValue = SDL_GetGamepadAxis(sdlGamepads[i], sdlAxis) / 32767.0f;
-                    
-                    // For triggers (L2 and R2), we need to handle them differently
-                    if (axis == 4 || axis == 5) // L2 or R2
-                    {
-                        // Triggers range from 0 to 32767, normalize to 0.0 to 1.0
-                        axisValue = SDL_GetGamepadAxis(sdlGamepads[i], sdlAxis) / 32767.0f;
-                        
-                        // Apply a small deadzone for triggers
-                        if (axisValue < 0.1f)
-                            axisValue = 0.0f;
-                    }
-                    else
-                    {
-                        // Apply a small deadzone for other axes
-                        if (std::abs(axisValue) < 0.1f)
-                            axisValue = 0.0f;
-                    }
-                    
-                    // Check if value has changed
-                    if (std::abs(gamepadStates[i].axes[axis] - axisValue) > 0.01f)
-                    {
-                        // Log trigger values
-                        if (axis == 4 || axis == 5)
-                        {
-                            juce::Logger::writeToLog("Raw trigger value for " + 
-                                juce::String(axis == 4 ? "L2" : "R2") + 
-                                ": " + juce::String(SDL_GetGamepadAxis(sdlGamepads[i], sdlAxis)) +
-                                ", Normalized: " + juce::String(axisValue));
-                        }
-                        
-                        gamepadStates[i].axes[axis] = axisValue;
-                        stateChanged = true;
-                    }
-                }
+                if (SDL_GetGamepadButton(sdlGamepads[i], sdlButtons[button]))
+                    buttons |= ButtonMask { 1 } << button;
             }
             
-            // Update buttons
-            for (size_t button = 0; button < MAX_BUTTONS; ++button)
+            // One compare covers every button
+            if (gamepadStates[i].buttons != buttons)
             {
-                SDL_GamepadButton sdlButton = SDL_GAMEPAD_BUTTON_INVALID;
-                
-                // Map our button indices to SDL buttons
-                switch (button)
-                {
-                    case 0: sdlButton = SDL_GAMEPAD_BUTTON_SOUTH; break;  // A
-                    case 1: sdlButton = SDL_GAMEPAD_BUTTON_EAST; break;   // B
-                    case 2: sdlButton = SDL_GAMEPAD_BUTTON_WEST; break;   // X
-                    case 3: sdlButton = SDL_GAMEPAD_BUTTON_NORTH; break;  // Y
-                    case 4: sdlButton = SDL_GAMEPAD_BUTTON_BACK; break;
-                    case 5: sdlButton = SDL_GAMEPAD_BUTTON_GUIDE; break;
-                    case 6: sdlButton = SDL_GAMEPAD_BUTTON_START; break;
-                    case 7: sdlButton = SDL_GAMEPAD_BUTTON_LEFT_STICK; break;
-                    case 8: sdlButton = SDL_GAMEPAD_BUTTON_RIGHT_STICK; break;
-                    case 9: sdlButton = SDL_GAMEPAD_BUTTON_LEFT_SHOULDER; break;
-                    case 10: sdlButton = SDL_GAMEPAD_BUTTON_RIGHT_SHOULDER; break;
-                    case 11: sdlButton = SDL_GAMEPAD_BUTTON_DPAD_UP; break;
-                    case 12: sdlButton = SDL_GAMEPAD_BUTTON_DPAD_DOWN; break;
-                    case 13: sdlButton = SDL_GAMEPAD_BUTTON_DPAD_LEFT; break;
-                    case 14: sdlButton = SDL_GAMEPAD_BUTTON_DPAD_RIGHT; break;
-                    default: break;
-                }
-                
-                if (sdlButton != SDL_GAMEPAD_BUTTON_INVALID)
-                {
-                    bool buttonState = SDL_GetGamepadButton(sdlGamepads[i], sdlButton) == 1;
-                    
-                    // Check if state has changed
-                    if (gamepadStates[i].buttons[button] != buttonState)
-                    {
-                        gamepadStates[i].buttons[button] = buttonState;
-                        stateChanged = true;
-                    }
-                }
+                gamepadStates[i].buttons = buttons;
+                stateChanged = true;
             }
             
             // Check touchpad button (it's a separate button in SDL)
@@ -227,16 +176,23 @@ void GamepadManager::updateGamepadStates()
     // Notify callbacks if any state changed
     if (stateChanged)
     {
-        for (auto& callback : stateChangeCallbacks)
-            callback();
+        notifyStateChanged();
     }
 }
 
 void GamepadManager::handleSDLEvents()
 {
+    GAMEPAD_TRACE_SCOPE("GamepadManager::handleSDLEvents");
+    
+    auto& stats = PerformanceStats::getInstance();
+    int eventsThisPoll = 0;
+    
     SDL_Event event;
     while (SDL_PollEvent(&event))
     {
+        ++eventsThisPoll;
+        stats.recordSdlEvent(classifyEvent(event.type));
+        
         if (event.type == SDL_EVENT_GAMEPAD_ADDED)
         {
             // Immediately handle the new gamepad connection
@@ -272,6 +228,11 @@ void GamepadManager::handleSDLEvents()
                             gamepadStates[i].name = SDL_GetGamepadName(sdlGamepads[i]);
                             gamepadStates[i].deviceId = deviceId;
                             
+                            // Only the first touchpad is tracked, but all of its fingers are
+                            gamepadStates[i].touchpad.numFingers = SDL_GetNumGamepadTouchpads(sdlGamepads[i]) > 0
+                                ? juce::jlimit(0, MAX_TOUCHPAD_FINGERS, SDL_GetNumGamepadTouchpadFingers(sdlGamepads[i], 0))
+                                : 0;
+                            
                             juce::Logger::writeToLog("DEBUG: Successfully opened gamepad at slot " + juce::String(i) + 
                                                    "\n - Name: " + gamepadStates[i].name + 
                                                    "\n - Device ID: " + juce::String(gamepadStates[i].deviceId) +
@@ -338,8 +299,7 @@ void GamepadManager::handleSDLEvents()
                             }
                             
                             // Notify callbacks of the new connection
-                            for (auto& callback : stateChangeCallbacks)
-                                callback();
+                            notifyStateChanged();
                             
                             break;
                         }
@@ -372,19 +332,69 @@ void GamepadManager::handleSDLEvents()
                     for (auto& axis : gamepadStates[i].axes)
                         axis = 0.0f;
                     
-                    for (auto& button : gamepadStates[i].buttons)
-                        button = false;
+                    gamepadStates[i].axisSpeeds = {};
+                    gamepadStates[i].axisTimestamps = {};
+                    axisMotion[i] = {};
+                    sensorClocks[i] = {};
+                    
+                    gamepadStates[i].buttons = 0;
+                    gamepadStates[i].buttonTimestamps = {};
                     
                     // Reset touchpad state
-                    gamepadStates[i].touchpad.touched = false;
-                    gamepadStates[i].touchpad.pressed = false;
-                    gamepadStates[i].touchpad.x = 0.0f;
-                    gamepadStates[i].touchpad.y = 0.0f;
-                    gamepadStates[i].touchpad.pressure = 0.0f;
+                    gamepadStates[i].touchpad = {};
+                    
+                    releaseMotionGestures(i);
                     
                     // Notify callbacks
-                    for (auto& callback : stateChangeCallbacks)
-                        callback();
+                    notifyStateChanged();
+                    
+                    break;
+                }
+            }
+        }
+        // Buttons are read when the states are polled; the events only say
+        // when each one changed, so the mappings can be timed from that
+        else if (event.type == SDL_EVENT_GAMEPAD_BUTTON_DOWN || event.type == SDL_EVENT_GAMEPAD_BUTTON_UP)
+        {
+            for (size_t i = 0; i < MAX_GAMEPADS; ++i)
+            {
+                if (sdlGamepads[i] != nullptr && 
+                    (gamepadStates[i].deviceId == event.gbutton.which || 
+                     SDL_GetGamepadID(sdlGamepads[i]) == event.gbutton.which))
+                {
+                    auto button = std::find(sdlButtons.begin(), sdlButtons.end(), static_cast<SDL_GamepadButton>(event.gbutton.button));
+                    if (button != sdlButtons.end())
+                        gamepadStates[i].buttonTimestamps[static_cast<size_t>(button - sdlButtons.begin())] = toHighResolutionTicks(event.gbutton.timestamp);
+                    
+                    break;
+                }
+            }
+        }
+        // Every axis sample feeds the speed estimate and, once past the
+        // sample threshold, the state, each with its own timestamp
+        else if (event.type == SDL_EVENT_GAMEPAD_AXIS_MOTION)
+        {
+            for (size_t i = 0; i < MAX_GAMEPADS; ++i)
+            {
+                if (sdlGamepads[i] != nullptr && 
+                    (gamepadStates[i].deviceId == event.gaxis.which || 
+                     SDL_GetGamepadID(sdlGamepads[i]) == event.gaxis.which))
+                {
+                    // Our axis indices follow SDL's axis order
+                    if (juce::isPositiveAndBelow(static_cast<int>(event.gaxis.axis), MAX_AXES))
+                    {
+                        auto axis = static_cast<size_t>(event.gaxis.axis);
+                        auto rawValue = event.gaxis.value / 32767.0f;
+                        updateAxisMotion(i, event.gaxis.axis, rawValue, event.gaxis.timestamp);
+                        
+                        auto value = applyDeadzone(event.gaxis.axis, rawValue);
+                        if (std::abs(gamepadStates[i].axes[axis] - value) > sampleThreshold)
+                        {
+                            gamepadStates[i].axes[axis] = value;
+                            gamepadStates[i].axisTimestamps[axis] = toHighResolutionTicks(event.gaxis.timestamp);
+                            notifyStateChanged();
+                        }
+                    }
                     
                     break;
                 }
@@ -411,9 +421,17 @@ void GamepadManager::handleSDLEvents()
                         gamepadStates[i].deviceId = gamepadId;
                     }
                     
+                    // Gestures see every raw sample, before the threshold below drops any
+                    updateMotionGestures(i, event.gsensor);
+                    
                     bool stateChanged = false;
                     static int logCounter = 0;  // Static counter to limit log frequency
                     
+                    // Filters downstream need the time the sample was taken, not when the batch was read
+                    auto& sensorClock = sensorClocks[i][event.gsensor.sensor == SDL_SENSOR_GYRO ? 0 : 1];
+                    auto sampleTicks = toHighResolutionTicks(sensorClock.toEventTime(event.gsensor.sensor_timestamp,
+                                                                                     event.gsensor.timestamp));
+                    
                     // This is a gyroscope event
                     if (event.gsensor.sensor == SDL_SENSOR_GYRO)
                     {
@@ -422,18 +440,18 @@ void GamepadManager::handleSDLEvents()
                         // We'll scale this to a -1 to 1 range for display and MIDI
                         const float gyroScale = 0.1f; // Scale factor to convert radians/second to normalized range
                         
-                        // Check if values have changed significantly (apply small threshold)
-                        if (std::abs(gamepadStates[i].gyroscope.x - event.gsensor.data[0] * gyroScale) > 0.01f)
+                        // Check if values have changed enough to count as a new sample
+                        if (std::abs(gamepadStates[i].gyroscope.x - event.gsensor.data[0] * gyroScale) > sampleThreshold)
                         {
                             gamepadStates[i].gyroscope.x = event.gsensor.data[0] * gyroScale;
                             stateChanged = true;
                         }
-                        if (std::abs(gamepadStates[i].gyroscope.y - event.gsensor.data[1] * gyroScale) > 0.01f)
+                        if (std::abs(gamepadStates[i].gyroscope.y - event.gsensor.data[1] * gyroScale) > sampleThreshold)
                         {
                             gamepadStates[i].gyroscope.y = event.gsensor.data[1] * gyroScale;
                             stateChanged = true;
                         }
-                        if (std::abs(gamepadStates[i].gyroscope.z - event.gsensor.data[2] * gyroScale) > 0.01f)
+                        if (std::abs(gamepadStates[i].gyroscope.z - event.gsensor.data[2] * gyroScale) > sampleThreshold)
                         {
                             gamepadStates[i].gyroscope.z = event.gsensor.data[2] * gyroScale;
                             stateChanged = true;
@@ -443,6 +461,7 @@ void GamepadManager::handleSDLEvents()
                         {
                             // Indicate that the gyroscope is working
                             gamepadStates[i].gyroscope.enabled = true;
+                            gamepadStates[i].gyroscope.timestamp = sampleTicks;
                             
                             // // Log gyro data occasionally to avoid flooding
                             // if (++logCounter >= 30)  // Log every ~30th change
@@ -462,18 +481,18 @@ void GamepadManager::handleSDLEvents()
                         // Scale accelerometer values from -10/10 to -1/1 range
                         const float accelScale = 0.1f; // Scale factor to convert from -10/10 to -1/1
                         
-                        // Check if values have changed significantly (apply small threshold)
-                        if (std::abs(gamepadStates[i].accelerometer.x - event.gsensor.data[0] * accelScale) > 0.01f)
+                        // Check if values have changed enough to count as a new sample
+                        if (std::abs(gamepadStates[i].accelerometer.x - event.gsensor.data[0] * accelScale) > sampleThreshold)
                         {
                             gamepadStates[i].accelerometer.x = event.gsensor.data[0] * accelScale;
                             stateChanged = true;
                         }
-                        if (std::abs(gamepadStates[i].accelerometer.y - event.gsensor.data[1] * accelScale) > 0.01f)
+                        if (std::abs(gamepadStates[i].accelerometer.y - event.gsensor.data[1] * accelScale) > sampleThreshold)
                         {
                             gamepadStates[i].accelerometer.y = event.gsensor.data[1] * accelScale;
                             stateChanged = true;
                         }
-                        if (std::abs(gamepadStates[i].accelerometer.z - event.gsensor.data[2] * accelScale) > 0.01f)
+                        if (std::abs(gamepadStates[i].accelerometer.z - event.gsensor.data[2] * accelScale) > sampleThreshold)
                         {
                             gamepadStates[i].accelerometer.z = event.gsensor.data[2] * accelScale;
                             stateChanged = true;
@@ -483,6 +502,7 @@ void GamepadManager::handleSDLEvents()
                         {
                             // Indicate that the accelerometer is working
                             gamepadStates[i].accelerometer.enabled = true;
+                            gamepadStates[i].accelerometer.timestamp = sampleTicks;
                             
                             // // Log accelerometer data occasionally to avoid flooding
                             // if (++logCounter >= 30)  // Log every ~30th change
@@ -500,8 +520,7 @@ void GamepadManager::handleSDLEvents()
                     // Notify callbacks if state changed
                     if (stateChanged)
                     {
-                        for (auto& callback : stateChangeCallbacks)
-                            callback();
+                        notifyStateChanged();
                     }
                     
                     break;
@@ -529,43 +548,192 @@ void GamepadManager::handleSDLEvents()
                         gamepadStates[i].deviceId = event.gtouchpad.which;
                     }
                     
-                    bool stateChanged = false;
+                    auto& touchpad = gamepadStates[i].touchpad;
                     
-                    // Update touchpad state based on event type
-                    if (event.type == SDL_EVENT_GAMEPAD_TOUCHPAD_DOWN)
-                    {
-                        gamepadStates[i].touchpad.touched = true;
-                        gamepadStates[i].touchpad.x = event.gtouchpad.x;
-                        gamepadStates[i].touchpad.y = event.gtouchpad.y;
-                        gamepadStates[i].touchpad.pressure = event.gtouchpad.pressure;
-                        stateChanged = true;
-                    }
-                    else if (event.type == SDL_EVENT_GAMEPAD_TOUCHPAD_MOTION)
+                    // Fingers beyond what we track (or on a second touchpad) are ignored
+                    if (event.gtouchpad.touchpad != 0
+                        || !juce::isPositiveAndBelow(event.gtouchpad.finger, MAX_TOUCHPAD_FINGERS))
+                        break;
+                    
+                    auto& finger = touchpad.fingers[static_cast<size_t>(event.gtouchpad.finger)];
+                    
+                    // Update the finger based on event type
+                    if (event.type == SDL_EVENT_GAMEPAD_TOUCHPAD_UP)
                     {
-                        gamepadStates[i].touchpad.x = event.gtouchpad.x;
-                        gamepadStates[i].touchpad.y = event.gtouchpad.y;
-                        gamepadStates[i].touchpad.pressure = event.gtouchpad.pressure;
-                        stateChanged = true;
+                        finger.down = false;
+                        finger.pressure = 0.0f;
                     }
-                    else if (event.type == SDL_EVENT_GAMEPAD_TOUCHPAD_UP)
+                    else
                     {
-                        gamepadStates[i].touchpad.touched = false;
-                        gamepadStates[i].touchpad.pressure = 0.0f;
-                        stateChanged = true;
+                        finger.down = true;
+                        finger.x = event.gtouchpad.x;
+                        finger.y = event.gtouchpad.y;
+                        finger.pressure = event.gtouchpad.pressure;
                     }
                     
-                    // Notify callbacks if state changed
-                    if (stateChanged)
+                    touchpad.numFingers = juce::jmax(touchpad.numFingers, event.gtouchpad.finger + 1);
+                    touchpad.timestamp = toHighResolutionTicks(event.gtouchpad.timestamp);
+                    
+                    // Single point view for consumers that only follow one finger
+                    touchpad.touched = false;
+                    touchpad.pressure = 0.0f;
+                    for (const auto& f : touchpad.fingers)
                     {
-                        for (auto& callback : stateChangeCallbacks)
-                            callback();
+                        if (f.down)
+                        {
+                            touchpad.touched = true;
+                            touchpad.x = f.x;
+                            touchpad.y = f.y;
+                            touchpad.pressure = f.pressure;
+                            break;
+                        }
                     }
                     
+                    notifyStateChanged();
                     break;
                 }
             }
         }
     }
+    
+    // Number of events that were waiting for us is the backlog of the SDL queue
+    stats.setQueueDepth(PerformanceStats::Queue::SdlEvents, eventsThisPoll);
+}
+
+void GamepadManager::updateMotionGestures(size_t gamepad, const SDL_GamepadSensorEvent& sensor)
+{
+    // Not every backend has sensor timestamps; the event time is the next best clock
+    auto timestampNs = sensor.sensor_timestamp != 0 ? sensor.sensor_timestamp : sensor.timestamp;
+    auto& recognizer = motionGestures[gamepad];
+    MotionGestureRecognizer::GestureMask changed = 0;
+    
+    if (sensor.sensor == SDL_SENSOR_GYRO)
+        changed = recognizer.addGyro(sensor.data, timestampNs);
+    else if (sensor.sensor == SDL_SENSOR_ACCEL)
+        changed = recognizer.addAccel(sensor.data, timestampNs);
+    
+    if (changed == 0)
+        return;
+    
+    auto active = recognizer.getActive();
+    gamepadStates[gamepad].motionGestures = active;
+    
+    if (motionGestureCallback)
+    {
+        forEachButton(changed, [&](int gesture)
+        {
+            motionGestureCallback(static_cast<int>(gamepad), gesture, ((active >> gesture) & 1u) != 0);
+        });
+    }
+}
+
+void GamepadManager::releaseMotionGestures(size_t gamepad)
+{
+    auto active = motionGestures[gamepad].getActive();
+    motionGestures[gamepad].reset();
+    gamepadStates[gamepad].motionGestures = 0;
+    
+    if (motionGestureCallback)
+        forEachButton(active, [&](int gesture) { motionGestureCallback(static_cast<int>(gamepad), gesture, false); });
+}
+
+float GamepadManager::applyDeadzone(int axis, float value) noexcept
+{
+    // Triggers (4, 5) only go from 0 to 1; both kinds get a small deadzone
+    if (axis == 4 || axis == 5)
+        return value < 0.1f ? 0.0f : value;
+    
+    return std::abs(value) < 0.1f ? 0.0f : value;
+}
+
+juce::int64 GamepadManager::toHighResolutionTicks(Uint64 sdlTimestampNs) noexcept
+{
+    // Both clocks are monotonic: take the age on SDL's and subtract it from now on JUCE's
+    auto ageNs = static_cast<Sint64>(SDL_GetTicksNS() - sdlTimestampNs);
+    return juce::Time::getHighResolutionTicks() - juce::Time::secondsToHighResolutionTicks(static_cast<double>(ageNs) * 1.0e-9);
+}
+
+Uint64 GamepadManager::SensorClock::toEventTime(Uint64 sensorNs, Uint64 eventNs) noexcept
+{
+    // Not every backend has sensor timestamps
+    if (sensorNs == 0)
+        return eventNs;
+    
+    auto candidate = static_cast<Sint64>(eventNs - sensorNs);
+    
+    if (!valid || sensorNs < lastSensorNs)
+        offsetNs = candidate;  // First sample, or the controller's clock restarted
+    else
+        offsetNs = juce::jmin(candidate, offsetNs + static_cast<Sint64>(static_cast<double>(sensorNs - lastSensorNs) * sensorClockCreep));
+    
+    valid = true;
+    lastSensorNs = sensorNs;
+    
+    // The offset never exceeds this event's, so the result is never later than the event
+    return static_cast<Uint64>(static_cast<Sint64>(sensorNs) + offsetNs);
+}
+
+void GamepadManager::updateAxisMotion(size_t gamepad, int axis, float value, Uint64 timestampNs)
+{
+    auto& motions = axisMotion[gamepad];
+    auto& motion = motions[static_cast<size_t>(axis)];
+    auto deltaSeconds = static_cast<double>(timestampNs - motion.timestampNs) * 1.0e-9;
+    
+    // After a pause there is no slope to measure, and a new stroke begins
+    if (motion.timestampNs == 0 || timestampNs <= motion.timestampNs || deltaSeconds > strokeGapSeconds)
+    {
+        motion.speed = 0.0f;
+        motion.strokePeak = 0.0f;
+    }
+    else
+    {
+        // A short time constant hides single count jitter without smearing the onset
+        auto rawSpeed = static_cast<float>((value - motion.value) / deltaSeconds);
+        motion.speed += static_cast<float>(deltaSeconds / (deltaSeconds + speedTimeConstantSeconds)) * (rawSpeed - motion.speed);
+        
+        if (motion.speed * motion.strokePeak < 0.0f)
+            motion.strokePeak = 0.0f;
+        
+        if (std::abs(motion.speed) > std::abs(motion.strokePeak))
+            motion.strokePeak = motion.speed;
+    }
+    
+    motion.value = value;
+    motion.timestampNs = timestampNs;
+    
+    auto& speeds = gamepadStates[gamepad].axisSpeeds;
+    
+    // Triggers (4, 5) stand alone; stick axes come in X/Y pairs
+    if (axis >= 4)
+    {
+        speeds[static_cast<size_t>(axis)] = std::abs(motion.strokePeak);
+        return;
+    }
+    
+    auto recentPeak = [timestampNs](const AxisMotion& m)
+    {
+        return static_cast<double>(timestampNs - m.timestampNs) * 1.0e-9 <= strokeGapSeconds ? m.strokePeak : 0.0f;
+    };
+    
+    auto first = static_cast<size_t>(axis & ~1);
+    speeds[first] = speeds[first + 1] = std::hypot(recentPeak(motions[first]), recentPeak(motions[first + 1]));
+}
+
+PerformanceStats::SdlEvent GamepadManager::classifyEvent(Uint32 eventType)
+{
+    switch (eventType)
+    {
+        case SDL_EVENT_GAMEPAD_ADDED: return PerformanceStats::SdlEvent::GamepadAdded;
+        case SDL_EVENT_GAMEPAD_REMOVED: return PerformanceStats::SdlEvent::GamepadRemoved;
+        case SDL_EVENT_GAMEPAD_AXIS_MOTION: return PerformanceStats::SdlEvent::AxisMotion;
+        case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
+        case SDL_EVENT_GAMEPAD_BUTTON_UP: return PerformanceStats::SdlEvent::Button;
+        case SDL_EVENT_GAMEPAD_SENSOR_UPDATE: return PerformanceStats::SdlEvent::Sensor;
+        case SDL_EVENT_GAMEPAD_TOUCHPAD_DOWN:
+        case SDL_EVENT_GAMEPAD_TOUCHPAD_MOTION:
+        case SDL_EVENT_GAMEPAD_TOUCHPAD_UP: return PerformanceStats::SdlEvent::Touchpad;
+        default: return PerformanceStats::SdlEvent::Other;
+    }
 }
 
 const GamepadManager::GamepadState& GamepadManager::getGamepadState(int index) const
@@ -593,6 +761,32 @@ bool GamepadManager::isGamepadConnected(int index) const
     return false;
 }
 
+bool GamepadManager::setRumble(int index, float lowFrequency, float highFrequency, int durationMs)
+{
+    if (!isGamepadConnected(index) || sdlGamepads[static_cast<size_t>(index)] == nullptr)
+        return false;
+    
+    auto toMotor = [](float strength) { return static_cast<Uint16>(juce::jlimit(0.0f, 1.0f, strength) * 0xffff); };
+    return SDL_RumbleGamepad(sdlGamepads[static_cast<size_t>(index)], toMotor(lowFrequency), toMotor(highFrequency),
+                             static_cast<Uint32>(juce::jmax(0, durationMs)));
+}
+
+bool GamepadManager::setLed(int index, std::uint8_t red, std::uint8_t green, std::uint8_t blue)
+{
+    if (!isGamepadConnected(index) || sdlGamepads[static_cast<size_t>(index)] == nullptr)
+        return false;
+    
+    return SDL_SetGamepadLED(sdlGamepads[static_cast<size_t>(index)], red, green, blue);
+}
+
+void GamepadManager::notifyStateChanged()
+{
+    stateGeneration.fetch_add(1, std::memory_order_release);
+    
+    for (auto& callback : stateChangeCallbacks)
+        callback();
+}
+
 void GamepadManager::addStateChangeCallback(StateChangeCallback callback)
 {
     stateChangeCallbacks.push_back(std::move(callback));
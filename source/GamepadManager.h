@@ -4,7 +4,12 @@
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_sensor.h>
 #include <SDL3/SDL_joystick.h>
+#include "PerformanceStats.h"
+#include "MotionGestureRecognizer.h"
 #include <functional>
+#include <atomic>
+#include <bit>
+#include <cstdint>
 #include <array>
 #include <vector>
 #include <memory>
@@ -26,12 +31,38 @@ public:
     // Maximum number of buttons we'll track per gamepad
     static constexpr int MAX_BUTTONS = 15;
     
+    // Maximum number of simultaneous touchpad fingers we'll track
+    static constexpr int MAX_TOUCHPAD_FINGERS = 4;
+    
+    // Bit n is set while button n is held
+    using ButtonMask = std::uint32_t;
+    static_assert(MAX_BUTTONS <= 32, "Buttons must fit the mask");
+    
+    // Calls function(button) for every set bit, lowest button first
+    template <typename Function>
+    static void forEachButton(ButtonMask mask, Function&& function)
+    {
+        for (; mask != 0; mask &= mask - 1)
+            function(std::countr_zero(mask));
+    }
+    
     struct GamepadState
     {
         bool connected = false;
         SDL_JoystickID deviceId = 0;  // Using 0 as sentinel value for uninitialized device
         std::array<float, MAX_AXES> axes = {0};       // Values from -1.0 to 1.0
-        std::array<bool, MAX_BUTTONS> buttons = {false};
+        
+        // High resolution ticks (juce::Time) when each axis value was sampled
+        std::array<juce::int64, MAX_AXES> axisTimestamps = {};
+        
+        // Peak speed of each axis's current stroke in full scale per second,
+        // measured from the timestamp of every SDL axis event. Both axes of a
+        // stick report the speed of the stick as a whole.
+        std::array<float, MAX_AXES> axisSpeeds = {0};
+        ButtonMask buttons = 0;
+        
+        // High resolution ticks of the SDL event behind each button's last change
+        std::array<juce::int64, MAX_BUTTONS> buttonTimestamps = {};
         juce::String name;
         
         // Touchpad support
@@ -41,6 +72,17 @@ public:
             float x = 0.0f; // Normalized position (0.0 to 1.0)
             float y = 0.0f; // Normalized position (0.0 to 1.0)
             float pressure = 0.0f; // 0.0 to 1.0
+            juce::int64 timestamp = 0; // High resolution ticks of the last touchpad event
+            
+            // Every finger SDL reports; the fields above mirror the first finger that is down
+            struct Finger {
+                bool down = false;
+                float x = 0.0f;
+                float y = 0.0f;
+                float pressure = 0.0f;
+            };
+            std::array<Finger, MAX_TOUCHPAD_FINGERS> fingers;
+            int numFingers = 0;  // As reported by SDL for this controller
         };
         TouchpadState touchpad;
 
@@ -50,6 +92,7 @@ public:
             float x = 0.0f; // Rotation rate around X axis in radians/second
             float y = 0.0f; // Rotation rate around Y axis in radians/second
             float z = 0.0f; // Rotation rate around Z axis in radians/second
+            juce::int64 timestamp = 0; // High resolution ticks when the sample was taken
         };
         GyroscopeState gyroscope;
 
@@ -59,8 +102,14 @@ public:
             float x = 0.0f; // Acceleration along X axis in meters/second²
             float y = 0.0f; // Acceleration along Y axis in meters/second²
             float z = 0.0f; // Acceleration along Z axis in meters/second²
+            juce::int64 timestamp = 0; // High resolution ticks when the sample was taken
         };
         AccelerometerState accelerometer;
+        
+        // Motion gestures currently on, bit n for MotionGesture n
+        MotionGestureRecognizer::GestureMask motionGestures = 0;
+        
+        bool isButtonDown(int button) const noexcept { return ((buttons >> button) & 1u) != 0; }
     };
     
     GamepadManager();
@@ -75,13 +124,34 @@ public:
     // Check if gamepad at index is connected
     bool isGamepadConnected(int index) const;
     
+    // Haptics and lightbar of a connected gamepad (message thread). Motor
+    // strengths are 0..1 and the rumble stops by itself after the duration.
+    // Each call is one output report to the controller, so callers limit the rate.
+    // Returns false if the gamepad is missing or lacks the feature.
+    bool setRumble(int index, float lowFrequency, float highFrequency, int durationMs);
+    bool setLed(int index, std::uint8_t red, std::uint8_t green, std::uint8_t blue);
+    
     // Add a listener to be notified when gamepad state changes
     using StateChangeCallback = std::function<void()>;
     void addStateChangeCallback(StateChangeCallback callback);
     
+    // Called for every motion gesture that turns on or off, straight from the
+    // sensor events so a gesture shorter than a poll is not missed (message thread)
+    using MotionGestureCallback = std::function<void(int gamepad, int gesture, bool active)>;
+    void setMotionGestureCallback(MotionGestureCallback callback) { motionGestureCallback = std::move(callback); }
+    
     // Manually poll for gamepad state updates
     void updateGamepadStates();
     
+    // Incremented every time any gamepad state changes, so consumers can
+    // cheaply tell whether there is anything new to show
+    std::uint32_t getStateGeneration() const noexcept { return stateGeneration.load(std::memory_order_acquire); }
+    
+    // Smallest change of an axis or motion sensor that is stored and notified.
+    // The default hides jitter; 0 passes every sample through for filtering downstream.
+    void setSampleThreshold(float threshold) noexcept { sampleThreshold = juce::jmax(0.0f, threshold); }
+    float getSampleThreshold() const noexcept { return sampleThreshold; }
+    
 private:
     // Initialize SDL and gamepad subsystem
     bool initSDL();
@@ -95,6 +165,56 @@ private:
     // Handle SDL events
     void handleSDLEvents();
     
+    // Map an SDL event type onto the category we count in PerformanceStats
+    static PerformanceStats::SdlEvent classifyEvent(Uint32 eventType);
+    
+    // Bump the state generation and run the state change callbacks
+    void notifyStateChanged();
+    
+    // Derivative estimate of one axis, fed by every SDL axis event
+    struct AxisMotion
+    {
+        float value = 0.0f;
+        Uint64 timestampNs = 0;
+        float speed = 0.0f;         // Smoothed, signed
+        float strokePeak = 0.0f;    // Fastest speed since the axis last paused or turned round
+    };
+    
+    void updateAxisMotion(size_t gamepad, int axis, float value, Uint64 timestampNs);
+    std::array<std::array<AxisMotion, MAX_AXES>, MAX_GAMEPADS> axisMotion;
+    
+    // Normalised axis value with the small deadzone applied
+    static float applyDeadzone(int axis, float value) noexcept;
+    
+    // SDL event time (nanoseconds on SDL's clock) as juce::Time high resolution ticks
+    static juce::int64 toHighResolutionTicks(Uint64 sdlTimestampNs) noexcept;
+    
+    // Maps a controller's sensor clock onto SDL's event clock. SDL stamps an
+    // event when it reads the report, so reports read in one poll arrive
+    // microseconds apart; the sensor timestamps keep their real spacing. The
+    // offset is the smallest seen, since no sample arrives before it was
+    // taken, and may creep up slowly so the two clocks cannot drift apart.
+    struct SensorClock
+    {
+        bool valid = false;
+        Uint64 lastSensorNs = 0;
+        Sint64 offsetNs = 0;
+        
+        Uint64 toEventTime(Uint64 sensorNs, Uint64 eventNs) noexcept;
+    };
+    
+    std::array<std::array<SensorClock, 2>, MAX_GAMEPADS> sensorClocks;  // Gyro, accelerometer
+    static constexpr double sensorClockCreep = 0.001;   // Offset increase allowed per sensor nanosecond
+    
+    // Feed one raw sensor sample to the pad's recogniser and report what changed
+    void updateMotionGestures(size_t gamepad, const SDL_GamepadSensorEvent& sensor);
+    void releaseMotionGestures(size_t gamepad);
+    std::array<MotionGestureRecognizer, MAX_GAMEPADS> motionGestures;
+    MotionGestureCallback motionGestureCallback;
+    
+    static constexpr double strokeGapSeconds = 0.05;
+    static constexpr double speedTimeConstantSeconds = 0.002;
+    
     // Array of gamepad states for all potential gamepads
     std::array<GamepadState, MAX_GAMEPADS> gamepadStates;
     
@@ -106,4 +226,8 @@ private:
     
     // Vector of callbacks to notify when gamepad state changes
     std::vector<StateChangeCallback> stateChangeCallbacks;
+    
+    std::atomic<std::uint32_t> stateGeneration { 0 };
+    
+    float sampleThreshold = 0.01f;
 }; 
\ No newline at end of file
@@ -0,0 +1,279 @@
+#include "MappingBinaryFormat.h"
+#include "MappingPersistence.h"
+#include "MappingSerializer.h"
+#include <bit>
+#include <cstring>
+
+namespace
+{
+    constexpr char magic[4] = { 'G', 'P', 'M', 'B' };
+
+    std::uint32_t fnv1a(const void* data, size_t size) noexcept
+    {
+        auto* bytes = static_cast<const std::uint8_t*>(data);
+        std::uint32_t hash = 2166136261u;
+
+        for (size_t i = 0; i < size; ++i)
+            hash = (hash ^ bytes[i]) * 16777619u;
+
+        return hash;
+    }
+
+    template <size_t N>
+    void encodeGroup(const std::array<std::vector<MidiMapping>, N>& group,
+                     std::vector<MappingBinaryFormat::Slot>& slots,
+                     std::vector<MappingBinaryFormat::Record>& records)
+    {
+        for (const auto& mappings : group)
+        {
+            slots.push_back({ static_cast<std::uint32_t>(records.size()),
+                              static_cast<std::uint32_t>(mappings.size()) });
+
+            for (const auto& mapping : mappings)
+            {
+                MappingBinaryFormat::Record record {};
+                record.type = static_cast<std::uint8_t>(mapping.type);
+                record.channel = static_cast<std::uint8_t>(juce::jlimit(1, 16, mapping.channel));
+                record.ccNumber = static_cast<std::uint8_t>(juce::jlimit(0, 127, mapping.ccNumber));
+                record.noteNumber = static_cast<std::uint8_t>(juce::jlimit(0, 127, mapping.noteNumber));
+                record.isButton = mapping.isButton ? 1 : 0;
+                record.smoothing = static_cast<std::uint8_t>(mapping.smoothing);
+                record.aftertouch = mapping.aftertouch ? 1 : 0;
+                record.scale = static_cast<std::uint8_t>(mapping.scale);
+                record.scaleRange = static_cast<std::uint8_t>(juce::jlimit(0, 127, mapping.scaleRange));
+                record.minValue = mapping.minValue;
+                record.maxValue = mapping.maxValue;
+                record.smoothingFrequency = mapping.smoothingFrequency;
+                record.smoothingBeta = mapping.smoothingBeta;
+                record.gateThreshold = mapping.gateThreshold;
+                record.gateHysteresis = mapping.gateHysteresis;
+                record.velocitySpeed = mapping.velocitySpeed;
+                records.push_back(record);
+            }
+        }
+    }
+
+    template <size_t N>
+    void decodeGroup(const MappingBinaryView& view, int slotBase, std::array<std::vector<MidiMapping>, N>& group)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            auto records = view.getMappings(slotBase + static_cast<int>(i));
+            group[i].clear();
+            group[i].reserve(records.size());
+
+            for (const auto& record : records)
+                group[i].push_back(MappingBinaryFormat::toMapping(record));
+        }
+    }
+}
+
+namespace MappingBinaryFormat
+{
+    int getSlot(const juce::String& controlType, int controlIndex) noexcept
+    {
+        struct Group
+        {
+            const char* name;
+            int base;
+            int count;
+        };
+
+        static constexpr Group groups[] {
+            { "Axis", axisSlotBase, buttonSlotBase - axisSlotBase },
+            { "Button", buttonSlotBase, gyroSlotBase - buttonSlotBase },
+            { "Gyro", gyroSlotBase, accelerometerSlotBase - gyroSlotBase },
+            { "Accel", accelerometerSlotBase, touchpadSlotBase - accelerometerSlotBase },
+            { "Touchpad", touchpadSlotBase, motionSlotBase - touchpadSlotBase },
+            { "Motion", motionSlotBase, numSlots - motionSlotBase }
+        };
+
+        for (const auto& group : groups)
+            if (controlType == group.name)
+                return juce::isPositiveAndBelow(controlIndex, group.count) ? group.base + controlIndex : -1;
+
+        return -1;
+    }
+
+    MidiMapping toMapping(const Record& record) noexcept
+    {
+        MidiMapping mapping;
+        mapping.type = record.type == static_cast<std::uint8_t>(MidiMapping::Type::Note)
+                           ? MidiMapping::Type::Note
+                           : MidiMapping::Type::ControlChange;
+        mapping.channel = record.channel;
+        mapping.ccNumber = record.ccNumber;
+        mapping.noteNumber = record.noteNumber;
+        mapping.minValue = record.minValue;
+        mapping.maxValue = record.maxValue;
+        mapping.isButton = record.isButton != 0;
+        mapping.smoothing = record.smoothing <= static_cast<std::uint8_t>(MidiMapping::Smoothing::Slew)
+                                ? static_cast<MidiMapping::Smoothing>(record.smoothing)
+                                : MidiMapping::Smoothing::None;
+        mapping.smoothingFrequency = record.smoothingFrequency;
+        mapping.smoothingBeta = record.smoothingBeta;
+        mapping.gateThreshold = record.gateThreshold;
+        mapping.gateHysteresis = record.gateHysteresis;
+        mapping.velocitySpeed = record.velocitySpeed;
+        mapping.aftertouch = record.aftertouch != 0;
+        mapping.scale = record.scale <= static_cast<std::uint8_t>(MidiMapping::Scale::Blues)
+                            ? static_cast<MidiMapping::Scale>(record.scale)
+                            : MidiMapping::Scale::None;
+        mapping.scaleRange = record.scaleRange;
+        return mapping;
+    }
+
+    juce::MemoryBlock encode(const MidiMappingSet& mappings)
+    {
+        std::vector<Slot> slots;
+        std::vector<Record> records;
+        slots.reserve(numSlots);
+
+        encodeGroup(mappings.axisMappings, slots, records);
+        encodeGroup(mappings.buttonMappings, slots, records);
+        encodeGroup(mappings.gyroMappings, slots, records);
+        encodeGroup(mappings.accelerometerMappings, slots, records);
+        encodeGroup(mappings.touchpadMappings, slots, records);
+        encodeGroup(mappings.motionMappings, slots, records);
+        jassert(slots.size() == numSlots);
+
+        auto slotBytes = slots.size() * sizeof(Slot);
+        auto recordBytes = records.size() * sizeof(Record);
+
+        juce::MemoryBlock block(sizeof(Header) + slotBytes + recordBytes, true);
+        auto* bytes = static_cast<char*>(block.getData());
+
+        std::memcpy(bytes + sizeof(Header), slots.data(), slotBytes);
+        if (recordBytes > 0)
+            std::memcpy(bytes + sizeof(Header) + slotBytes, records.data(), recordBytes);
+
+        Header header {};
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.version = static_cast<std::uint16_t>(currentVersion);
+        header.slotCount = static_cast<std::uint16_t>(slots.size());
+        header.recordCount = static_cast<std::uint32_t>(records.size());
+        header.checksum = fnv1a(bytes + sizeof(Header), slotBytes + recordBytes);
+        std::memcpy(bytes, &header, sizeof(Header));
+
+        return block;
+    }
+
+    bool writeFile(const MidiMappingSet& mappings, const juce::File& file)
+    {
+        return MappingPersistence::writeAtomically(file, encode(mappings));
+    }
+
+    juce::File getCacheFileFor(const juce::File& jsonFile)
+    {
+        return jsonFile.withFileExtension("bin");
+    }
+
+    bool convertJsonToBinary(const juce::File& jsonFile, const juce::File& binaryFile)
+    {
+        auto mappings = MappingSerializer::readFile(jsonFile);
+        if (!mappings)
+        {
+            juce::Logger::writeToLog("Not a valid mappings file: " + jsonFile.getFullPathName());
+            return false;
+        }
+
+        return writeFile(*mappings, binaryFile);
+    }
+
+    bool convertBinaryToJson(const juce::File& binaryFile, const juce::File& jsonFile)
+    {
+        MappingBinaryView view(binaryFile);
+        if (!view.isValid())
+        {
+            juce::Logger::writeToLog("Not a valid binary mappings file: " + binaryFile.getFullPathName());
+            return false;
+        }
+
+        return MappingPersistence::writeMappings(jsonFile, view.toMappingSet());
+    }
+}
+
+MappingBinaryView::MappingBinaryView(const juce::File& file)
+{
+    if (!file.existsAsFile())
+        return;
+
+    mappedFile = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+    validate(mappedFile->getData(), mappedFile->getSize());
+
+    if (!isValid())
+        mappedFile.reset();
+}
+
+MappingBinaryView::MappingBinaryView(const void* data, size_t size)
+{
+    validate(data, size);
+}
+
+void MappingBinaryView::validate(const void* data, size_t size) noexcept
+{
+    using namespace MappingBinaryFormat;
+
+    // Records are read in place, so the host must match the on-disk byte order
+    if constexpr (std::endian::native != std::endian::little)
+        return;
+
+    if (data == nullptr || size < sizeof(Header)
+        || reinterpret_cast<std::uintptr_t>(data) % alignof(Record) != 0)
+        return;
+
+    auto* candidate = static_cast<const Header*>(data);
+
+    if (std::memcmp(candidate->magic, magic, sizeof(magic)) != 0
+        || candidate->version != currentVersion
+        || candidate->slotCount != numSlots)
+        return;
+
+    auto slotBytes = static_cast<size_t>(candidate->slotCount) * sizeof(Slot);
+    auto recordBytes = static_cast<size_t>(candidate->recordCount) * sizeof(Record);
+
+    if (size != sizeof(Header) + slotBytes + recordBytes)
+        return;
+
+    auto* bytes = static_cast<const char*>(data);
+    if (fnv1a(bytes + sizeof(Header), slotBytes + recordBytes) != candidate->checksum)
+        return;
+
+    auto* candidateSlots = reinterpret_cast<const Slot*>(bytes + sizeof(Header));
+
+    // A valid checksum does not guarantee sane ranges (e.g. a hand-crafted file)
+    for (std::uint32_t i = 0; i < candidate->slotCount; ++i)
+    {
+        const auto& slot = candidateSlots[i];
+        if (slot.firstRecord > candidate->recordCount
+            || slot.numRecords > candidate->recordCount - slot.firstRecord)
+            return;
+    }
+
+    header = candidate;
+    slots = candidateSlots;
+    records = reinterpret_cast<const Record*>(bytes + sizeof(Header) + slotBytes);
+}
+
+std::span<const MappingBinaryView::Record> MappingBinaryView::getMappings(int slot) const noexcept
+{
+    if (!isValid() || slot < 0 || slot >= static_cast<int>(header->slotCount))
+        return {};
+
+    const auto& entry = slots[slot];
+    return { records + entry.firstRecord, entry.numRecords };
+}
+
+MidiMappingSet MappingBinaryView::toMappingSet() const
+{
+    using namespace MappingBinaryFormat;
+
+    MidiMappingSet mappings;
+    decodeGroup(*this, axisSlotBase, mappings.axisMappings);
+    decodeGroup(*this, buttonSlotBase, mappings.buttonMappings);
+    decodeGroup(*this, gyroSlotBase, mappings.gyroMappings);
+    decodeGroup(*this, accelerometerSlotBase, mappings.accelerometerMappings);
+    decodeGroup(*this, touchpadSlotBase, mappings.touchpadMappings);
+    decodeGroup(*this, motionSlotBase, mappings.motionMappings);
+    return mappings;
+}
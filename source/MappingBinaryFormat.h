@@ -0,0 +1,138 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include "MidiMapping.h"
+
+/**
+ * Compact binary form of a MidiMappingSet.
+ *
+ * Layout (little endian, every section 4-byte aligned):
+ *   Header                      magic, version, slot and record counts, checksum
+ *   Slot[slotCount]             first record and count for each control
+ *   Record[recordCount]         fixed size mappings, grouped by slot
+ *
+ * Slots are laid out axes, buttons, gyro, accelerometer, touchpad, motion gestures, so the mappings of any
+ * control are a single contiguous span that can be read straight out of a
+ * memory-mapped file without parsing. JSON stays the interchange format; this
+ * is a load cache written next to it.
+ */
+namespace MappingBinaryFormat
+{
+    static constexpr std::uint32_t currentVersion = 7;  // 2: touchpad slots, 3: smoothing, 4: note gates, 5: speed velocity, 6: scales, 7: motion gestures
+
+    struct Header
+    {
+        char magic[4];              // "GPMB"
+        std::uint16_t version;
+        std::uint16_t slotCount;
+        std::uint32_t recordCount;
+        std::uint32_t checksum;     // FNV-1a over the slot and record sections
+    };
+
+    struct Slot
+    {
+        std::uint32_t firstRecord;
+        std::uint32_t numRecords;
+    };
+
+    struct Record
+    {
+        std::uint8_t type;
+        std::uint8_t channel;
+        std::uint8_t ccNumber;
+        std::uint8_t noteNumber;
+        std::uint8_t isButton;
+        std::uint8_t smoothing;
+        std::uint8_t aftertouch;
+        std::uint8_t scale;
+        float minValue;
+        float maxValue;
+        float smoothingFrequency;
+        float smoothingBeta;
+        float gateThreshold;
+        float gateHysteresis;
+        float velocitySpeed;
+        std::uint8_t scaleRange;
+        std::uint8_t reserved[3];
+    };
+
+    // Naturally aligned, so no packing is needed for the layout to match on disk
+    static_assert(sizeof(Header) == 16 && sizeof(Slot) == 8 && sizeof(Record) == 40);
+
+    // First slot of each control group
+    static constexpr int axisSlotBase = 0;
+    static constexpr int buttonSlotBase = axisSlotBase + GamepadManager::MAX_AXES;
+    static constexpr int gyroSlotBase = buttonSlotBase + GamepadManager::MAX_BUTTONS;
+    static constexpr int accelerometerSlotBase = gyroSlotBase + 3;
+    static constexpr int touchpadSlotBase = accelerometerSlotBase + 3;
+    static constexpr int motionSlotBase = touchpadSlotBase + TouchpadControl::count;
+    static constexpr int numSlots = motionSlotBase + MotionGesture::count;
+
+    // Buttons, motion gestures and the touchpad click send on press and release
+    // and have no smoothing, gate or scale; every other control is continuous
+    constexpr bool isButtonSlot(int slot) noexcept
+    {
+        return (slot >= buttonSlotBase && slot < gyroSlotBase)
+            || (slot >= motionSlotBase && slot < numSlots)
+            || slot == touchpadSlotBase + TouchpadControl::Button;
+    }
+
+    // Slot of a control by its "controlType" name in the JSON, -1 if there is no such control
+    int getSlot(const juce::String& controlType, int controlIndex) noexcept;
+
+    MidiMapping toMapping(const Record& record) noexcept;
+
+    // Serialise a mapping set to its binary form
+    juce::MemoryBlock encode(const MidiMappingSet& mappings);
+
+    // Write the binary form through a temporary file and rename
+    bool writeFile(const MidiMappingSet& mappings, const juce::File& file);
+
+    // The binary cache that lives next to a JSON mappings file
+    juce::File getCacheFileFor(const juce::File& jsonFile);
+
+    // Interchange converters
+    bool convertJsonToBinary(const juce::File& jsonFile, const juce::File& binaryFile);
+    bool convertBinaryToJson(const juce::File& binaryFile, const juce::File& jsonFile);
+}
+
+/**
+ * Read-only view over a binary mapping file or memory block.
+ * Nothing is copied: the header is validated (magic, version, bounds and
+ * checksum) once, after which lookups return spans into the mapped data.
+ */
+class MappingBinaryView
+{
+public:
+    using Record = MappingBinaryFormat::Record;
+
+    // Memory-maps the file; isValid() is false if it is missing, corrupt or from another version
+    explicit MappingBinaryView(const juce::File& file);
+
+    // View over memory owned by the caller, which must outlive the view
+    MappingBinaryView(const void* data, size_t size);
+
+    bool isValid() const noexcept { return header != nullptr; }
+
+    // All mappings of one control slot (see MappingBinaryFormat slot bases)
+    std::span<const Record> getMappings(int slot) const noexcept;
+
+    int getNumRecords() const noexcept { return isValid() ? static_cast<int>(header->recordCount) : 0; }
+
+    // Expand into the editable representation
+    MidiMappingSet toMappingSet() const;
+
+private:
+    void validate(const void* data, size_t size) noexcept;
+
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    const MappingBinaryFormat::Header* header = nullptr;
+    const MappingBinaryFormat::Slot* slots = nullptr;
+    const Record* records = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE(MappingBinaryView)
+};
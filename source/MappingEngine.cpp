@@ -0,0 +1,361 @@
+#include "MappingEngine.h"
+#include "MidiClock.h"
+#include "MidiOutputManager.h"
+#include "PerformanceStats.h"
+#include "TraceRecorder.h"
+
+namespace
+{
+    // Samples are timed when SDL took them and reach us up to a poll later, so
+    // a slot is only carried forward once its input has been quiet for longer
+    // than that; otherwise a late sample of the same batch would be in its past
+    constexpr double idleSeconds = 0.04;
+
+    double ticksToSeconds(juce::int64 ticks) noexcept
+    {
+        return juce::Time::highResolutionTicksToSeconds(ticks);
+    }
+}
+
+MappingEngine::MappingEngine() = default;
+
+MappingEngine::~MappingEngine()
+{
+    cancelPendingUpdate();
+}
+
+int MappingEngine::getSlot(InputEvent::Control control, int index) noexcept
+{
+    using namespace MappingBinaryFormat;
+
+    auto inRange = [index](int base, int count) { return juce::isPositiveAndBelow(index, count) ? base + index : -1; };
+
+    switch (control)
+    {
+        case InputEvent::Control::Axis:     return inRange(axisSlotBase, GamepadManager::MAX_AXES);
+        case InputEvent::Control::Button:   return inRange(buttonSlotBase, GamepadManager::MAX_BUTTONS);
+        case InputEvent::Control::Gyro:     return inRange(gyroSlotBase, 3);
+        case InputEvent::Control::Accel:    return inRange(accelerometerSlotBase, 3);
+        case InputEvent::Control::Touchpad: return inRange(touchpadSlotBase, TouchpadControl::count);
+        case InputEvent::Control::Motion:   return inRange(motionSlotBase, MotionGesture::count);
+    }
+
+    return -1;
+}
+
+void MappingEngine::compile(const MidiMappingSet& mappings)
+{
+    // Gates of the old table would never see their closing value
+    releaseAll();
+
+    using namespace MappingBinaryFormat;
+
+    SlotCounts counts {};
+    table.clear();
+
+    // Groups are added in slot order, so each control's mappings end up contiguous
+    auto appendGroup = [this, &counts](const auto& group, int slotBase)
+    {
+        for (size_t i = 0; i < group.size(); ++i)
+        {
+            counts[static_cast<size_t>(slotBase) + i] = static_cast<std::uint32_t>(group[i].size());
+
+            for (const auto& mapping : group[i])
+                appendCompiled(mapping);
+        }
+    };
+
+    appendGroup(mappings.axisMappings, axisSlotBase);
+    appendGroup(mappings.buttonMappings, buttonSlotBase);
+    appendGroup(mappings.gyroMappings, gyroSlotBase);
+    appendGroup(mappings.accelerometerMappings, accelerometerSlotBase);
+    appendGroup(mappings.touchpadMappings, touchpadSlotBase);
+    appendGroup(mappings.motionMappings, motionSlotBase);
+
+    buildSlots(counts);
+    compiledFromCache = false;
+}
+
+void MappingEngine::compile(const MappingBinaryView& view)
+{
+    using namespace MappingBinaryFormat;
+
+    releaseAll();
+
+    // The records are read where they are mapped, with no intermediate mapping set
+    SlotCounts counts {};
+    table.clear();
+    table.reserve(static_cast<size_t>(view.getNumRecords()));
+
+    for (int slot = 0; slot < numSlots; ++slot)
+    {
+        auto records = view.getMappings(slot);
+        counts[static_cast<size_t>(slot)] = static_cast<std::uint32_t>(records.size());
+
+        for (const auto& record : records)
+            appendCompiled(toMapping(record));
+    }
+
+    buildSlots(counts);
+    compiledFromCache = true;
+}
+
+void MappingEngine::appendCompiled(const MidiMapping& mapping)
+{
+    CompiledMapping compiled;
+    compiled.mapping = mapping;
+    compiled.filter.configure(mapping);
+    compiled.quantiser.configure(mapping);
+    table.push_back(compiled);
+}
+
+void MappingEngine::buildSlots(const SlotCounts& counts) noexcept
+{
+    std::uint32_t first = 0;
+    anyFiltered = false;
+
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        auto& slot = slots[i];
+        slot = {};
+        slot.first = first;
+        slot.count = counts[i];
+        slot.isButton = MappingBinaryFormat::isButtonSlot(static_cast<int>(i));
+        first += slot.count;
+
+        // Buttons are never smoothed, whatever the file says
+        for (auto m = slot.first; m < slot.first + slot.count && !slot.isButton; ++m)
+            slot.filtered = slot.filtered || table[m].filter.isEnabled();
+
+        anyFiltered = anyFiltered || slot.filtered;
+    }
+}
+
+bool MappingEngine::isFiltered(InputEvent::Control control, int index) const noexcept
+{
+    auto slot = getSlot(control, index);
+    return slot >= 0 && slots[static_cast<size_t>(slot)].filtered;
+}
+
+bool MappingEngine::post(const InputEvent& event)
+{
+    {
+        const juce::SpinLock::ScopedLockType lock(writeLock);
+        const auto scope = fifo.write(1);
+
+        if (scope.blockSize1 + scope.blockSize2 == 0)
+        {
+            PerformanceStats::getInstance().recordMidiDropped();
+            return false;
+        }
+
+        queue[static_cast<size_t>(scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)] = event;
+    }
+
+    PerformanceStats::getInstance().setQueueDepth(PerformanceStats::Queue::MappingEvents, fifo.getNumReady());
+
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        processPending();
+    else
+        triggerAsyncUpdate();
+
+    return true;
+}
+
+void MappingEngine::handleAsyncUpdate()
+{
+    processPending();
+}
+
+void MappingEngine::processPending()
+{
+    // An event posted while dispatching is picked up by the loop below
+    if (dispatching)
+        return;
+
+    GAMEPAD_TRACE_SCOPE("MappingEngine::processPending");
+    const juce::ScopedValueSetter<bool> setter(dispatching, true);
+
+    while (fifo.getNumReady() > 0)
+    {
+        InputEvent event;
+        {
+            const auto scope = fifo.read(1);
+            event = queue[static_cast<size_t>(scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)];
+        }
+
+        dispatch(event);
+    }
+}
+
+void MappingEngine::dispatch(const InputEvent& event)
+{
+    auto slotIndex = getSlot(event.control, event.index);
+    if (slotIndex < 0)
+        return;
+
+    auto& slot = slots[static_cast<size_t>(slotIndex)];
+
+    if (slot.isButton)
+    {
+        for (auto m = slot.first; m < slot.first + slot.count; ++m)
+            sendButton(table[m].mapping, event.value > 0.5f);
+    }
+    else
+    {
+        sendContinuous(slot, event.value, ticksToSeconds(event.timestamp), event.restart, event.speed);
+    }
+
+    auto& stats = PerformanceStats::getInstance();
+    stats.recordMappingEvaluations(static_cast<int>(slot.count));
+    stats.recordStageDuration(PerformanceStats::Stage::InputToDispatch,
+                              PerformanceStats::ticksToNanoseconds(juce::Time::getHighResolutionTicks() - event.timestamp));
+}
+
+void MappingEngine::sendContinuous(Slot& slot, float value, double timeSeconds, bool restart, float speed)
+{
+    // Time only moves forward for the filters, even if a stall let a carried-forward step overtake a sample
+    timeSeconds = juce::jmax(timeSeconds, slot.lastTime);
+    slot.lastValue = value;
+    slot.lastTime = timeSeconds;
+    slot.settling = false;
+
+    for (auto m = slot.first; m < slot.first + slot.count; ++m)
+    {
+        auto& compiled = table[m];
+        const auto& mapping = compiled.mapping;
+
+        if (restart)
+            compiled.filter.reset();
+
+        auto filtered = compiled.filter.process(juce::jlimit(0.0f, 1.0f, value), timeSeconds);
+        slot.settling = slot.settling || compiled.filter.isSettling();
+
+        float mappedValue = mapping.minValue + (filtered * (mapping.maxValue - mapping.minValue));
+
+        if (mapping.type == MidiMapping::Type::ControlChange)
+        {
+            MidiOutputManager::getInstance().sendControlChangeCoalesced(mapping.channel, mapping.ccNumber, static_cast<int>(mappedValue));
+            looper.capture(mapping.channel, mapping.ccNumber, static_cast<int>(mappedValue));
+        }
+        else
+            updateGate(compiled, filtered, mappedValue, speed);
+    }
+}
+
+void MappingEngine::updateGate(CompiledMapping& compiled, float value, float mappedValue, float speed)
+{
+    const auto& mapping = compiled.mapping;
+    auto& midiOutput = MidiOutputManager::getInstance();
+
+    // The quantiser follows every sample so its hysteresis is right when the gate opens
+    auto note = compiled.quantiser.isEnabled() ? compiled.quantiser.process(value) : mapping.noteNumber;
+
+    if (compiled.soundingNote < 0)
+    {
+        if (value <= mapping.gateThreshold)
+            return;
+
+        // Velocity is taken at the crossing; a zero velocity would read as note off
+        auto velocity = mappedValue;
+        if (mapping.velocitySpeed > 0.0f && speed >= 0.0f)
+            velocity = mapping.minValue + juce::jmin(1.0f, speed / mapping.velocitySpeed) * (mapping.maxValue - mapping.minValue);
+
+        compiled.velocity = juce::jlimit(1.0f, 127.0f, velocity) / 127.0f;
+        compiled.soundingNote = note;
+        compiled.lastAftertouch = -1;
+        midiOutput.sendNoteOn(mapping.channel, note, compiled.velocity);
+    }
+    else if (value < mapping.gateThreshold - juce::jmax(0.0f, mapping.gateHysteresis))
+    {
+        closeGate(compiled);
+        return;
+    }
+    else if (note != compiled.soundingNote)
+    {
+        // Moving to another degree of the scale: old note off, new one on at the opening velocity
+        midiOutput.sendNoteOn(mapping.channel, compiled.soundingNote, 0.0f);
+        compiled.soundingNote = note;
+        compiled.lastAftertouch = -1;
+        midiOutput.sendNoteOn(mapping.channel, note, compiled.velocity);
+    }
+
+    if (mapping.aftertouch)
+    {
+        auto pressure = juce::jlimit(0, 127, static_cast<int>(mappedValue));
+        if (pressure != compiled.lastAftertouch)
+        {
+            compiled.lastAftertouch = pressure;
+            midiOutput.sendAftertouch(mapping.channel, compiled.soundingNote, pressure);
+        }
+    }
+}
+
+void MappingEngine::closeGate(CompiledMapping& compiled)
+{
+    if (compiled.soundingNote < 0)
+        return;
+
+    MidiOutputManager::getInstance().sendNoteOn(compiled.mapping.channel, compiled.soundingNote, 0.0f);
+    compiled.soundingNote = -1;
+}
+
+void MappingEngine::releaseAll()
+{
+    for (auto& compiled : table)
+        closeGate(compiled);
+}
+
+void MappingEngine::releaseControl(InputEvent::Control control, int index)
+{
+    auto slotIndex = getSlot(control, index);
+    if (slotIndex < 0)
+        return;
+
+    const auto& slot = slots[static_cast<size_t>(slotIndex)];
+    for (auto m = slot.first; m < slot.first + slot.count; ++m)
+        closeGate(table[m]);
+}
+
+void MappingEngine::sendButton(const MidiMapping& mapping, bool pressed)
+{
+    auto& midiOutput = MidiOutputManager::getInstance();
+
+    if (mapping.type == MidiMapping::Type::ControlChange)
+    {
+        midiOutput.sendControlChange(mapping.channel, mapping.ccNumber, static_cast<int>(pressed ? mapping.maxValue : mapping.minValue));
+        return;
+    }
+
+    auto velocity = pressed ? mapping.maxValue / 127.0f : 0.0f;  // Zero velocity is note off
+    auto& clock = MidiClock::getInstance();
+    auto now = juce::Time::getMillisecondCounterHiRes();
+
+    // Both ends snap to the grid, and a tap shorter than a step still lasts one.
+    // A note off never overtakes its note on, even if quantising stopped in between.
+    auto time = clock.getNextGridTime(now);
+    if (!pressed)
+        time = juce::jmax(time, clock.getNextGridTime(midiOutput.getScheduledNoteOnTime(mapping.channel, mapping.noteNumber) + 1.0));
+
+    if (time > now)
+        midiOutput.sendNoteOnAt(mapping.channel, mapping.noteNumber, velocity, time);
+    else
+        midiOutput.sendNoteOn(mapping.channel, mapping.noteNumber, velocity);
+}
+
+bool MappingEngine::advanceFilters()
+{
+    auto now = ticksToSeconds(juce::Time::getHighResolutionTicks());
+    bool anySettling = false;
+
+    for (auto& slot : slots)
+    {
+        // Slots still receiving input are moved by their own samples
+        if (slot.settling && now - slot.lastTime >= idleSeconds)
+            sendContinuous(slot, slot.lastValue, now, false, -1.0f);
+
+        anySettling = anySettling || slot.settling;
+    }
+
+    return anySettling;
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <juce_events/juce_events.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "MidiMapping.h"
+#include "MappingBinaryFormat.h"
+#include "SmoothingFilter.h"
+#include "ScaleQuantiser.h"
+#include "CcLooper.h"
+
+/** One change of one control, from whichever source produced it. */
+struct InputEvent
+{
+    enum class Source : std::uint8_t
+    {
+        Hardware,
+        Gui         // Clicks and drags on the on-screen gamepad, e.g. in Teach mode
+    };
+
+    // Same groups as MidiMappingSet
+    enum class Control : std::uint8_t
+    {
+        Axis,
+        Button,
+        Gyro,
+        Accel,
+        Touchpad,
+        Motion      // Gestures, on or off like buttons
+    };
+
+    Source source = Source::Hardware;
+    Control control = Control::Axis;
+    std::uint8_t index = 0;
+    bool restart = false;       // Start filters at this value instead of gliding to it
+    float value = 0.0f;         // Normalised 0..1; buttons are 0 or 1
+    float speed = -1.0f;        // How fast the control is moving, in full range per second; negative if unknown
+    juce::int64 timestamp = 0;  // High resolution ticks when the input happened; SDL's sample time for hardware
+
+    static InputEvent make(Source source, Control control, int index, float value) noexcept
+    {
+        InputEvent event;
+        event.source = source;
+        event.control = control;
+        event.index = static_cast<std::uint8_t>(index);
+        event.value = value;
+        event.timestamp = juce::Time::getHighResolutionTicks();
+        return event;
+    }
+};
+
+/**
+ * The one place mappings turn input into MIDI.
+ *
+ * Every source posts InputEvents into a single queue, and every event is
+ * dispatched through a table compiled from the current MidiMappingSet: one
+ * flat array of mappings plus a slot per control pointing at its span. A
+ * slot lookup and a walk over that span is all the work per event, so the
+ * hardware and the on-screen gamepad share the same scaling, Note semantics,
+ * smoothing, CC coalescing and latency.
+ *
+ * Notes on continuous controls are gated: each mapping opens once when its
+ * value rises past the threshold, with the velocity of that moment, and
+ * closes once it falls back below the threshold minus the hysteresis. The
+ * velocity is either the value at the crossing or, where the source measures
+ * it, how fast the control was moving. Mappings with a scale also pick the
+ * pitch from the value and move between notes while the gate stays open.
+ */
+class MappingEngine : private juce::AsyncUpdater
+{
+public:
+    MappingEngine();
+    ~MappingEngine() override;
+
+    // Rebuild the dispatch table (message thread); smoothing restarts and held notes end
+    void compile(const MidiMappingSet& mappings);
+    
+    // Same, straight from the records of a valid binary cache
+    void compile(const MappingBinaryView& view);
+    
+    // True while the table is the one compiled from a binary cache
+    bool isCompiledFromCache() const noexcept { return compiledFromCache; }
+    
+    // End every note held by a gate, e.g. when the gamepad goes away
+    void releaseAll();
+    
+    // End the notes of one control whose value stops meaning anything, e.g.
+    // the touchpad position once the finger lifts (message thread)
+    void releaseControl(InputEvent::Control control, int index);
+
+    // Queue an event from any thread. On the message thread it is dispatched
+    // before returning, elsewhere on the next message loop pass. Returns false
+    // if the queue was full and the event was dropped.
+    bool post(const InputEvent& event);
+
+    // Dispatch everything queued (message thread)
+    void processPending();
+
+    // Feed smoothed mappings their last input again so they keep converging
+    // after it stops changing; returns true while any of them still is
+    bool advanceFilters();
+
+    // True if the control has a smoothed mapping, which wants every raw sample
+    bool isFiltered(InputEvent::Control control, int index) const noexcept;
+    bool hasFilters() const noexcept { return anyFiltered; }
+
+    // Slot of a control in the compiled table, -1 if there is no such control
+    static int getSlot(InputEvent::Control control, int index) noexcept;
+
+    // Records the CCs of continuous mappings into loops and plays them back
+    CcLooper& getLooper() noexcept { return looper; }
+
+private:
+    struct CompiledMapping
+    {
+        MidiMapping mapping;
+        SmoothingFilter filter;
+        
+        // Note gate of a continuous control, and the scale it plays with one
+        ScaleQuantiser quantiser;
+        int soundingNote = -1;      // -1 while the gate is closed
+        float velocity = 0.0f;
+        int lastAftertouch = -1;
+    };
+
+    struct Slot
+    {
+        std::uint32_t first = 0;
+        std::uint32_t count = 0;
+        bool isButton = false;
+        bool filtered = false;
+        bool settling = false;
+        float lastValue = 0.0f;
+        double lastTime = 0.0;
+    };
+
+    using SlotCounts = std::array<std::uint32_t, MappingBinaryFormat::numSlots>;
+
+    void appendCompiled(const MidiMapping& mapping);
+    void buildSlots(const SlotCounts& counts) noexcept;
+    void handleAsyncUpdate() override;
+    void dispatch(const InputEvent& event);
+    void sendContinuous(Slot& slot, float value, double timeSeconds, bool restart, float speed);
+    static void sendButton(const MidiMapping& mapping, bool pressed);
+    static void updateGate(CompiledMapping& compiled, float value, float mappedValue, float speed);
+    static void closeGate(CompiledMapping& compiled);
+
+    std::vector<CompiledMapping> table;
+    std::array<Slot, MappingBinaryFormat::numSlots> slots;
+    bool anyFiltered = false;
+    bool compiledFromCache = false;
+    bool dispatching = false;
+    CcLooper looper;
+
+    // AbstractFifo allows one writer at a time; the lock serialises the sources
+    static constexpr int queueSize = 1024;
+    juce::AbstractFifo fifo { queueSize };
+    std::array<InputEvent, queueSize> queue;
+    juce::SpinLock writeLock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MappingEngine)
+};
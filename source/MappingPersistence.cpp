@@ -0,0 +1,171 @@
+#include "MappingPersistence.h"
+#include "MappingBinaryFormat.h"
+#include "MappingEngine.h"
+#include "MappingSerializer.h"
+#include "TraceRecorder.h"
+
+namespace
+{
+    template <typename WriteFunction>
+    bool writeThroughTemporary(const juce::File& file, WriteFunction&& write)
+    {
+        juce::TemporaryFile tempFile(file);
+
+        {
+            juce::FileOutputStream stream(tempFile.getFile());
+            if (!stream.openedOk())
+            {
+                juce::Logger::writeToLog("Failed to open mappings file for writing: " + file.getFullPathName());
+                return false;
+            }
+
+            write(stream);
+            stream.flush();
+
+            if (stream.getStatus().failed())
+            {
+                juce::Logger::writeToLog("Failed to write mappings file: " + stream.getStatus().getErrorMessage());
+                return false;
+            }
+        }
+
+        if (!tempFile.overwriteTargetFileWithTemporary())
+        {
+            juce::Logger::writeToLog("Failed to replace mappings file: " + file.getFullPathName());
+            return false;
+        }
+
+        return true;
+    }
+}
+
+MappingPersistence::MappingPersistence(const juce::File& targetFile, int debounceMilliseconds)
+    : juce::Thread("Mapping persistence"),
+      file(targetFile),
+      debounceMs(debounceMilliseconds)
+{
+    startThread(juce::Thread::Priority::low);
+}
+
+MappingPersistence::~MappingPersistence()
+{
+    stopThread(2000);
+
+    // Anything still inside the debounce window must not be lost on quit
+    flush();
+}
+
+void MappingPersistence::scheduleSave(MidiMappingSet snapshot)
+{
+    {
+        const juce::ScopedLock sl(pendingLock);
+        pending = std::move(snapshot);
+        dueTime = juce::Time::getMillisecondCounter() + static_cast<juce::uint32>(debounceMs);
+    }
+
+    notify();
+}
+
+bool MappingPersistence::flush()
+{
+    return writePending();
+}
+
+bool MappingPersistence::hasPendingSave() const
+{
+    const juce::ScopedLock sl(pendingLock);
+    return pending.has_value();
+}
+
+void MappingPersistence::run()
+{
+    while (!threadShouldExit())
+    {
+        int waitMs = -1;
+
+        {
+            const juce::ScopedLock sl(pendingLock);
+            if (pending)
+                waitMs = juce::jmax(0, static_cast<int>(dueTime - juce::Time::getMillisecondCounter()));
+        }
+
+        if (waitMs == 0)
+            writePending();
+        else
+            wait(waitMs);
+    }
+}
+
+bool MappingPersistence::writePending()
+{
+    const juce::ScopedLock wl(writeLock);
+
+    std::optional<MidiMappingSet> snapshot;
+    {
+        const juce::ScopedLock sl(pendingLock);
+        snapshot.swap(pending);
+    }
+
+    if (!snapshot)
+        return true;
+
+    GAMEPAD_TRACE_SCOPE("MappingPersistence::write");
+    if (!writeMappings(file, *snapshot))
+        return false;
+
+    // Written after the JSON so the cache is never older than the file it mirrors
+    return MappingBinaryFormat::writeFile(*snapshot, MappingBinaryFormat::getCacheFileFor(file));
+}
+
+std::optional<MidiMappingSet> MappingPersistence::loadMappings(const juce::File& file, MappingEngine& engine)
+{
+    if (!file.existsAsFile())
+        return std::nullopt;
+
+    // The cache is only trusted while it is at least as new as the JSON, which may have been edited by hand
+    auto cacheFile = MappingBinaryFormat::getCacheFileFor(file);
+    if (cacheFile.getLastModificationTime() >= file.getLastModificationTime())
+    {
+        MappingBinaryView view(cacheFile);
+        if (view.isValid())
+        {
+            // The engine compiles from the mapped records; only the editable copy is expanded from them
+            engine.compile(view);
+            return view.toMappingSet();
+        }
+    }
+
+    auto mappings = MappingSerializer::readFile(file);
+    if (!mappings)
+        return std::nullopt;
+
+    engine.compile(*mappings);
+
+    // Refresh the cache so the next start skips the JSON parse
+    MappingBinaryFormat::writeFile(*mappings, cacheFile);
+    return mappings;
+}
+
+bool MappingPersistence::writeMappings(const juce::File& file, const MidiMappingSet& mappings, const juce::var& metadata)
+{
+    return writeThroughTemporary(file, [&](juce::OutputStream& stream)
+    {
+        MappingSerializer::write(stream, mappings, metadata);
+    });
+}
+
+bool MappingPersistence::writeAtomically(const juce::File& file, const juce::String& content)
+{
+    return writeThroughTemporary(file, [&](juce::OutputStream& stream)
+    {
+        stream.writeText(content, false, false, nullptr);
+    });
+}
+
+bool MappingPersistence::writeAtomically(const juce::File& file, const juce::MemoryBlock& content)
+{
+    return writeThroughTemporary(file, [&](juce::OutputStream& stream)
+    {
+        stream.write(content.getData(), content.getSize());
+    });
+}
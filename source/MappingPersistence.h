@@ -0,0 +1,58 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <optional>
+#include "MidiMapping.h"
+
+class MappingEngine;
+
+/**
+ * Writes the mapping set to disk on a background thread.
+ * Each edit hands over a snapshot; a burst of edits inside the debounce window
+ * collapses into a single write of the newest snapshot. Files are written to a
+ * temporary sibling and renamed over the target, so a crash mid-write never
+ * leaves a truncated mappings file behind.
+ */
+class MappingPersistence : private juce::Thread
+{
+public:
+    explicit MappingPersistence(const juce::File& targetFile, int debounceMilliseconds = 500);
+    ~MappingPersistence() override;
+
+    // Replace any pending snapshot and restart the debounce window (never blocks on disk)
+    void scheduleSave(MidiMappingSet snapshot);
+
+    // Write a pending snapshot immediately on the calling thread
+    bool flush();
+
+    bool hasPendingSave() const;
+
+    // Compile the saved mappings into the engine and return the editable copy.
+    // A binary cache at least as new as the JSON is compiled in place; otherwise
+    // the JSON is read and the cache refreshed. Nothing is returned, and the
+    // engine is left alone, if there are no readable mappings.
+    static std::optional<MidiMappingSet> loadMappings(const juce::File& file, MappingEngine& engine);
+
+    // Stream the mappings as JSON into a temporary file that replaces the target in one rename
+    static bool writeMappings(const juce::File& file, const MidiMappingSet& mappings, const juce::var& metadata = {});
+
+    // Write via a temporary file that replaces the target in one rename
+    static bool writeAtomically(const juce::File& file, const juce::String& content);
+    static bool writeAtomically(const juce::File& file, const juce::MemoryBlock& content);
+
+private:
+    void run() override;
+    bool writePending();
+
+    const juce::File file;
+    const int debounceMs;
+
+    juce::CriticalSection pendingLock;
+    std::optional<MidiMappingSet> pending;
+    juce::uint32 dueTime = 0;
+
+    // Keeps the background thread and flush() from writing out of order
+    juce::CriticalSection writeLock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MappingPersistence)
+};
@@ -0,0 +1,551 @@
+#include "MappingSerializer.h"
+#include <charconv>
+#include <cmath>
+#include <string_view>
+
+namespace
+{
+    //==============================================================================
+    // Writing
+
+    void writeText(juce::OutputStream& stream, std::string_view text)
+    {
+        stream.write(text.data(), text.size());
+    }
+
+    void writeValue(juce::OutputStream& stream, int value)
+    {
+        char buffer[16];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        stream.write(buffer, static_cast<size_t>(result.ptr - buffer));
+    }
+
+    void writeValue(juce::OutputStream& stream, float value)
+    {
+        if (!std::isfinite(value))
+            value = 0.0f;  // Not representable in JSON
+
+        // Ranges are almost always whole MIDI values, which need no float formatting
+        if (value == std::trunc(value) && std::abs(value) < 1.0e9f)
+            writeValue(stream, static_cast<int>(value));
+        else
+            stream << juce::String(value);
+    }
+
+    void writeValue(juce::OutputStream& stream, bool value)
+    {
+        writeText(stream, value ? "true" : "false");
+    }
+
+    void writeValue(juce::OutputStream& stream, MidiMapping::Type value)
+    {
+        writeValue(stream, static_cast<int>(value));
+    }
+
+    void writeValue(juce::OutputStream& stream, MidiMapping::Smoothing value)
+    {
+        writeValue(stream, static_cast<int>(value));
+    }
+
+    void writeValue(juce::OutputStream& stream, MidiMapping::Scale value)
+    {
+        writeValue(stream, static_cast<int>(value));
+    }
+
+    void writeKey(juce::OutputStream& stream, std::string_view key)
+    {
+        stream << '"';
+        writeText(stream, key);
+        writeText(stream, "\": ");
+    }
+
+    void writeMapping(juce::OutputStream& stream, const MidiMapping& mapping)
+    {
+        stream << '{';
+
+        bool first = true;
+        MappingSerializer::forEachField([&](const auto& field)
+        {
+            if (!first)
+                writeText(stream, ", ");
+            first = false;
+
+            writeKey(stream, field.name);
+            writeValue(stream, mapping.*(field.member));
+        });
+
+        stream << '}';
+    }
+
+    //==============================================================================
+    // Reading: a small pull parser over the raw text that understands just
+    // enough JSON to walk the schema and skip anything it does not know
+
+    class Reader
+    {
+    public:
+        Reader(const char* start, const char* finish)
+            : p(start), end(finish)
+        {
+            // UTF-8 byte order mark
+            if (end - p >= 3 && static_cast<unsigned char>(p[0]) == 0xef
+                && static_cast<unsigned char>(p[1]) == 0xbb && static_cast<unsigned char>(p[2]) == 0xbf)
+                p += 3;
+        }
+
+        std::optional<MidiMappingSet> readDocument()
+        {
+            MidiMappingSet mappings;
+            bool foundMappings = false;
+
+            bool ok = readObject([&](std::string_view key)
+            {
+                if (key != "mappings")
+                    return skipValue(0);
+
+                foundMappings = true;
+                return readArray([&] { return readControl(mappings); });
+            });
+
+            if (!ok || !foundMappings)
+                return std::nullopt;
+
+            return mappings;
+        }
+
+        // Properties before "mappings", each parsed on its own. The writer puts
+        // them first, so the mappings are never read; false if the text breaks
+        // or ends before they start.
+        bool readMetadata(juce::DynamicObject& metadata)
+        {
+            if (!expect('{'))
+                return false;
+
+            do
+            {
+                std::string_view key;
+                if (!readString(key) || !expect(':'))
+                    return false;
+
+                if (key == "mappings")
+                    return true;
+
+                skipWhitespace();
+                auto* start = p;
+                if (!skipValue(0))
+                    return false;
+
+                metadata.setProperty(juce::String::fromUTF8(key.data(), static_cast<int>(key.size())),
+                                     juce::JSON::fromString(juce::String::fromUTF8(start, static_cast<int>(p - start))));
+            }
+            while (expect(','));
+
+            return false;
+        }
+
+    private:
+        bool readControl(MidiMappingSet& set)
+        {
+            std::string_view controlType;
+            int controlIndex = -1;
+            std::vector<MidiMapping> mappings;
+
+            bool ok = readObject([&](std::string_view key)
+            {
+                if (key == "controlType")
+                    return readString(controlType);
+                if (key == "controlIndex")
+                    return readValue(controlIndex);
+                if (key == "mappings")
+                    return readArray([&] { return readMapping(mappings); });
+
+                return skipValue(0);
+            });
+
+            if (!ok)
+                return false;
+
+            // Unknown groups and out of range indices are ignored, as before
+            MappingSerializer::forEachControlGroup([&](const auto& group)
+            {
+                auto& controls = set.*(group.member);
+                if (controlType == group.name && juce::isPositiveAndBelow(controlIndex, static_cast<int>(controls.size())))
+                    controls[static_cast<size_t>(controlIndex)] = std::move(mappings);
+            });
+
+            return true;
+        }
+
+        bool readMapping(std::vector<MidiMapping>& mappings)
+        {
+            // Missing fields read as zero / ControlChange
+            MidiMapping mapping {};
+
+            bool ok = readObject([&](std::string_view key)
+            {
+                bool handled = false;
+                bool fieldOk = true;
+
+                MappingSerializer::forEachField([&](const auto& field)
+                {
+                    if (!handled && key == field.name)
+                    {
+                        handled = true;
+                        fieldOk = readValue(mapping.*(field.member));
+                    }
+                });
+
+                return handled ? fieldOk : skipValue(0);
+            });
+
+            if (ok)
+                mappings.push_back(mapping);
+
+            return ok;
+        }
+
+        bool readValue(int& value)
+        {
+            double number = 0.0;
+            if (!readNumber(number))
+                return false;
+
+            value = juce::roundToInt(number);
+            return true;
+        }
+
+        bool readValue(float& value)
+        {
+            double number = 0.0;
+            if (!readNumber(number))
+                return false;
+
+            value = static_cast<float>(number);
+            return true;
+        }
+
+        bool readValue(bool& value)
+        {
+            if (readLiteral("true"))
+                value = true;
+            else if (readLiteral("false"))
+                value = false;
+            else
+            {
+                // Numbers are accepted like juce::var did
+                double number = 0.0;
+                if (!readNumber(number))
+                    return false;
+
+                value = number != 0.0;
+            }
+
+            return true;
+        }
+
+        bool readValue(MidiMapping::Type& value)
+        {
+            int number = 0;
+            if (!readValue(number))
+                return false;
+
+            value = number == static_cast<int>(MidiMapping::Type::Note) ? MidiMapping::Type::Note
+                                                                         : MidiMapping::Type::ControlChange;
+            return true;
+        }
+
+        bool readValue(MidiMapping::Smoothing& value)
+        {
+            int number = 0;
+            if (!readValue(number))
+                return false;
+
+            // Filters this build does not know fall back to unfiltered
+            value = juce::isPositiveAndNotGreaterThan(number, static_cast<int>(MidiMapping::Smoothing::Slew))
+                        ? static_cast<MidiMapping::Smoothing>(number)
+                        : MidiMapping::Smoothing::None;
+            return true;
+        }
+
+        bool readValue(MidiMapping::Scale& value)
+        {
+            int number = 0;
+            if (!readValue(number))
+                return false;
+
+            // Scales this build does not know play the plain note
+            value = juce::isPositiveAndNotGreaterThan(number, static_cast<int>(MidiMapping::Scale::Blues))
+                        ? static_cast<MidiMapping::Scale>(number)
+                        : MidiMapping::Scale::None;
+            return true;
+        }
+
+        template <typename KeyHandler>
+        bool readObject(KeyHandler&& handleKey)
+        {
+            if (!expect('{'))
+                return false;
+            if (expect('}'))
+                return true;
+
+            do
+            {
+                std::string_view key;
+                if (!readString(key) || !expect(':') || !handleKey(key))
+                    return false;
+            }
+            while (expect(','));
+
+            return expect('}');
+        }
+
+        template <typename ItemHandler>
+        bool readArray(ItemHandler&& handleItem)
+        {
+            if (!expect('['))
+                return false;
+            if (expect(']'))
+                return true;
+
+            do
+            {
+                if (!handleItem())
+                    return false;
+            }
+            while (expect(','));
+
+            return expect(']');
+        }
+
+        // Returns the raw contents; none of the names we match contain escapes
+        bool readString(std::string_view& text)
+        {
+            if (!expect('"'))
+                return false;
+
+            auto* start = p;
+            while (p < end && *p != '"')
+            {
+                if (*p == '\\' && p + 1 < end)
+                    ++p;
+                ++p;
+            }
+
+            if (p >= end)
+                return false;
+
+            text = std::string_view(start, static_cast<size_t>(p - start));
+            ++p;
+            return true;
+        }
+
+        bool readNumber(double& value)
+        {
+            skipWhitespace();
+
+            // Copy the token so parsing never runs past the end of the input
+            char token[64];
+            size_t length = 0;
+            while (p < end && length < sizeof(token) - 1
+                   && (juce::CharacterFunctions::isDigit(*p) || *p == '-' || *p == '+' || *p == '.' || *p == 'e' || *p == 'E'))
+                token[length++] = *p++;
+
+            if (length == 0)
+                return false;
+
+            token[length] = 0;
+            juce::CharPointer_ASCII text(token);
+            value = juce::CharacterFunctions::readDoubleValue(text);
+            return true;
+        }
+
+        bool readLiteral(std::string_view literal)
+        {
+            skipWhitespace();
+            if (static_cast<size_t>(end - p) < literal.size() || std::string_view(p, literal.size()) != literal)
+                return false;
+
+            p += literal.size();
+            return true;
+        }
+
+        bool skipValue(int depth)
+        {
+            // Deeply nested unknown data is treated as malformed rather than recursed into
+            if (depth > 64)
+                return false;
+
+            skipWhitespace();
+            if (p >= end)
+                return false;
+
+            switch (*p)
+            {
+                case '"':
+                {
+                    std::string_view ignored;
+                    return readString(ignored);
+                }
+                case '{':
+                    return readObject([&](std::string_view) { return skipValue(depth + 1); });
+                case '[':
+                    return readArray([&] { return skipValue(depth + 1); });
+                case 't':
+                    return readLiteral("true");
+                case 'f':
+                    return readLiteral("false");
+                case 'n':
+                    return readLiteral("null");
+                default:
+                {
+                    double ignored;
+                    return readNumber(ignored);
+                }
+            }
+        }
+
+        bool expect(char c)
+        {
+            skipWhitespace();
+            if (p < end && *p == c)
+            {
+                ++p;
+                return true;
+            }
+
+            return false;
+        }
+
+        void skipWhitespace()
+        {
+            while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+                ++p;
+        }
+
+        const char* p;
+        const char* end;
+    };
+}
+
+namespace MappingSerializer
+{
+    void write(juce::OutputStream& stream, const MidiMappingSet& mappings,
+               const juce::var& metadata, ControlNamer namer)
+    {
+        writeText(stream, "{\n");
+
+        if (auto* metadataObj = metadata.getDynamicObject())
+        {
+            for (const auto& property : metadataObj->getProperties())
+            {
+                writeText(stream, "  ");
+                stream << juce::JSON::toString(property.name.toString(), true);
+                writeText(stream, ": ");
+                stream << juce::JSON::toString(property.value, true);
+                writeText(stream, ",\n");
+            }
+        }
+
+        writeText(stream, "  \"mappings\": [");
+
+        bool firstControl = true;
+        forEachControlGroup([&](const auto& group)
+        {
+            const auto& controls = mappings.*(group.member);
+
+            for (size_t i = 0; i < controls.size(); ++i)
+            {
+                if (controls[i].empty())
+                    continue;
+
+                writeText(stream, firstControl ? "\n    {\n" : ",\n    {\n");
+                firstControl = false;
+
+                writeText(stream, "      ");
+                writeKey(stream, "controlType");
+                stream << '"';
+                writeText(stream, group.name);
+                writeText(stream, "\",\n      ");
+                writeKey(stream, "controlIndex");
+                writeValue(stream, static_cast<int>(i));
+
+                if (namer != nullptr)
+                {
+                    writeText(stream, ",\n      ");
+                    writeKey(stream, "controlName");
+                    stream << juce::JSON::toString(namer(group.name, static_cast<int>(i)), true);
+                }
+
+                writeText(stream, ",\n      ");
+                writeKey(stream, "mappings");
+                writeText(stream, "[");
+
+                for (size_t m = 0; m < controls[i].size(); ++m)
+                {
+                    writeText(stream, m == 0 ? "\n        " : ",\n        ");
+                    writeMapping(stream, controls[i][m]);
+                }
+
+                writeText(stream, "\n      ]\n    }");
+            }
+        });
+
+        writeText(stream, firstControl ? "]\n}\n" : "\n  ]\n}\n");
+    }
+
+    juce::String toJson(const MidiMappingSet& mappings, const juce::var& metadata)
+    {
+        juce::MemoryOutputStream stream;
+        write(stream, mappings, metadata);
+        return stream.toUTF8();
+    }
+
+    std::optional<MidiMappingSet> read(const char* json, size_t size)
+    {
+        if (json == nullptr)
+            return std::nullopt;
+
+        return Reader(json, json + size).readDocument();
+    }
+
+    std::optional<MidiMappingSet> readFile(const juce::File& file)
+    {
+        juce::MemoryBlock data;
+        if (!file.existsAsFile() || !file.loadFileAsData(data))
+            return std::nullopt;
+
+        return read(static_cast<const char*>(data.getData()), data.getSize());
+    }
+
+    juce::var readMetadata(const char* json, size_t size)
+    {
+        if (json == nullptr)
+            return {};
+
+        juce::DynamicObject::Ptr metadata = new juce::DynamicObject();
+        if (!Reader(json, json + size).readMetadata(*metadata))
+            return {};
+
+        return juce::var(metadata);
+    }
+
+    juce::var readMetadataFile(const juce::File& file)
+    {
+        juce::FileInputStream stream(file);
+        if (!stream.openedOk())
+            return {};
+
+        // The metadata sits at the top, so the first few kilobytes nearly always hold all of it
+        juce::MemoryBlock data;
+        stream.readIntoMemoryBlock(data, 4096);
+        auto metadata = readMetadata(static_cast<const char*>(data.getData()), data.getSize());
+
+        if (metadata.isVoid() && !stream.isExhausted())
+        {
+            stream.readIntoMemoryBlock(data);
+            metadata = readMetadata(static_cast<const char*>(data.getData()), data.getSize());
+        }
+
+        return metadata;
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include "MidiMapping.h"
+
+/**
+ * The single description of how mappings are stored as JSON.
+ *
+ * The schema is two compile-time tables: the fields of MidiMapping and the
+ * control groups of MidiMappingSet. Writing streams straight to an
+ * OutputStream and reading walks the raw text, so neither direction builds a
+ * juce::var tree. Adding a field or a control group to the tables is all that
+ * is needed for it to be saved, exported and loaded.
+ */
+namespace MappingSerializer
+{
+    template <typename Value>
+    struct Field
+    {
+        const char* name;
+        Value MidiMapping::* member;
+    };
+
+    template <typename Group>
+    struct ControlGroup
+    {
+        const char* name;       // "controlType" in the file
+        Group MidiMappingSet::* member;
+    };
+
+    inline constexpr auto fields = std::make_tuple(
+        Field<MidiMapping::Type> { "type", &MidiMapping::type },
+        Field<int> { "channel", &MidiMapping::channel },
+        Field<int> { "ccNumber", &MidiMapping::ccNumber },
+        Field<int> { "noteNumber", &MidiMapping::noteNumber },
+        Field<float> { "minValue", &MidiMapping::minValue },
+        Field<float> { "maxValue", &MidiMapping::maxValue },
+        Field<bool> { "isButton", &MidiMapping::isButton },
+        Field<MidiMapping::Smoothing> { "smoothing", &MidiMapping::smoothing },
+        Field<float> { "smoothingFrequency", &MidiMapping::smoothingFrequency },
+        Field<float> { "smoothingBeta", &MidiMapping::smoothingBeta },
+        Field<float> { "gateThreshold", &MidiMapping::gateThreshold },
+        Field<float> { "gateHysteresis", &MidiMapping::gateHysteresis },
+        Field<bool> { "aftertouch", &MidiMapping::aftertouch },
+        Field<float> { "velocitySpeed", &MidiMapping::velocitySpeed },
+        Field<MidiMapping::Scale> { "scale", &MidiMapping::scale },
+        Field<int> { "scaleRange", &MidiMapping::scaleRange });
+
+    inline constexpr auto controlGroups = std::make_tuple(
+        ControlGroup<decltype(MidiMappingSet::axisMappings)> { "Axis", &MidiMappingSet::axisMappings },
+        ControlGroup<decltype(MidiMappingSet::buttonMappings)> { "Button", &MidiMappingSet::buttonMappings },
+        ControlGroup<decltype(MidiMappingSet::gyroMappings)> { "Gyro", &MidiMappingSet::gyroMappings },
+        ControlGroup<decltype(MidiMappingSet::accelerometerMappings)> { "Accel", &MidiMappingSet::accelerometerMappings },
+        ControlGroup<decltype(MidiMappingSet::touchpadMappings)> { "Touchpad", &MidiMappingSet::touchpadMappings },
+        ControlGroup<decltype(MidiMappingSet::motionMappings)> { "Motion", &MidiMappingSet::motionMappings });
+
+    template <typename Function>
+    constexpr void forEachField(Function&& function)
+    {
+        std::apply([&](const auto&... field) { (function(field), ...); }, fields);
+    }
+
+    template <typename Function>
+    constexpr void forEachControlGroup(Function&& function)
+    {
+        std::apply([&](const auto&... group) { (function(group), ...); }, controlGroups);
+    }
+
+    // Mappings of one control, looked up by its "controlType" name; nullptr if unknown
+    template <typename Set>
+    auto* findControl(Set& set, const juce::String& controlType, int controlIndex)
+    {
+        using Mappings = std::conditional_t<std::is_const_v<Set>, const std::vector<MidiMapping>, std::vector<MidiMapping>>;
+        Mappings* found = nullptr;
+
+        forEachControlGroup([&](const auto& group)
+        {
+            auto& controls = set.*(group.member);
+            if (controlType == group.name && juce::isPositiveAndBelow(controlIndex, static_cast<int>(controls.size())))
+                found = &controls[static_cast<size_t>(controlIndex)];
+        });
+
+        return found;
+    }
+
+    // Optional human readable "controlName" written with each control (ignored on load)
+    using ControlNamer = juce::String (*)(const juce::String& controlType, int controlIndex);
+
+    // Stream the mappings as JSON; properties of metadata are written before them
+    void write(juce::OutputStream& stream, const MidiMappingSet& mappings,
+               const juce::var& metadata = {}, ControlNamer namer = nullptr);
+
+    juce::String toJson(const MidiMappingSet& mappings, const juce::var& metadata = {});
+
+    // Nothing is returned if the text is malformed or has no mappings array
+    std::optional<MidiMappingSet> read(const char* json, size_t size);
+    std::optional<MidiMappingSet> readFile(const juce::File& file);
+
+    // The properties written before the mappings, without reading the mappings
+    // themselves; a void var if the text is malformed before the mappings start
+    juce::var readMetadata(const char* json, size_t size);
+    juce::var readMetadataFile(const juce::File& file);
+}
@@ -51,4 +51,7 @@ namespace MidiCC {
     constexpr int ACCEL_X = 29;
     constexpr int ACCEL_Y = 30;
     constexpr int ACCEL_Z = 31;
+
+    // Motion gestures (102-108), undefined CCs clear of the 32-63 LSB range
+    constexpr int MOTION_SHAKE = 102;
 } 
\ No newline at end of file
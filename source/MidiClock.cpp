@@ -0,0 +1,271 @@
+#include "MidiClock.h"
+#include "MidiOutputManager.h"
+#include <cmath>
+
+void MidiClock::TickGrid::setInterval(juce::int64 fromTick, double newInterval) noexcept
+{
+    // Re-anchoring on the tick keeps the times before it; accumulating per tick would drift
+    origin = getTickTime(fromTick);
+    originTick = fromTick;
+    interval = newInterval;
+}
+
+double MidiClock::TickGrid::getNextGridTime(double time, int gridTicks) const noexcept
+{
+    if (interval <= 0.0 || gridTicks <= 0)
+        return time;
+
+    // Small tolerance so a time exactly on a line is not pushed to the next one by rounding
+    auto tickPosition = static_cast<double>(originTick) + (time - origin) / interval;
+    auto line = std::ceil(tickPosition / gridTicks - 1.0e-9);
+    return origin + (line * gridTicks - static_cast<double>(originTick)) * interval;
+}
+
+MidiClock::MidiClock()
+{
+    setTempo(tempo);
+}
+
+MidiClock::~MidiClock()
+{
+    stopTimer();
+    closeInput();
+}
+
+void MidiClock::setSource(Source newSource)
+{
+    if (newSource == source)
+        return;
+
+    stop();
+    source = newSource;
+
+    if (source == Source::External)
+        openInput();
+    else
+        closeInput();
+}
+
+void MidiClock::setTempo(double beatsPerMinute)
+{
+    tempo = juce::jlimit(20.0, 300.0, beatsPerMinute);
+    auto interval = 60000.0 / (tempo * ticksPerQuarterNote);
+
+    // Ticks already handed to the output keep their times; the new tempo starts after them
+    grid.setInterval(nextTick, interval);
+}
+
+void MidiClock::setSendClock(bool shouldSend)
+{
+    sendClock = shouldSend;
+}
+
+void MidiClock::start()
+{
+    if (source != Source::Internal || running)
+        return;
+
+    // The first tick is a lookahead away, so it can be scheduled as precisely as the rest
+    grid.origin = juce::Time::getMillisecondCounterHiRes() + lookaheadMs;
+    grid.originTick = 0;
+    nextTick = 0;
+    running = true;
+
+    if (sendClock)
+        MidiOutputManager::getInstance().sendMessageAt(juce::MidiMessage::midiStart(), grid.origin);
+
+    timerCallback();
+    startTimer(timerIntervalMs);
+}
+
+void MidiClock::stop()
+{
+    if (!running)
+        return;
+
+    stopTimer();
+    running = false;
+
+    if (sendClock)
+        MidiOutputManager::getInstance().sendMessageAt(juce::MidiMessage::midiStop(), grid.getTickTime(nextTick));
+}
+
+bool MidiClock::isRunning() const noexcept
+{
+    if (source == Source::Internal)
+        return running;
+
+    const juce::SpinLock::ScopedLockType lock(externalLock);
+    return externalRunning && externalTicks - firstEstimateTick > 1;
+}
+
+void MidiClock::pendingMessagesCleared()
+{
+    if (!running)
+        return;
+
+    auto now = juce::Time::getMillisecondCounterHiRes();
+    while (nextTick > grid.originTick && grid.getTickTime(nextTick - 1) >= now)
+        --nextTick;
+
+    timerCallback();
+}
+
+void MidiClock::setQuantiseGrid(int ticks)
+{
+    quantiseGrid = juce::jlimit(0, ticksPerQuarterNote * 4, ticks);
+}
+
+double MidiClock::getNextGridTime(double millisecondCounter) const noexcept
+{
+    TickGrid current;
+    if (quantiseGrid <= 0 || !getCurrentGrid(current))
+        return millisecondCounter;
+
+    return current.getNextGridTime(millisecondCounter, quantiseGrid);
+}
+
+bool MidiClock::getTickPosition(double millisecondCounter, double& position) const noexcept
+{
+    TickGrid current;
+    if (!getCurrentGrid(current))
+        return false;
+
+    position = static_cast<double>(current.originTick) + (millisecondCounter - current.origin) / current.interval;
+    return true;
+}
+
+bool MidiClock::getCurrentGrid(TickGrid& current) const noexcept
+{
+    if (source == Source::Internal)
+    {
+        current = grid;
+        return running;
+    }
+
+    const juce::SpinLock::ScopedLockType lock(externalLock);
+    if (!externalRunning || externalTicks - firstEstimateTick < 2)
+        return false;
+
+    // Average over up to a beat of ticks; single intervals carry the sender's jitter
+    auto last = externalTicks - 1;
+    auto span = juce::jmin(last - firstEstimateTick, static_cast<juce::int64>(ticksPerQuarterNote));
+    auto lastTime = tickTimes[static_cast<size_t>(last % static_cast<juce::int64>(tickTimes.size()))];
+    auto firstTime = tickTimes[static_cast<size_t>((last - span) % static_cast<juce::int64>(tickTimes.size()))];
+
+    current.origin = lastTime;
+    current.originTick = last;
+    current.interval = (lastTime - firstTime) / static_cast<double>(span);
+    return current.interval > 0.0;
+}
+
+void MidiClock::timerCallback()
+{
+    auto horizon = juce::Time::getMillisecondCounterHiRes() + lookaheadMs;
+    auto& midiOutput = MidiOutputManager::getInstance();
+
+    for (; grid.getTickTime(nextTick) < horizon; ++nextTick)
+    {
+        if (sendClock)
+            midiOutput.sendMessageAt(juce::MidiMessage::midiClock(), grid.getTickTime(nextTick));
+    }
+}
+
+void MidiClock::handleIncomingMidiMessage(juce::MidiInput*, const juce::MidiMessage& message)
+{
+    // Timestamps are on the millisecond counter, in seconds
+    auto time = message.getTimeStamp() * 1000.0;
+
+    const juce::SpinLock::ScopedLockType lock(externalLock);
+
+    if (message.isMidiClock())
+    {
+        tickTimes[static_cast<size_t>(externalTicks % static_cast<juce::int64>(tickTimes.size()))] = time;
+        ++externalTicks;
+    }
+    else if (message.isMidiStart())
+    {
+        externalTicks = 0;
+        firstEstimateTick = 0;
+        externalRunning = true;
+    }
+    else if (message.isMidiContinue())
+    {
+        externalRunning = true;
+    }
+    else if (message.isMidiStop())
+    {
+        externalRunning = false;
+    }
+    else if (message.isSongPositionPointer())
+    {
+        // Counted in sixteenths, six ticks each; the interval estimate starts over
+        externalTicks = message.getSongPositionPointerMidiBeat() * (ticksPerQuarterNote / 4);
+        firstEstimateTick = externalTicks;
+    }
+}
+
+void MidiClock::openInput()
+{
+    // Same restriction as the virtual output
+    #if JUCE_WINDOWS
+        juce::Logger::writeToLog("External MIDI clock needs a virtual MIDI input, which is not available on Windows");
+    #else
+        input = juce::MidiInput::createNewDevice("Gamepad MIDI Clock", this);
+
+        if (input == nullptr)
+        {
+            juce::Logger::writeToLog("ERROR: Failed to create virtual MIDI clock input!");
+            return;
+        }
+
+        input->start();
+        juce::Logger::writeToLog("Following MIDI clock on: " + input->getName());
+    #endif
+}
+
+void MidiClock::closeInput()
+{
+    if (input != nullptr)
+    {
+        input->stop();
+        input.reset();
+    }
+
+    const juce::SpinLock::ScopedLockType lock(externalLock);
+    externalTicks = 0;
+    firstEstimateTick = 0;
+    externalRunning = false;
+}
+
+juce::var MidiClock::toVar() const
+{
+    juce::DynamicObject::Ptr obj = new juce::DynamicObject();
+    obj->setProperty("source", source == Source::External ? "external" : "internal");
+    obj->setProperty("tempo", tempo);
+    obj->setProperty("sendClock", sendClock);
+    obj->setProperty("running", running);
+    obj->setProperty("quantiseTicks", quantiseGrid);
+    return juce::var(obj);
+}
+
+bool MidiClock::fromVar(const juce::var& state)
+{
+    if (state.getDynamicObject() == nullptr)
+        return false;
+
+    auto sourceName = state.getProperty("source", "internal").toString();
+    if (sourceName != "internal" && sourceName != "external")
+        return false;
+
+    stop();
+    setTempo(state.getProperty("tempo", 120.0));
+    setSendClock(state.getProperty("sendClock", false));
+    setQuantiseGrid(state.getProperty("quantiseTicks", 0));
+    setSource(sourceName == "external" ? Source::External : Source::Internal);
+
+    if (source == Source::Internal && static_cast<bool>(state.getProperty("running", false)))
+        start();
+
+    return true;
+}
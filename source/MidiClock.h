@@ -0,0 +1,122 @@
+#pragma once
+
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include <array>
+
+/**
+ * Tempo clock for the MIDI output, and the grid mapped notes can snap to.
+ *
+ * The internal clock sends 24 ppqn timing messages. They are not sent when
+ * a timer happens to fire: every tick has an exact time on the millisecond
+ * counter, computed from the tempo rather than accumulated, and the timer
+ * hands the output the ticks due within the next few milliseconds with those
+ * times attached. Late callbacks cost lookahead, not accuracy.
+ *
+ * Alternatively the clock follows timing messages sent to its own virtual
+ * MIDI input by a DAW or another app, and only provides the grid.
+ */
+class MidiClock : private juce::Timer,
+                  private juce::MidiInputCallback
+{
+public:
+    static MidiClock& getInstance()
+    {
+        static MidiClock instance;
+        return instance;
+    }
+
+    static constexpr int ticksPerQuarterNote = 24;
+
+    enum class Source
+    {
+        Internal,
+        External    // Timing messages arriving at the "Gamepad MIDI Clock" input
+    };
+
+    /** Times of the ticks of a running clock; tempo changes keep earlier ticks in place. */
+    struct TickGrid
+    {
+        double origin = 0.0;            // Millisecond counter time of originTick
+        juce::int64 originTick = 0;
+        double interval = 0.0;          // Milliseconds per tick
+
+        double getTickTime(juce::int64 tick) const noexcept
+        {
+            return origin + static_cast<double>(tick - originTick) * interval;
+        }
+
+        // Change the interval from tick on
+        void setInterval(juce::int64 fromTick, double newInterval) noexcept;
+
+        // First multiple of gridTicks at or after the time
+        double getNextGridTime(double time, int gridTicks) const noexcept;
+    };
+
+    MidiClock();
+    ~MidiClock() override;
+
+    void setSource(Source newSource);
+    Source getSource() const noexcept { return source; }
+
+    // Internal clock (message thread)
+    void setTempo(double beatsPerMinute);
+    double getTempo() const noexcept { return tempo; }
+    void setSendClock(bool shouldSend);
+    bool isSendingClock() const noexcept { return sendClock; }
+    void start();
+    void stop();
+    bool isRunning() const noexcept;
+    
+    // The output changed and dropped its timed messages; the ticks that were among them are sent again
+    void pendingMessagesCleared();
+
+    // Notes from mappings start on multiples of this many ticks; 0 turns it off
+    void setQuantiseGrid(int ticks);
+    int getQuantiseGrid() const noexcept { return quantiseGrid; }
+    bool isQuantising() const noexcept { return quantiseGrid > 0 && isRunning(); }
+
+    // Millisecond counter time of the next grid line at or after the time,
+    // or the time itself while there is no grid
+    double getNextGridTime(double millisecondCounter) const noexcept;
+
+    // Ticks since the clock started at the time, fractional; false while it is not running
+    bool getTickPosition(double millisecondCounter, double& position) const noexcept;
+
+    // The ticks of the running clock, for scheduling on it; false while it is not running
+    bool getCurrentGrid(TickGrid& current) const noexcept;
+
+    // Persisted next to the mappings as JSON
+    juce::var toVar() const;
+    bool fromVar(const juce::var& state);
+
+private:
+    void timerCallback() override;
+    void handleIncomingMidiMessage(juce::MidiInput* input, const juce::MidiMessage& message) override;
+    void openInput();
+    void closeInput();
+
+    static constexpr double lookaheadMs = 20.0;
+    static constexpr int timerIntervalMs = 5;
+
+    Source source = Source::Internal;
+    double tempo = 120.0;
+    bool sendClock = false;
+    int quantiseGrid = 0;
+
+    // Internal clock
+    TickGrid grid;
+    juce::int64 nextTick = 0;   // First tick not handed to the output yet
+    bool running = false;
+
+    // External clock; written by the MIDI thread
+    std::unique_ptr<juce::MidiInput> input;
+    mutable juce::SpinLock externalLock;
+    std::array<double, ticksPerQuarterNote + 1> tickTimes {};   // The last beat of ticks, as a ring
+    juce::int64 externalTicks = 0;                              // Ticks since the last start
+    juce::int64 firstEstimateTick = 0;                          // Ring entries before this are stale
+    bool externalRunning = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiClock)
+};
@@ -0,0 +1,115 @@
+#include "MidiInputManager.h"
+#include "PerformanceStats.h"
+#include "TraceRecorder.h"
+
+MidiInputManager::MidiInputManager()
+{
+    createVirtualDevice();
+}
+
+MidiInputManager::~MidiInputManager()
+{
+    closeDevice();
+
+    if (virtualDevice != nullptr)
+        virtualDevice->stop();
+
+    cancelPendingUpdate();
+}
+
+bool MidiInputManager::createVirtualDevice()
+{
+    // Same restriction as the virtual output
+    #if JUCE_WINDOWS
+        juce::Logger::writeToLog("Virtual MIDI input creation skipped on Windows");
+        return false;
+    #else
+        virtualDevice = juce::MidiInput::createNewDevice("Gamepad MIDI Feedback", this);
+
+        if (virtualDevice != nullptr)
+        {
+            virtualDevice->start();
+            juce::Logger::writeToLog("Virtual MIDI input created: " + virtualDevice->getName());
+            return true;
+        }
+
+        juce::Logger::writeToLog("ERROR: Failed to create virtual MIDI input!");
+        return false;
+    #endif
+}
+
+bool MidiInputManager::openDevice(const juce::String& identifier)
+{
+    closeDevice();
+
+    device = juce::MidiInput::openDevice(identifier, this);
+    if (device == nullptr)
+    {
+        juce::Logger::writeToLog("Failed to open MIDI input: " + identifier);
+        return false;
+    }
+
+    deviceInfo = device->getDeviceInfo();
+    device->start();
+    juce::Logger::writeToLog("Opened MIDI input: " + deviceInfo.name);
+    return true;
+}
+
+void MidiInputManager::closeDevice()
+{
+    if (device != nullptr)
+    {
+        device->stop();
+        device.reset();
+    }
+
+    deviceInfo = juce::MidiDeviceInfo();
+}
+
+juce::Array<juce::MidiDeviceInfo> MidiInputManager::getAvailableDevices() const
+{
+    return juce::MidiInput::getAvailableDevices();
+}
+
+void MidiInputManager::handleIncomingMidiMessage(juce::MidiInput*, const juce::MidiMessage& message)
+{
+    // Clock, sysex and the rest are not for the controller
+    if (!message.isNoteOnOrOff() && !message.isController())
+        return;
+
+    Message incoming;
+    incoming.status = message.getRawData()[0];
+    incoming.data1 = message.getRawData()[1];
+    incoming.data2 = message.getRawData()[2];
+    incoming.timeMs = message.getTimeStamp() * 1000.0;
+
+    {
+        const juce::SpinLock::ScopedLockType lock(writeLock);
+        const auto scope = fifo.write(1);
+
+        if (scope.blockSize1 + scope.blockSize2 == 0)
+            return;
+
+        queue[static_cast<size_t>(scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)] = incoming;
+    }
+
+    PerformanceStats::getInstance().setQueueDepth(PerformanceStats::Queue::FeedbackEvents, fifo.getNumReady());
+    triggerAsyncUpdate();
+}
+
+void MidiInputManager::handleAsyncUpdate()
+{
+    GAMEPAD_TRACE_SCOPE("MidiInputManager::handleAsyncUpdate");
+
+    while (fifo.getNumReady() > 0)
+    {
+        Message message;
+        {
+            const auto scope = fifo.read(1);
+            message = queue[static_cast<size_t>(scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)];
+        }
+
+        if (onMessage)
+            onMessage(message);
+    }
+}
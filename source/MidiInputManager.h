@@ -0,0 +1,70 @@
+#pragma once
+
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include <array>
+#include <cstdint>
+#include <functional>
+
+/**
+ * Receives MIDI for the app, the way back from a DAW to the controller.
+ * Implemented as a singleton like MidiOutputManager.
+ *
+ * There is always a virtual input to send to (except on Windows), plus
+ * optionally one hardware or other-app input. Notes and CCs from both are
+ * queued by the MIDI threads without locking each other out for more than a
+ * copy, and delivered on the message thread with their arrival times.
+ */
+class MidiInputManager : private juce::MidiInputCallback,
+                         private juce::AsyncUpdater
+{
+public:
+    static MidiInputManager& getInstance()
+    {
+        static MidiInputManager instance;
+        return instance;
+    }
+
+    /** A channel message as it arrived. */
+    struct Message
+    {
+        std::uint8_t status = 0;
+        std::uint8_t data1 = 0;
+        std::uint8_t data2 = 0;
+        double timeMs = 0.0;    // Millisecond counter time of arrival
+
+        int getChannel() const noexcept { return (status & 0x0f) + 1; }
+        bool isNoteOn() const noexcept { return (status & 0xf0) == 0x90 && data2 > 0; }
+        bool isNoteOff() const noexcept { return (status & 0xf0) == 0x80 || ((status & 0xf0) == 0x90 && data2 == 0); }
+        bool isController() const noexcept { return (status & 0xf0) == 0xb0; }
+    };
+
+    MidiInputManager();
+    ~MidiInputManager() override;
+
+    bool createVirtualDevice();
+    bool openDevice(const juce::String& identifier);
+    void closeDevice();
+    juce::String getCurrentDeviceIdentifier() const { return deviceInfo.identifier; }
+    juce::Array<juce::MidiDeviceInfo> getAvailableDevices() const;
+
+    // Called on the message thread for every note on, note off and CC
+    std::function<void(const Message&)> onMessage;
+
+private:
+    void handleIncomingMidiMessage(juce::MidiInput* source, const juce::MidiMessage& message) override;
+    void handleAsyncUpdate() override;
+
+    std::unique_ptr<juce::MidiInput> virtualDevice;
+    std::unique_ptr<juce::MidiInput> device;
+    juce::MidiDeviceInfo deviceInfo;
+
+    // AbstractFifo allows one writer at a time; the lock serialises the inputs
+    static constexpr int queueSize = 512;
+    juce::AbstractFifo fifo { queueSize };
+    std::array<Message, queueSize> queue;
+    juce::SpinLock writeLock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiInputManager)
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include "GamepadManager.h"
+
+/** One MIDI message produced by a gamepad control. */
+struct MidiMapping
+{
+    enum class Type {
+        ControlChange,
+        Note
+    };
+
+    // Filter applied to the raw samples of a continuous control before mapping
+    enum class Smoothing {
+        None,
+        OneEuro,    // Adaptive low pass: smooth when slow, snappy when fast
+        Ema,        // Fixed cutoff low pass
+        Slew        // Limits the rate of change
+    };
+
+    // Scale a continuous Note mapping plays across its range, rooted at noteNumber
+    enum class Scale {
+        None,       // Always noteNumber
+        Chromatic,
+        Major,
+        Minor,
+        Dorian,
+        MajorPentatonic,
+        MinorPentatonic,
+        Blues
+    };
+
+    Type type = Type::ControlChange;
+    int channel;
+    int ccNumber;  // For CC messages
+    int noteNumber;  // For Note messages
+    float minValue;
+    float maxValue;
+    bool isButton;
+    Smoothing smoothing = Smoothing::None;
+    float smoothingFrequency = 1.0f;  // Cutoff in Hz (One-Euro minimum cutoff, EMA) or full range per second (slew)
+    float smoothingBeta = 0.0f;       // One-Euro speed coefficient
+    
+    // Notes on continuous controls: on above the threshold, off once the value
+    // drops by the hysteresis below it, so a sweep plays exactly one note
+    float gateThreshold = 0.75f;
+    float gateHysteresis = 0.1f;
+    bool aftertouch = false;          // Polyphonic aftertouch follows the value while the note is held
+    float velocitySpeed = 0.0f;       // Stroke speed (full range per second) that plays maxValue; 0 uses the value at the crossing
+    
+    // With a scale the value also picks the pitch while the gate is open; a
+    // threshold of 0 keeps it sounding across the whole range
+    Scale scale = Scale::None;
+    int scaleRange = 12;              // Semitones from noteNumber up to the highest note
+
+    bool operator==(const MidiMapping&) const = default;
+};
+
+// Indices into the touchpad mappings
+namespace TouchpadControl
+{
+    constexpr int X = 0;
+    constexpr int Y = 1;
+    constexpr int Pressure = 2;
+    constexpr int Button = 3;
+    constexpr int count = 4;
+}
+
+/** Value snapshot of every mapping, small enough to copy per edit. */
+struct MidiMappingSet
+{
+    std::array<std::vector<MidiMapping>, GamepadManager::MAX_AXES> axisMappings;
+    std::array<std::vector<MidiMapping>, GamepadManager::MAX_BUTTONS> buttonMappings;
+    std::array<std::vector<MidiMapping>, 3> gyroMappings;  // X, Y, Z
+    std::array<std::vector<MidiMapping>, 3> accelerometerMappings;  // X, Y, Z
+    std::array<std::vector<MidiMapping>, TouchpadControl::count> touchpadMappings;  // X, Y, Pressure, Button
+    std::array<std::vector<MidiMapping>, MotionGesture::count> motionMappings;  // Shake, flicks, tilt-snaps
+
+    bool operator==(const MidiMappingSet&) const = default;
+};
@@ -1,7 +1,14 @@
 #include "MidiOutputManager.h"
+#include "MidiClock.h"
+#include "PerformanceStats.h"
+#include "TraceRecorder.h"
+#include <bit>
+#include <utility>
 
 MidiOutputManager::MidiOutputManager()
 {
+    queuedSlots.reserve(ccSlots.size());
+    
     #if JUCE_WINDOWS
         juce::Logger::writeToLog("Virtual MIDI device creation skipped on Windows");
         return;
@@ -60,6 +67,7 @@ bool MidiOutputManager::isVirtualDevice(const juce::String& identifier) const
 
 MidiOutputManager::~MidiOutputManager()
 {
+    stopTimer();
     closeCurrentDevice();
     if (virtualDevice != nullptr)
     {
@@ -73,6 +81,13 @@ void MidiOutputManager::closeCurrentDevice()
     if (midiOutput != nullptr)
     {
         juce::Logger::writeToLog("Closing MIDI device: " + currentDeviceInfo.name);
+        
+        // Nothing sent later will reach this device, so drop what it has not
+        // sent yet and end its notes now
+        midiOutput->clearAllPendingMessages();
+        lastScheduledTimes.fill(0.0);
+        releaseAllNotes();
+        
         // If this is the virtual device, move it back to virtualDevice instead of closing it
         if (isVirtualDevice(currentDeviceInfo.identifier))
         {
@@ -85,6 +100,9 @@ void MidiOutputManager::closeCurrentDevice()
             midiOutput.reset();
         }
         currentDeviceInfo = juce::MidiDeviceInfo();
+        
+        // The next device has to receive every value again
+        resetControlChangeSlots();
     }
 }
 
@@ -104,6 +122,7 @@ bool MidiOutputManager::openDevice(const juce::String& identifier)
         // Move the virtual device to midiOutput
         midiOutput = std::move(virtualDevice);
         currentDeviceInfo = virtualDeviceInfo;
+        MidiClock::getInstance().pendingMessagesCleared();
         return true;
     }
     
@@ -116,6 +135,7 @@ bool MidiOutputManager::openDevice(const juce::String& identifier)
         midiOutput->startBackgroundThread();
         
         juce::Logger::writeToLog("Opened MIDI device: " + currentDeviceInfo.name);
+        MidiClock::getInstance().pendingMessagesCleared();
         return true;
     }
     
@@ -171,12 +191,10 @@ juce::Array<juce::MidiDeviceInfo> MidiOutputManager::getAvailableDevices() const
 
 void MidiOutputManager::sendControlChange(int channel, int controller, int value)
 {
-    juce::Logger::writeToLog("Attempting to send MIDI CC - Device: " + (midiOutput != nullptr ? currentDeviceInfo.name : "None") + 
-                            ", Channel: " + juce::String(channel) + 
-                            ", Controller: " + juce::String(controller) + 
-                            ", Value: " + juce::String(value));
+    GAMEPAD_TRACE_SCOPE("MidiOutputManager::sendControlChange");
     
-    if (midiOutput != nullptr)
+    // Sends are on the input latency path, so only problems are logged
+    if (hasOutput())
     {
         // Check if channel is valid (1-16)
         if (channel < 1 || channel > 16)
@@ -195,12 +213,12 @@ void MidiOutputManager::sendControlChange(int channel, int controller, int value
         }
         
         juce::MidiMessage message = juce::MidiMessage::controllerEvent(channel, controller, value);
-        midiOutput->sendMessageNow(message);
-        juce::Logger::writeToLog("MIDI CC message sent successfully to " + currentDeviceInfo.name + 
-                                (isVirtualDevice(currentDeviceInfo.identifier) ? " (Virtual Device)" : ""));
+        sendNow(message);
+        PerformanceStats::getInstance().recordMidiSent();
     }
     else
     {
+        PerformanceStats::getInstance().recordMidiDropped();
         juce::Logger::writeToLog("WARNING: No MIDI output device selected! Current device info: " + 
                                 currentDeviceInfo.name + " (" + currentDeviceInfo.identifier + ")" +
                                 (isVirtualDevice(currentDeviceInfo.identifier) ? " (Virtual Device)" : ""));
@@ -209,13 +227,273 @@ void MidiOutputManager::sendControlChange(int channel, int controller, int value
 
 void MidiOutputManager::sendNoteOn(int channel, int noteNumber, float velocity)
 {
-    juce::Logger::writeToLog("Attempting to send MIDI Note On - Device: " + (midiOutput != nullptr ? currentDeviceInfo.name : "None") + 
-                            ", Channel: " + juce::String(channel) + 
-                            ", Note Number: " + juce::String(noteNumber) + 
-                            ", Velocity: " + juce::String(velocity));
-    if (midiOutput != nullptr)
+    GAMEPAD_TRACE_SCOPE("MidiOutputManager::sendNoteOn");
+    
+    if (hasOutput())
     {
         auto message = juce::MidiMessage::noteOn(channel, noteNumber, velocity);
+        sendNow(message);
+        PerformanceStats::getInstance().recordMidiSent();
+        
+        // Velocities that round to zero are note offs too
+        setNoteActive(channel, noteNumber, message.isNoteOn());
+    }
+    else
+    {
+        PerformanceStats::getInstance().recordMidiDropped();
+    }
+} 
+
+void MidiOutputManager::sendMessageAt(const juce::MidiMessage& message, double millisecondCounter)
+{
+    if (hasOutput())
+    {
+        sendTimed(message, millisecondCounter);
+        PerformanceStats::getInstance().recordMidiSent();
+    }
+    else
+    {
+        PerformanceStats::getInstance().recordMidiDropped();
+    }
+}
+
+void MidiOutputManager::sendNoteOnAt(int channel, int noteNumber, float velocity, double millisecondCounter)
+{
+    GAMEPAD_TRACE_SCOPE("MidiOutputManager::sendNoteOnAt");
+    
+    if (!hasOutput() || !isValidNote(channel, noteNumber))
+    {
+        PerformanceStats::getInstance().recordMidiDropped();
+        return;
+    }
+    
+    auto message = juce::MidiMessage::noteOn(channel, noteNumber, velocity);
+    sendMessageAt(message, millisecondCounter);
+    
+    // A pending note off must not hide a note that is still sounding from releaseAllNotes
+    auto index = static_cast<size_t>((channel - 1) * 2 + noteNumber / 64);
+    scheduledNotes[index] |= std::uint64_t { 1 } << (noteNumber % 64);
+    setNoteActive(channel, noteNumber, message.isNoteOn());
+    
+    auto slot = static_cast<size_t>((channel - 1) * 128 + noteNumber);
+    lastScheduledTimes[slot] = juce::jmax(lastScheduledTimes[slot], millisecondCounter);
+    
+    if (message.isNoteOn())
+        noteOnTimes[slot] = millisecondCounter;
+}
+
+double MidiOutputManager::getScheduledNoteOnTime(int channel, int noteNumber) const noexcept
+{
+    return isValidNote(channel, noteNumber) ? noteOnTimes[static_cast<size_t>((channel - 1) * 128 + noteNumber)] : 0.0;
+}
+
+bool MidiOutputManager::isValidNote(int channel, int noteNumber) noexcept
+{
+    return juce::isPositiveAndBelow(channel - 1, 16) && juce::isPositiveAndBelow(noteNumber, 128);
+}
+
+void MidiOutputManager::setNoteActive(int channel, int noteNumber, bool active) noexcept
+{
+    if (!isValidNote(channel, noteNumber))
+        return;
+    
+    auto& word = activeNotes[static_cast<size_t>((channel - 1) * 2 + noteNumber / 64)];
+    auto bit = std::uint64_t { 1 } << (noteNumber % 64);
+    word = active ? (word | bit) : (word & ~bit);
+}
+
+bool MidiOutputManager::isNoteActive(int channel, int noteNumber) const noexcept
+{
+    if (!isValidNote(channel, noteNumber))
+        return false;
+    
+    return (activeNotes[static_cast<size_t>((channel - 1) * 2 + noteNumber / 64)] >> (noteNumber % 64)) & 1;
+}
+
+void MidiOutputManager::releaseAllNotes()
+{
+    GAMEPAD_TRACE_SCOPE("MidiOutputManager::releaseAllNotes");
+    
+    // Other timed messages, such as the sequencer's steps and the clock, are
+    // left to go out; a note with one of its own still to come is ended after it
+    auto now = juce::Time::getMillisecondCounterHiRes();
+    
+    for (size_t i = 0; i < activeNotes.size(); ++i)
+    {
+        auto channel = static_cast<int>(i / 2) + 1;
+        auto scheduled = std::exchange(scheduledNotes[i], 0);
+        
+        // Only the set bits are visited, so an idle output costs 32 compares
+        for (auto word = std::exchange(activeNotes[i], 0) | scheduled; word != 0; word &= word - 1)
+        {
+            auto bit = std::countr_zero(word);
+            auto noteNumber = static_cast<int>(i % 2) * 64 + bit;
+            auto slot = static_cast<size_t>((channel - 1) * 128 + noteNumber);
+            auto due = std::exchange(lastScheduledTimes[slot], 0.0);
+            
+            if (!hasOutput())
+                continue;
+            
+            if (((scheduled >> bit) & 1) != 0 && due > now)
+            {
+                sendMessageAt(juce::MidiMessage::noteOff(channel, noteNumber), due);
+            }
+            else
+            {
+                sendNow(juce::MidiMessage::noteOff(channel, noteNumber));
+                PerformanceStats::getInstance().recordMidiSent();
+            }
+        }
+    }
+}
+
+void MidiOutputManager::panic()
+{
+    juce::Logger::writeToLog("MIDI panic");
+    releaseAllNotes();
+    
+    // Catches notes that were started before this output was selected
+    if (hasOutput())
+    {
+        for (int channel = 1; channel <= 16; ++channel)
+            sendNow(juce::MidiMessage::allNotesOff(channel));
+    }
+}
+
+void MidiOutputManager::setDestination(Destination* newDestination)
+{
+    releaseAllNotes();
+    destination = newDestination;
+    lastScheduledTimes.fill(0.0);
+    
+    // Like a new device, the destination has to receive every value again
+    resetControlChangeSlots();
+}
+
+void MidiOutputManager::sendNow(const juce::MidiMessage& message)
+{
+    if (destination != nullptr)
+        destination->send(message, 0.0);
+    else
         midiOutput->sendMessageNow(message);
+}
+
+void MidiOutputManager::sendTimed(const juce::MidiMessage& message, double millisecondCounter)
+{
+    if (destination != nullptr)
+    {
+        destination->send(message, millisecondCounter);
+        return;
+    }
+    
+    // One message at sample 0 of a buffer "sampled" in milliseconds
+    juce::MidiBuffer buffer;
+    buffer.addEvent(message, 0);
+    midiOutput->sendBlockOfMessages(buffer, millisecondCounter, 1000.0);
+}
+
+void MidiOutputManager::sendAftertouch(int channel, int noteNumber, int value)
+{
+    GAMEPAD_TRACE_SCOPE("MidiOutputManager::sendAftertouch");
+    
+    if (hasOutput())
+    {
+        auto message = juce::MidiMessage::aftertouchChange(channel, noteNumber, value);
+        sendNow(message);
+        PerformanceStats::getInstance().recordMidiSent();
+    }
+    else
+    {
+        PerformanceStats::getInstance().recordMidiDropped();
+    }
+}
+
+void MidiOutputManager::sendControlChangeCoalesced(int channel, int controller, int value)
+{
+    // Out of range messages take the normal path, which corrects and logs them
+    if (channel < 1 || channel > 16 || controller < 0 || controller > 127)
+    {
+        sendControlChange(channel, controller, value);
+        return;
+    }
+    
+    auto& stats = PerformanceStats::getInstance();
+    auto slotIndex = (channel - 1) * 128 + controller;
+    auto& slot = ccSlots[static_cast<size_t>(slotIndex)];
+    auto now = juce::Time::getMillisecondCounterHiRes();
+    
+    // A held back value is superseded by this one either way
+    if (slot.pendingValue >= 0)
+    {
+        slot.pendingValue = -1;
+        stats.recordMidiCoalesced();
     }
-} 
\ No newline at end of file
+    
+    if (value == slot.lastSentValue)
+    {
+        stats.recordMidiCoalesced();
+        return;
+    }
+    
+    if (now - slot.lastSendTime >= minimumCCIntervalMs)
+    {
+        sendCoalescedNow(slotIndex, value, now);
+        return;
+    }
+    
+    slot.pendingValue = value;
+    if (!slot.queued)
+    {
+        slot.queued = true;
+        queuedSlots.push_back(slotIndex);
+    }
+    
+    if (!isTimerRunning())
+        startTimer(1);
+}
+
+void MidiOutputManager::sendCoalescedNow(int slotIndex, int value, double now)
+{
+    auto& slot = ccSlots[static_cast<size_t>(slotIndex)];
+    slot.lastSentValue = value;
+    slot.lastSendTime = now;
+    
+    sendControlChange(slotIndex / 128 + 1, slotIndex % 128, value);
+}
+
+void MidiOutputManager::timerCallback()
+{
+    auto now = juce::Time::getMillisecondCounterHiRes();
+    
+    for (size_t i = 0; i < queuedSlots.size();)
+    {
+        auto slotIndex = queuedSlots[i];
+        auto& slot = ccSlots[static_cast<size_t>(slotIndex)];
+        
+        if (slot.pendingValue >= 0 && now - slot.lastSendTime < minimumCCIntervalMs)
+        {
+            ++i;
+            continue;
+        }
+        
+        if (slot.pendingValue >= 0)
+            sendCoalescedNow(slotIndex, slot.pendingValue, now);
+        
+        slot.pendingValue = -1;
+        slot.queued = false;
+        queuedSlots[i] = queuedSlots.back();
+        queuedSlots.pop_back();
+    }
+    
+    if (queuedSlots.empty())
+        stopTimer();
+}
+
+void MidiOutputManager::resetControlChangeSlots()
+{
+    for (auto& slot : ccSlots)
+        slot = {};
+    
+    queuedSlots.clear();
+    stopTimer();
+}
@@ -8,7 +8,7 @@
  * Manages MIDI output for the gamepad controller
  * Implemented as a singleton to ensure only one instaxnce exists
  */
-class MidiOutputManager
+class MidiOutputManager : private juce::Timer
 {
 public:
     // Get singleton instance
@@ -27,7 +27,31 @@ public:
     bool setOutputDevice(const juce::String& identifier);
     juce::Array<juce::MidiDeviceInfo> getAvailableDevices() const;
     void sendControlChange(int channel, int controller, int value);
+    
+    // For continuous sources (axes, sensors, touchpad): repeated values are dropped
+    // and each CC is sent at most once per interval, the newest value is held back
+    // and sent when the interval has passed
+    void sendControlChangeCoalesced(int channel, int controller, int value);
+    void setMinimumControlChangeInterval(double milliseconds) { minimumCCIntervalMs = milliseconds; }
     void sendNoteOn(int channel, int noteNumber, float velocity);
+    void sendAftertouch(int channel, int noteNumber, int value);
+    
+    // Timed sends, for the clock and quantised notes: the output's background
+    // thread sends the message when the millisecond counter (Time::getMillisecondCounterHiRes)
+    // reaches the time. Scheduled notes are tracked like immediate ones.
+    // Pending messages are only dropped when the device closes; releasing
+    // ends a scheduled note after its last pending message instead.
+    void sendMessageAt(const juce::MidiMessage& message, double millisecondCounter);
+    void sendNoteOnAt(int channel, int noteNumber, float velocity, double millisecondCounter);
+    double getScheduledNoteOnTime(int channel, int noteNumber) const noexcept;
+    
+    // Every note on is tracked until its note off. Releasing sends a note off
+    // for exactly the notes still sounding; it happens on its own before the
+    // device closes or changes, and should whenever the source of the notes
+    // goes away. Panic also sends All Notes Off on every channel.
+    void releaseAllNotes();
+    void panic();
+    bool isNoteActive(int channel, int noteNumber) const noexcept;
     
     // Device management methods
     juce::String getCurrentDeviceIdentifier() const { return currentDeviceInfo.identifier; }
@@ -38,11 +62,56 @@ public:
     bool createVirtualDevice();
     bool isVirtualDevice(const juce::String& identifier) const;
     
+    // Receives everything in place of the device, e.g. so a test or benchmark
+    // can record exactly what is sent and when. Immediate messages come with
+    // a time of 0, timed ones with the time handed to the output.
+    struct Destination
+    {
+        virtual ~Destination() = default;
+        virtual void send(const juce::MidiMessage& message, double millisecondCounter) = 0;
+    };
+    
+    // Notes still sounding are released to the old destination first; nullptr goes back to the device
+    void setDestination(Destination* newDestination);
+    
 private:
+    struct ControlChangeSlot
+    {
+        int lastSentValue = -1;
+        int pendingValue = -1;
+        double lastSendTime = 0.0;
+        bool queued = false;
+    };
+    
+    void timerCallback() override;
+    void sendCoalescedNow(int slotIndex, int value, double now);
+    void resetControlChangeSlots();
+    void setNoteActive(int channel, int noteNumber, bool active) noexcept;
+    static bool isValidNote(int channel, int noteNumber) noexcept;
+    
+    bool hasOutput() const noexcept { return destination != nullptr || midiOutput != nullptr; }
+    void sendNow(const juce::MidiMessage& message);
+    void sendTimed(const juce::MidiMessage& message, double millisecondCounter);
+    
     std::unique_ptr<juce::MidiOutput> midiOutput;
     std::unique_ptr<juce::MidiOutput> virtualDevice;
     juce::MidiDeviceInfo currentDeviceInfo;
     juce::MidiDeviceInfo virtualDeviceInfo;
+    Destination* destination = nullptr;
+    
+    // One slot per channel and controller, plus the slots waiting for their interval
+    std::array<ControlChangeSlot, 16 * 128> ccSlots;
+    std::vector<int> queuedSlots;
+    double minimumCCIntervalMs = 4.0;
+    
+    // One bit per channel and note that is sounding, two words per channel
+    std::array<std::uint64_t, 16 * 2> activeNotes {};
+    
+    // Notes with a timed message that may still be pending, when each last
+    // started and when its latest timed message is due
+    std::array<std::uint64_t, 16 * 2> scheduledNotes {};
+    std::array<double, 16 * 128> noteOnTimes {};
+    std::array<double, 16 * 128> lastScheduledTimes {};
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiOutputManager)
 }; 
\ No newline at end of file
@@ -0,0 +1,246 @@
+#include "MotionGestureRecognizer.h"
+#include <cmath>
+
+namespace
+{
+    constexpr int windowMask = MotionGestureRecognizer::windowFrames - 1;
+    static_assert((MotionGestureRecognizer::windowFrames & windowMask) == 0, "The window wraps with a mask");
+
+    constexpr MotionGestureRecognizer::GestureMask bit(int gesture) noexcept
+    {
+        return static_cast<MotionGestureRecognizer::GestureMask>(1u << gesture);
+    }
+
+    constexpr auto flickBits = bit(MotionGesture::FlickLeft) | bit(MotionGesture::FlickRight)
+                             | bit(MotionGesture::FlickUp) | bit(MotionGesture::FlickDown);
+    constexpr auto tiltBits = bit(MotionGesture::TiltSnapLeft) | bit(MotionGesture::TiltSnapRight);
+
+    constexpr double slowGravitySeconds = 0.5;
+    constexpr double fastGravitySeconds = 0.04;
+    constexpr double accelGapSeconds = 0.1;
+    constexpr float radiansToDegrees = 57.2957795f;
+
+    // A quick rotation that stops with a small rebound, peak at frame 7; stored
+    // with the mean removed and unit length so matching needs one dot product
+    const std::array<float, MotionGestureRecognizer::windowFrames> flickTemplate = []
+    {
+        std::array<float, MotionGestureRecognizer::windowFrames> shape {
+            0.0f, 0.0f, 0.0f, 0.05f, 0.2f, 0.5f, 0.85f, 1.0f, 0.85f, 0.5f, 0.2f, 0.0f, -0.15f, -0.2f, -0.1f, 0.0f
+        };
+
+        float mean = 0.0f;
+        for (auto value : shape)
+            mean += value / static_cast<float>(shape.size());
+
+        float length = 0.0f;
+        for (auto& value : shape)
+        {
+            value -= mean;
+            length += value * value;
+        }
+
+        for (auto& value : shape)
+            value /= std::sqrt(length);
+
+        return shape;
+    }();
+}
+
+MotionGestureRecognizer::GestureMask MotionGestureRecognizer::addGyro(const float* radiansPerSecond, std::uint64_t timestampNs) noexcept
+{
+    GestureMask changed = 0;
+
+    // First sample, a clock that went backwards or a gap too long to bridge: start the window over
+    if (frameEndNs == 0 || timestampNs + frameNs < frameEndNs || timestampNs >= frameEndNs + maxGapFrames * frameNs)
+    {
+        pitch = {};
+        yaw = {};
+        head = 0;
+        pitchSum = yawSum = 0.0f;
+        frameSamples = 0;
+        frameEndNs = timestampNs + frameNs;
+        flickEndNs = 0;
+    }
+
+    // Bounded by the gap check above
+    while (timestampNs >= frameEndNs)
+    {
+        closeFrame();
+        frameEndNs += frameNs;
+        changed |= matchFlick(timestampNs);
+    }
+
+    pitchSum += radiansPerSecond[0];
+    yawSum += radiansPerSecond[1];
+    ++frameSamples;
+
+    if ((active & flickBits) != 0 && timestampNs >= flickEndNs)
+    {
+        changed |= active & flickBits;
+        active &= static_cast<GestureMask>(~flickBits);
+    }
+
+    return changed;
+}
+
+void MotionGestureRecognizer::closeFrame() noexcept
+{
+    // An empty frame holds the last value, so a late sample does not look like a stop
+    auto newest = static_cast<size_t>((head + windowMask) & windowMask);
+    auto slot = static_cast<size_t>(head);
+
+    pitch[slot] = frameSamples > 0 ? pitchSum / static_cast<float>(frameSamples) : pitch[newest];
+    yaw[slot] = frameSamples > 0 ? yawSum / static_cast<float>(frameSamples) : yaw[newest];
+    head = (head + 1) & windowMask;
+
+    pitchSum = yawSum = 0.0f;
+    frameSamples = 0;
+}
+
+MotionGestureRecognizer::GestureMask MotionGestureRecognizer::matchFlick(std::uint64_t timestampNs) noexcept
+{
+    // One flick at a time, and none while shaking
+    if ((active & (flickBits | bit(MotionGesture::Shake))) != 0)
+        return 0;
+
+    auto peakSlot = static_cast<size_t>((head + peakFrame) & windowMask);
+    bool isYaw = std::abs(yaw[peakSlot]) >= std::abs(pitch[peakSlot]);
+    const auto& window = isYaw ? yaw : pitch;
+    auto peak = window[peakSlot];
+
+    if (std::abs(peak) < flickThreshold)
+        return 0;
+
+    // Only at the top of the pulse, so a broad one is matched once
+    auto sign = peak > 0.0f ? 1.0f : -1.0f;
+    for (auto value : window)
+        if (value * sign > peak * sign)
+            return 0;
+
+    if (correlate(window, sign) < flickMatch)
+        return 0;
+
+    flickEndNs = timestampNs + flickHoldNs;
+
+    // Positive yaw turns the pad to the left, positive pitch tips its far edge up
+    if (isYaw)
+        return set(sign > 0.0f ? MotionGesture::FlickLeft : MotionGesture::FlickRight, true);
+
+    return set(sign > 0.0f ? MotionGesture::FlickUp : MotionGesture::FlickDown, true);
+}
+
+float MotionGestureRecognizer::correlate(const std::array<float, windowFrames>& window, float sign) const noexcept
+{
+    // The template has no mean, so the window's mean drops out of the numerator
+    float sum = 0.0f;
+    float sumSquares = 0.0f;
+    float dot = 0.0f;
+
+    for (int k = 0; k < windowFrames; ++k)
+    {
+        auto value = window[static_cast<size_t>((head + k) & windowMask)] * sign;
+        sum += value;
+        sumSquares += value * value;
+        dot += value * flickTemplate[static_cast<size_t>(k)];
+    }
+
+    auto variance = sumSquares - sum * sum / static_cast<float>(windowFrames);
+    return variance > 1.0e-6f ? dot / std::sqrt(variance) : 0.0f;
+}
+
+MotionGestureRecognizer::GestureMask MotionGestureRecognizer::addAccel(const float* metresPerSecondSquared, std::uint64_t timestampNs) noexcept
+{
+    GestureMask changed = 0;
+    auto deltaSeconds = static_cast<double>(timestampNs - accelNs) * 1.0e-9;
+
+    if (accelNs == 0 || timestampNs <= accelNs || deltaSeconds > accelGapSeconds)
+    {
+        for (size_t axis = 0; axis < 3; ++axis)
+            slowGravity[axis] = fastGravity[axis] = metresPerSecondSquared[axis];
+
+        lastLevelNs = 0;
+    }
+    else
+    {
+        auto slow = static_cast<float>(deltaSeconds / (deltaSeconds + slowGravitySeconds));
+        auto fast = static_cast<float>(deltaSeconds / (deltaSeconds + fastGravitySeconds));
+
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            slowGravity[axis] += slow * (metresPerSecondSquared[axis] - slowGravity[axis]);
+            fastGravity[axis] += fast * (metresPerSecondSquared[axis] - fastGravity[axis]);
+        }
+    }
+
+    accelNs = timestampNs;
+
+    // Shake: enough reversals of strong acceleration on one axis within the window
+    bool strong = false;
+    for (size_t axis = 0; axis < 3; ++axis)
+    {
+        auto linear = metresPerSecondSquared[axis] - slowGravity[axis];
+        if (std::abs(linear) < shakeThreshold)
+            continue;
+
+        strong = true;
+        auto sign = static_cast<std::int8_t>(linear > 0.0f ? 1 : -1);
+        if (sign == lastPeakSign[axis])
+            continue;
+
+        lastPeakSign[axis] = sign;
+        auto& times = reversalNs[axis];
+        auto& next = nextReversal[axis];
+        times[static_cast<size_t>(next)] = timestampNs;
+        next = (next + 1) % shakeReversals;
+
+        // The slot written next holds the oldest of the last few reversals
+        auto oldest = times[static_cast<size_t>(next)];
+        if (oldest != 0 && timestampNs - oldest <= shakeWindowNs)
+            changed |= set(MotionGesture::Shake, true);
+    }
+
+    if (strong)
+        lastStrongNs = timestampNs;
+    else if ((active & bit(MotionGesture::Shake)) != 0 && timestampNs - lastStrongNs > shakeReleaseNs)
+        changed |= set(MotionGesture::Shake, false);
+
+    // Tilt-snap: roll of the gravity estimate, positive with the right side down
+    auto roll = std::atan2(-fastGravity[0], fastGravity[1]) * radiansToDegrees;
+
+    if (std::abs(roll) < levelDegrees)
+        lastLevelNs = timestampNs;
+
+    if ((active & tiltBits) != 0)
+    {
+        if ((active & bit(MotionGesture::TiltSnapRight)) != 0 && roll < releaseDegrees)
+            changed |= set(MotionGesture::TiltSnapRight, false);
+
+        if ((active & bit(MotionGesture::TiltSnapLeft)) != 0 && roll > -releaseDegrees)
+            changed |= set(MotionGesture::TiltSnapLeft, false);
+    }
+    else if ((active & bit(MotionGesture::Shake)) == 0
+             && std::abs(roll) > snapDegrees
+             && lastLevelNs != 0 && timestampNs - lastLevelNs <= snapNs)
+    {
+        // Only while the pad is mostly feeling gravity, not being thrown about
+        auto magnitudeSquared = fastGravity[0] * fastGravity[0] + fastGravity[1] * fastGravity[1] + fastGravity[2] * fastGravity[2];
+        if (magnitudeSquared > 7.0f * 7.0f && magnitudeSquared < 12.5f * 12.5f)
+            changed |= set(roll > 0.0f ? MotionGesture::TiltSnapRight : MotionGesture::TiltSnapLeft, true);
+    }
+
+    return changed;
+}
+
+MotionGestureRecognizer::GestureMask MotionGestureRecognizer::set(int gesture, bool on) noexcept
+{
+    if (((active & bit(gesture)) != 0) == on)
+        return 0;
+
+    active ^= bit(gesture);
+    return bit(gesture);
+}
+
+void MotionGestureRecognizer::reset() noexcept
+{
+    *this = {};
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// Indices into the motion gesture mappings
+namespace MotionGesture
+{
+    constexpr int Shake = 0;
+    constexpr int FlickLeft = 1;
+    constexpr int FlickRight = 2;
+    constexpr int FlickUp = 3;
+    constexpr int FlickDown = 4;
+    constexpr int TiltSnapLeft = 5;
+    constexpr int TiltSnapRight = 6;
+    constexpr int count = 7;
+}
+
+/**
+ * Turns the raw gyro and accelerometer stream of one gamepad into discrete
+ * gestures, each on while it lasts like a button.
+ *
+ * Shake counts direction reversals of the acceleration left after removing
+ * a slow gravity estimate. Tilt-snap watches the roll of a fast gravity
+ * estimate and only fires when the pad goes from level to well over within
+ * a short time, so a slow lean never does. Flicks are found in two steps:
+ * the gyro is box-averaged onto a fixed 4 ms frame grid, whatever the
+ * sensor rate, and a frame whose pitch or yaw peaks past the threshold is
+ * matched against a short pulse-and-rebound template by normalised
+ * correlation over the last few frames.
+ *
+ * Every sample costs a fixed amount of arithmetic plus at most one template
+ * match per frame it closes, and a gap in the stream closes a bounded number
+ * of frames, so the cost per sample does not depend on the sensor rate or
+ * on how long the pad has been running. Timestamps are the sensor's own, in
+ * nanoseconds, so late delivery does not distort the timing.
+ */
+class MotionGestureRecognizer
+{
+public:
+    // Bit n is set while gesture n is on
+    using GestureMask = std::uint8_t;
+    static_assert(MotionGesture::count <= 8, "Gestures must fit the mask");
+
+    // Axes as SDL reports them: radians per second and metres per second squared.
+    // Each returns the gestures that turned on or off with this sample.
+    GestureMask addGyro(const float* radiansPerSecond, std::uint64_t timestampNs) noexcept;
+    GestureMask addAccel(const float* metresPerSecondSquared, std::uint64_t timestampNs) noexcept;
+
+    GestureMask getActive() const noexcept { return active; }
+
+    // Forget the stream, e.g. when the pad goes away; nothing is reported off
+    void reset() noexcept;
+
+    static constexpr int windowFrames = 16;
+    static constexpr std::uint64_t frameNs = 4'000'000;
+
+private:
+    void closeFrame() noexcept;
+    GestureMask matchFlick(std::uint64_t timestampNs) noexcept;
+    float correlate(const std::array<float, windowFrames>& window, float sign) const noexcept;
+    GestureMask set(int gesture, bool on) noexcept;
+
+    static constexpr int peakFrame = 7;                 // Template peak, frames from the oldest
+    static constexpr float flickThreshold = 5.0f;       // Rad/s at the peak
+    static constexpr float flickMatch = 0.8f;           // Correlation that counts as a flick
+    static constexpr std::uint64_t flickHoldNs = 120'000'000;
+    static constexpr int maxGapFrames = 8;              // Frames held across a gap before the window restarts
+
+    static constexpr float shakeThreshold = 15.0f;      // Metres per second squared, gravity removed
+    static constexpr int shakeReversals = 4;
+    static constexpr std::uint64_t shakeWindowNs = 500'000'000;
+    static constexpr std::uint64_t shakeReleaseNs = 300'000'000;
+
+    static constexpr float levelDegrees = 20.0f;
+    static constexpr float snapDegrees = 45.0f;
+    static constexpr float releaseDegrees = 30.0f;
+    static constexpr std::uint64_t snapNs = 250'000'000;
+
+    // Gyro frames, pitch (X) and yaw (Y) only
+    std::array<float, windowFrames> pitch {};
+    std::array<float, windowFrames> yaw {};
+    int head = 0;                                       // Oldest frame
+    float pitchSum = 0.0f;
+    float yawSum = 0.0f;
+    int frameSamples = 0;
+    std::uint64_t frameEndNs = 0;
+    std::uint64_t flickEndNs = 0;
+
+    // Accelerometer
+    std::array<float, 3> slowGravity {};
+    std::array<float, 3> fastGravity {};
+    std::uint64_t accelNs = 0;
+    std::array<std::int8_t, 3> lastPeakSign {};
+    std::array<std::array<std::uint64_t, shakeReversals>, 3> reversalNs {};
+    std::array<int, 3> nextReversal {};
+    std::uint64_t lastStrongNs = 0;
+    std::uint64_t lastLevelNs = 0;
+
+    GestureMask active = 0;
+};
@@ -0,0 +1,249 @@
+#include "PerformanceStats.h"
+
+namespace
+{
+    void updateMaximum(std::atomic<std::uint64_t>& maximum, std::uint64_t value) noexcept
+    {
+        auto current = maximum.load(std::memory_order_relaxed);
+        while (value > current && !maximum.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void updateMaximum(std::atomic<int>& maximum, int value) noexcept
+    {
+        auto current = maximum.load(std::memory_order_relaxed);
+        while (value > current && !maximum.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    double perSecond(std::uint64_t current, std::uint64_t previous, double elapsedMs)
+    {
+        if (elapsedMs <= 0.0 || current < previous)
+            return 0.0;
+
+        return static_cast<double>(current - previous) * 1000.0 / elapsedMs;
+    }
+
+    double averageMs(const PerformanceStats::Snapshot::StageTiming& current,
+                     const PerformanceStats::Snapshot::StageTiming& previous)
+    {
+        auto count = current.count - previous.count;
+        if (count == 0)
+            return 0.0;
+
+        return static_cast<double>(current.totalNs - previous.totalNs) / static_cast<double>(count) / 1.0e6;
+    }
+}
+
+void PerformanceStats::recordSdlEvent(SdlEvent type) noexcept
+{
+    sdlEvents[static_cast<size_t>(type)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void PerformanceStats::recordStageDuration(Stage stage, std::int64_t nanoseconds) noexcept
+{
+    auto& counters = stages[static_cast<size_t>(stage)];
+    auto ns = static_cast<std::uint64_t>(juce::jmax<std::int64_t>(0, nanoseconds));
+
+    counters.count.fetch_add(1, std::memory_order_relaxed);
+    counters.totalNs.fetch_add(ns, std::memory_order_relaxed);
+    counters.lastNs.store(ns, std::memory_order_relaxed);
+    updateMaximum(counters.maxNs, ns);
+}
+
+void PerformanceStats::setQueueDepth(Queue queue, int depth) noexcept
+{
+    auto index = static_cast<size_t>(queue);
+    queueDepths[index].store(depth, std::memory_order_relaxed);
+    updateMaximum(maxQueueDepths[index], depth);
+}
+
+PerformanceStats::Snapshot PerformanceStats::getSnapshot() const noexcept
+{
+    Snapshot snapshot;
+    snapshot.timeMs = juce::Time::getMillisecondCounterHiRes();
+
+    for (size_t i = 0; i < sdlEvents.size(); ++i)
+        snapshot.sdlEvents[i] = sdlEvents[i].load(std::memory_order_relaxed);
+
+    for (size_t i = 0; i < stages.size(); ++i)
+    {
+        snapshot.stages[i].count = stages[i].count.load(std::memory_order_relaxed);
+        snapshot.stages[i].totalNs = stages[i].totalNs.load(std::memory_order_relaxed);
+        snapshot.stages[i].maxNs = stages[i].maxNs.load(std::memory_order_relaxed);
+        snapshot.stages[i].lastNs = stages[i].lastNs.load(std::memory_order_relaxed);
+    }
+
+    snapshot.mappingEvaluations = mappingEvaluations.load(std::memory_order_relaxed);
+    snapshot.midiSent = midiSent.load(std::memory_order_relaxed);
+    snapshot.midiCoalesced = midiCoalesced.load(std::memory_order_relaxed);
+    snapshot.midiDropped = midiDropped.load(std::memory_order_relaxed);
+
+    for (size_t i = 0; i < queueDepths.size(); ++i)
+    {
+        snapshot.queueDepths[i] = queueDepths[i].load(std::memory_order_relaxed);
+        snapshot.maxQueueDepths[i] = maxQueueDepths[i].load(std::memory_order_relaxed);
+    }
+
+    return snapshot;
+}
+
+const char* PerformanceStats::getSdlEventName(SdlEvent type) noexcept
+{
+    switch (type)
+    {
+        case SdlEvent::GamepadAdded: return "gamepadAdded";
+        case SdlEvent::GamepadRemoved: return "gamepadRemoved";
+        case SdlEvent::AxisMotion: return "axisMotion";
+        case SdlEvent::Button: return "button";
+        case SdlEvent::Sensor: return "sensor";
+        case SdlEvent::Touchpad: return "touchpad";
+        case SdlEvent::Other: return "other";
+        default: return "unknown";
+    }
+}
+
+const char* PerformanceStats::getStageName(Stage stage) noexcept
+{
+    switch (stage)
+    {
+        case Stage::UpdateGamepadStates: return "updateGamepadStates";
+        case Stage::GuiFrame: return "guiFrame";
+        case Stage::InputToDispatch: return "inputToDispatch";
+        case Stage::MidiToFeedback: return "midiToFeedback";
+        default: return "unknown";
+    }
+}
+
+const char* PerformanceStats::getQueueName(Queue queue) noexcept
+{
+    switch (queue)
+    {
+        case Queue::SdlEvents: return "sdlEvents";
+        case Queue::MappingEvents: return "mappingEvents";
+        case Queue::FeedbackEvents: return "feedbackEvents";
+        default: return "unknown";
+    }
+}
+
+juce::String PerformanceStats::toJson(const Snapshot& current, const Snapshot& previous)
+{
+    auto elapsedMs = current.timeMs - previous.timeMs;
+
+    juce::DynamicObject::Ptr root = new juce::DynamicObject();
+    root->setProperty("timeMs", current.timeMs);
+    root->setProperty("intervalMs", elapsedMs);
+
+    juce::DynamicObject::Ptr events = new juce::DynamicObject();
+    for (int i = 0; i < numSdlEventTypes; ++i)
+    {
+        auto index = static_cast<size_t>(i);
+        juce::DynamicObject::Ptr eventObj = new juce::DynamicObject();
+        eventObj->setProperty("total", static_cast<juce::int64>(current.sdlEvents[index]));
+        eventObj->setProperty("perSecond", perSecond(current.sdlEvents[index], previous.sdlEvents[index], elapsedMs));
+        events->setProperty(getSdlEventName(static_cast<SdlEvent>(i)), juce::var(eventObj.get()));
+    }
+    root->setProperty("sdlEvents", juce::var(events.get()));
+
+    juce::DynamicObject::Ptr timings = new juce::DynamicObject();
+    for (int i = 0; i < numStages; ++i)
+    {
+        auto index = static_cast<size_t>(i);
+        const auto& stage = current.stages[index];
+        juce::DynamicObject::Ptr stageObj = new juce::DynamicObject();
+        stageObj->setProperty("count", static_cast<juce::int64>(stage.count));
+        stageObj->setProperty("perSecond", perSecond(stage.count, previous.stages[index].count, elapsedMs));
+        stageObj->setProperty("avgMs", averageMs(stage, previous.stages[index]));
+        stageObj->setProperty("lastMs", static_cast<double>(stage.lastNs) / 1.0e6);
+        stageObj->setProperty("maxMs", static_cast<double>(stage.maxNs) / 1.0e6);
+        timings->setProperty(getStageName(static_cast<Stage>(i)), juce::var(stageObj.get()));
+    }
+    root->setProperty("stages", juce::var(timings.get()));
+
+    juce::DynamicObject::Ptr mapping = new juce::DynamicObject();
+    mapping->setProperty("evaluations", static_cast<juce::int64>(current.mappingEvaluations));
+    mapping->setProperty("perSecond", perSecond(current.mappingEvaluations, previous.mappingEvaluations, elapsedMs));
+    root->setProperty("mapping", juce::var(mapping.get()));
+
+    juce::DynamicObject::Ptr midi = new juce::DynamicObject();
+    midi->setProperty("sent", static_cast<juce::int64>(current.midiSent));
+    midi->setProperty("sentPerSecond", perSecond(current.midiSent, previous.midiSent, elapsedMs));
+    midi->setProperty("coalesced", static_cast<juce::int64>(current.midiCoalesced));
+    midi->setProperty("dropped", static_cast<juce::int64>(current.midiDropped));
+    root->setProperty("midi", juce::var(midi.get()));
+
+    juce::DynamicObject::Ptr queues = new juce::DynamicObject();
+    for (int i = 0; i < numQueues; ++i)
+    {
+        auto index = static_cast<size_t>(i);
+        juce::DynamicObject::Ptr queueObj = new juce::DynamicObject();
+        queueObj->setProperty("depth", current.queueDepths[index]);
+        queueObj->setProperty("maxDepth", current.maxQueueDepths[index]);
+        queues->setProperty(getQueueName(static_cast<Queue>(i)), juce::var(queueObj.get()));
+    }
+    root->setProperty("queues", juce::var(queues.get()));
+
+    // Single line so the dump file stays one JSON object per line
+    return juce::JSON::toString(juce::var(root.get()), true);
+}
+
+juce::String PerformanceStats::toSummaryLine(const Snapshot& current, const Snapshot& previous)
+{
+    auto elapsedMs = current.timeMs - previous.timeMs;
+
+    std::uint64_t eventsNow = 0, eventsBefore = 0;
+    for (size_t i = 0; i < current.sdlEvents.size(); ++i)
+    {
+        eventsNow += current.sdlEvents[i];
+        eventsBefore += previous.sdlEvents[i];
+    }
+
+    const auto update = static_cast<size_t>(Stage::UpdateGamepadStates);
+    const auto gui = static_cast<size_t>(Stage::GuiFrame);
+    const auto dispatch = static_cast<size_t>(Stage::InputToDispatch);
+    const auto feedback = static_cast<size_t>(Stage::MidiToFeedback);
+
+    return juce::String::formatted("SDL %.0f/s | poll %.2fms (max %.2f) | map %.0f/s lat %.2fms | MIDI %.0f/s c:%llu d:%llu | fb %.2fms | q %d | gui %.2fms",
+                                   perSecond(eventsNow, eventsBefore, elapsedMs),
+                                   averageMs(current.stages[update], previous.stages[update]),
+                                   static_cast<double>(current.stages[update].maxNs) / 1.0e6,
+                                   perSecond(current.mappingEvaluations, previous.mappingEvaluations, elapsedMs),
+                                   averageMs(current.stages[dispatch], previous.stages[dispatch]),
+                                   perSecond(current.midiSent, previous.midiSent, elapsedMs),
+                                   static_cast<unsigned long long>(current.midiCoalesced),
+                                   static_cast<unsigned long long>(current.midiDropped),
+                                   averageMs(current.stages[feedback], previous.stages[feedback]),
+                                   current.queueDepths[static_cast<size_t>(Queue::SdlEvents)],
+                                   averageMs(current.stages[gui], previous.stages[gui]));
+}
+
+void PerformanceStats::startPeriodicDump(const juce::File& file, int intervalMs)
+{
+    dumper = std::make_unique<Dumper>(file, intervalMs);
+}
+
+void PerformanceStats::stopPeriodicDump()
+{
+    dumper.reset();
+}
+
+PerformanceStats::Dumper::Dumper(const juce::File& fileToWrite, int intervalMs)
+    : file(fileToWrite), previous(PerformanceStats::getInstance().getSnapshot())
+{
+    juce::Logger::writeToLog("Writing performance stats to: " + file.getFullPathName());
+    startTimer(intervalMs);
+}
+
+PerformanceStats::Dumper::~Dumper()
+{
+    stopTimer();
+}
+
+void PerformanceStats::Dumper::timerCallback()
+{
+    auto current = PerformanceStats::getInstance().getSnapshot();
+    file.appendText(toJson(current, previous) + "\n");
+    previous = current;
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include <atomic>
+#include <array>
+#include <cstdint>
+
+/**
+ * Lock-free counters and timings for the input -> mapping -> MIDI -> GUI pipeline.
+ * Every recording method is a handful of relaxed atomic operations, so it is safe
+ * to call from the SDL polling path, the MIDI path and the GUI at any rate.
+ * Counters only ever increase; rates are derived by diffing two snapshots.
+ */
+class PerformanceStats
+{
+public:
+    // Get singleton instance
+    static PerformanceStats& getInstance()
+    {
+        static PerformanceStats instance;
+        return instance;
+    }
+
+    // SDL event categories we count separately
+    enum class SdlEvent
+    {
+        GamepadAdded,
+        GamepadRemoved,
+        AxisMotion,
+        Button,
+        Sensor,
+        Touchpad,
+        Other,
+        NumTypes
+    };
+
+    // Timed stages of the pipeline
+    enum class Stage
+    {
+        UpdateGamepadStates,
+        GuiFrame,
+        InputToDispatch,  // From SDL sampling the input (or the click) to its mappings being sent
+        MidiToFeedback,   // From a MIDI message arriving to the rumble or LED write it causes
+        NumStages
+    };
+
+    // Queues whose depth we sample
+    enum class Queue
+    {
+        SdlEvents,      // Events drained in a single poll
+        MappingEvents,  // Input events waiting for the mapping engine
+        FeedbackEvents, // Incoming MIDI waiting for the feedback map
+        NumQueues
+    };
+
+    static constexpr int numSdlEventTypes = static_cast<int>(SdlEvent::NumTypes);
+    static constexpr int numStages = static_cast<int>(Stage::NumStages);
+    static constexpr int numQueues = static_cast<int>(Queue::NumQueues);
+
+    // Recording (hot path)
+    void recordSdlEvent(SdlEvent type) noexcept;
+    void recordStageDuration(Stage stage, std::int64_t nanoseconds) noexcept;
+    void recordMappingEvaluations(int count) noexcept { mappingEvaluations.fetch_add(static_cast<std::uint64_t>(count), std::memory_order_relaxed); }
+    void recordMidiSent() noexcept { midiSent.fetch_add(1, std::memory_order_relaxed); }
+    void recordMidiCoalesced() noexcept { midiCoalesced.fetch_add(1, std::memory_order_relaxed); }
+    void recordMidiDropped() noexcept { midiDropped.fetch_add(1, std::memory_order_relaxed); }
+    void setQueueDepth(Queue queue, int depth) noexcept;
+
+    /** Times the enclosing scope and records it against a stage. */
+    class ScopedTiming
+    {
+    public:
+        explicit ScopedTiming(Stage stageToTime) noexcept
+            : stage(stageToTime), startTicks(juce::Time::getHighResolutionTicks()) {}
+
+        ~ScopedTiming()
+        {
+            auto elapsed = juce::Time::getHighResolutionTicks() - startTicks;
+            PerformanceStats::getInstance().recordStageDuration(stage, ticksToNanoseconds(elapsed));
+        }
+
+    private:
+        Stage stage;
+        juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedTiming)
+    };
+
+    // Plain copy of all counters at one point in time
+    struct Snapshot
+    {
+        struct StageTiming
+        {
+            std::uint64_t count = 0;
+            std::uint64_t totalNs = 0;
+            std::uint64_t maxNs = 0;
+            std::uint64_t lastNs = 0;
+        };
+
+        double timeMs = 0.0;
+        std::array<std::uint64_t, numSdlEventTypes> sdlEvents {};
+        std::array<StageTiming, numStages> stages {};
+        std::uint64_t mappingEvaluations = 0;
+        std::uint64_t midiSent = 0;
+        std::uint64_t midiCoalesced = 0;
+        std::uint64_t midiDropped = 0;
+        std::array<int, numQueues> queueDepths {};
+        std::array<int, numQueues> maxQueueDepths {};
+    };
+
+    Snapshot getSnapshot() const noexcept;
+
+    // Formatting helpers (message thread only, these allocate)
+    static juce::String toJson(const Snapshot& current, const Snapshot& previous);
+    static juce::String toSummaryLine(const Snapshot& current, const Snapshot& previous);
+
+    static const char* getSdlEventName(SdlEvent type) noexcept;
+    static const char* getStageName(Stage stage) noexcept;
+    static const char* getQueueName(Queue queue) noexcept;
+
+    /** Appends one JSON line per interval to a file until stopped. */
+    void startPeriodicDump(const juce::File& file, int intervalMs);
+    void stopPeriodicDump();
+    bool isDumping() const noexcept { return dumper != nullptr; }
+
+    static std::int64_t ticksToNanoseconds(juce::int64 ticks) noexcept
+    {
+        return static_cast<std::int64_t>(juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e9);
+    }
+
+private:
+    PerformanceStats() = default;
+
+    struct StageCounters
+    {
+        std::atomic<std::uint64_t> count { 0 };
+        std::atomic<std::uint64_t> totalNs { 0 };
+        std::atomic<std::uint64_t> maxNs { 0 };
+        std::atomic<std::uint64_t> lastNs { 0 };
+    };
+
+    class Dumper : private juce::Timer
+    {
+    public:
+        Dumper(const juce::File& file, int intervalMs);
+        ~Dumper() override;
+
+    private:
+        void timerCallback() override;
+
+        juce::File file;
+        Snapshot previous;
+    };
+
+    std::array<std::atomic<std::uint64_t>, numSdlEventTypes> sdlEvents {};
+    std::array<StageCounters, numStages> stages;
+    std::atomic<std::uint64_t> mappingEvaluations { 0 };
+    std::atomic<std::uint64_t> midiSent { 0 };
+    std::atomic<std::uint64_t> midiCoalesced { 0 };
+    std::atomic<std::uint64_t> midiDropped { 0 };
+    std::array<std::atomic<int>, numQueues> queueDepths {};
+    std::array<std::atomic<int>, numQueues> maxQueueDepths {};
+
+    std::unique_ptr<Dumper> dumper;
+
+    JUCE_DECLARE_NON_COPYABLE(PerformanceStats)
+};
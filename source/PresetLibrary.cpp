@@ -0,0 +1,201 @@
+#include "PresetLibrary.h"
+#include "MappingPersistence.h"
+#include "MappingSerializer.h"
+#include <algorithm>
+#include <map>
+
+PresetLibrary::PresetLibrary(const juce::File& libraryDirectory)
+    : directory(libraryDirectory)
+{
+    if (!directory.exists())
+        directory.createDirectory();
+
+    loadIndex();
+    rescan();
+}
+
+bool PresetLibrary::rescan()
+{
+    auto files = directory.findChildFiles(juce::File::findFiles, false, "*.json");
+
+    std::map<juce::String, Entry*> indexed;
+    for (auto& entry : entries)
+        indexed[entry.fileName] = &entry;
+
+    std::vector<Entry> updated;
+    updated.reserve(static_cast<size_t>(files.size()));
+    bool changed = false;
+
+    for (const auto& file : files)
+    {
+        if (file == getIndexFile())
+            continue;
+
+        auto size = file.getSize();
+        auto modificationTime = file.getLastModificationTime().toMilliseconds();
+
+        auto existing = indexed.find(file.getFileName());
+
+        // Only files that were added or touched are opened
+        if (existing != indexed.end()
+            && existing->second->size == size
+            && existing->second->modificationTime == modificationTime)
+        {
+            updated.push_back(std::move(*existing->second));
+        }
+        else
+        {
+            updated.push_back(readEntry(file));
+            changed = true;
+        }
+    }
+
+    if (updated.size() != entries.size())
+        changed = true;
+
+    std::sort(updated.begin(), updated.end(), [](const Entry& a, const Entry& b)
+    {
+        return a.name.compareNatural(b.name) < 0;
+    });
+
+    entries = std::move(updated);
+
+    if (changed)
+        saveIndex();
+
+    return changed;
+}
+
+std::vector<const PresetLibrary::Entry*> PresetLibrary::search(const juce::String& query) const
+{
+    auto words = juce::StringArray::fromTokens(query.toLowerCase(), true);
+    words.removeEmptyStrings();
+
+    std::vector<const Entry*> results;
+
+    for (const auto& entry : entries)
+    {
+        bool matches = true;
+        for (const auto& word : words)
+        {
+            if (!entry.searchText.contains(word))
+            {
+                matches = false;
+                break;
+            }
+        }
+
+        if (matches)
+            results.push_back(&entry);
+    }
+
+    return results;
+}
+
+std::optional<MidiMappingSet> PresetLibrary::load(const Entry& entry) const
+{
+    auto mappings = MappingSerializer::readFile(directory.getChildFile(entry.fileName));
+    if (!mappings)
+        juce::Logger::writeToLog("Failed to load preset: " + entry.fileName);
+
+    return mappings;
+}
+
+bool PresetLibrary::save(const juce::String& name, const juce::StringArray& tags,
+                         const juce::String& controller, const MidiMappingSet& mappings)
+{
+    auto fileName = juce::File::createLegalFileName(name.trim());
+    if (fileName.isEmpty())
+        return false;
+
+    juce::DynamicObject::Ptr metadata = new juce::DynamicObject();
+    metadata->setProperty("name", name.trim());
+    metadata->setProperty("tags", juce::var(tags));
+    metadata->setProperty("controller", controller);
+
+    auto file = directory.getChildFile(fileName).withFileExtension("json");
+    if (!MappingPersistence::writeMappings(file, mappings, juce::var(metadata)))
+        return false;
+
+    rescan();
+    return true;
+}
+
+PresetLibrary::Entry PresetLibrary::readEntry(const juce::File& file)
+{
+    Entry entry;
+    entry.fileName = file.getFileName();
+    entry.name = file.getFileNameWithoutExtension();
+    entry.size = file.getSize();
+    entry.modificationTime = file.getLastModificationTime().toMilliseconds();
+
+    // Only the metadata at the top of the file is read; the mappings are parsed on load
+    if (auto* obj = MappingSerializer::readMetadataFile(file).getDynamicObject())
+    {
+        if (obj->hasProperty("name"))
+            entry.name = obj->getProperty("name").toString();
+
+        if (auto* tags = obj->getProperty("tags").getArray())
+            for (const auto& tag : *tags)
+                entry.tags.add(tag.toString());
+
+        entry.controller = obj->getProperty("controller").toString();
+    }
+
+    updateSearchText(entry);
+    return entry;
+}
+
+void PresetLibrary::updateSearchText(Entry& entry)
+{
+    entry.searchText = (entry.name + " " + entry.tags.joinIntoString(" ") + " " + entry.controller).toLowerCase();
+}
+
+void PresetLibrary::loadIndex()
+{
+    entries.clear();
+
+    auto* items = juce::JSON::parse(getIndexFile()).getArray();
+    if (items == nullptr)
+        return;
+
+    for (const auto& item : *items)
+    {
+        auto* obj = item.getDynamicObject();
+        if (obj == nullptr)
+            continue;
+
+        Entry entry;
+        entry.fileName = obj->getProperty("file").toString();
+        entry.name = obj->getProperty("name").toString();
+        entry.controller = obj->getProperty("controller").toString();
+        entry.size = static_cast<juce::int64>(obj->getProperty("size"));
+        entry.modificationTime = static_cast<juce::int64>(obj->getProperty("mtime"));
+
+        if (auto* tags = obj->getProperty("tags").getArray())
+            for (const auto& tag : *tags)
+                entry.tags.add(tag.toString());
+
+        updateSearchText(entry);
+        entries.push_back(std::move(entry));
+    }
+}
+
+void PresetLibrary::saveIndex() const
+{
+    juce::Array<juce::var> items;
+
+    for (const auto& entry : entries)
+    {
+        juce::DynamicObject::Ptr obj = new juce::DynamicObject();
+        obj->setProperty("file", entry.fileName);
+        obj->setProperty("name", entry.name);
+        obj->setProperty("tags", juce::var(entry.tags));
+        obj->setProperty("controller", entry.controller);
+        obj->setProperty("size", entry.size);
+        obj->setProperty("mtime", entry.modificationTime);
+        items.add(juce::var(obj));
+    }
+
+    MappingPersistence::writeAtomically(getIndexFile(), juce::JSON::toString(juce::var(items), true));
+}
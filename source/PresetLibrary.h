@@ -0,0 +1,65 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <optional>
+#include <vector>
+#include "MidiMapping.h"
+
+/**
+ * Directory of mapping presets with a persistent index.
+ *
+ * The index (index.json in the library directory) records the name, tags,
+ * controller, size and modification time of every preset.
+ * rescan() only opens files whose size or modification time changed since
+ * they were last indexed, and of those only the metadata at the top is read.
+ * search() only looks at the index, and a preset body is parsed only when it
+ * is actually loaded.
+ */
+class PresetLibrary
+{
+public:
+    struct Entry
+    {
+        juce::String fileName;
+        juce::String name;
+        juce::StringArray tags;
+        juce::String controller;
+        juce::int64 size = 0;
+        juce::int64 modificationTime = 0;
+
+        // Lower-cased name, tags and controller, matched by search()
+        juce::String searchText;
+    };
+
+    explicit PresetLibrary(const juce::File& libraryDirectory);
+
+    // Bring the index in line with the directory, returns true if anything changed
+    bool rescan();
+
+    // Entries whose name, tags or controller contain every word of the query
+    std::vector<const Entry*> search(const juce::String& query) const;
+
+    const std::vector<Entry>& getEntries() const noexcept { return entries; }
+
+    // Parse a single preset body
+    std::optional<MidiMappingSet> load(const Entry& entry) const;
+
+    // Store mappings as a new preset (or replace one with the same name)
+    bool save(const juce::String& name, const juce::StringArray& tags,
+              const juce::String& controller, const MidiMappingSet& mappings);
+
+    juce::File getDirectory() const { return directory; }
+
+private:
+    static Entry readEntry(const juce::File& file);
+    static void updateSearchText(Entry& entry);
+
+    void loadIndex();
+    void saveIndex() const;
+    juce::File getIndexFile() const { return directory.getChildFile("index.json"); }
+
+    juce::File directory;
+    std::vector<Entry> entries;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetLibrary)
+};
@@ -0,0 +1,74 @@
+#include "ScaleQuantiser.h"
+
+std::uint16_t ScaleQuantiser::getScaleMask(Scale scale) noexcept
+{
+    switch (scale)
+    {
+        case Scale::Chromatic:       return 0b1111'1111'1111;
+        case Scale::Major:           return 0b1010'1011'0101;
+        case Scale::Minor:           return 0b0101'1010'1101;
+        case Scale::Dorian:          return 0b0110'1010'1101;
+        case Scale::MajorPentatonic: return 0b0010'1001'0101;
+        case Scale::MinorPentatonic: return 0b0100'1010'1001;
+        case Scale::Blues:           return 0b0100'1110'1001;
+        case Scale::None:            break;
+    }
+
+    return 0;
+}
+
+juce::String ScaleQuantiser::getScaleName(Scale scale)
+{
+    switch (scale)
+    {
+        case Scale::Chromatic:       return "Chromatic";
+        case Scale::Major:           return "Major";
+        case Scale::Minor:           return "Minor";
+        case Scale::Dorian:          return "Dorian";
+        case Scale::MajorPentatonic: return "Major pentatonic";
+        case Scale::MinorPentatonic: return "Minor pentatonic";
+        case Scale::Blues:           return "Blues";
+        case Scale::None:            break;
+    }
+
+    return "None";
+}
+
+void ScaleQuantiser::configure(Scale newScale, int newRoot, int newRange) noexcept
+{
+    newRoot = juce::jlimit(0, 127, newRoot);
+    newRange = juce::jlimit(0, 127, newRange);
+
+    if (newScale == scale && newRoot == root && newRange == range)
+        return;
+
+    scale = newScale;
+    root = newRoot;
+    range = newRange;
+
+    auto mask = getScaleMask(scale);
+    numNotes = 0;
+
+    for (int semitone = 0; semitone <= range && root + semitone <= 127; ++semitone)
+        if ((mask >> (semitone % 12)) & 1)
+            notes[static_cast<size_t>(numNotes++)] = static_cast<std::uint8_t>(root + semitone);
+
+    reset();
+}
+
+int ScaleQuantiser::process(float value) noexcept
+{
+    jassert(isEnabled());
+
+    auto position = juce::jlimit(0.0f, 1.0f, value) * static_cast<float>(numNotes);
+    auto degree = juce::jmin(static_cast<int>(position), numNotes - 1);
+
+    if (currentDegree < 0
+        || position < static_cast<float>(currentDegree) - hysteresis
+        || position > static_cast<float>(currentDegree + 1) + hysteresis)
+    {
+        currentDegree = degree;
+    }
+
+    return notes[static_cast<size_t>(currentDegree)];
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <cstdint>
+#include "MidiMapping.h"
+
+/**
+ * Turns a continuous 0..1 value into notes of a scale.
+ *
+ * The notes of the scale between the root and the top of the range are
+ * precomputed into a table, and the value is split evenly between them, so a
+ * sample costs one multiply and one lookup. The current note only changes
+ * once the value is clearly inside a neighbour, which keeps a control resting
+ * on a boundary from trilling between two notes.
+ */
+class ScaleQuantiser
+{
+public:
+    using Scale = MidiMapping::Scale;
+
+    // Rebuilds the table and restarts when anything changed
+    void configure(Scale newScale, int newRoot, int newRange) noexcept;
+    void configure(const MidiMapping& mapping) noexcept
+    {
+        configure(mapping.scale, mapping.noteNumber, mapping.scaleRange);
+    }
+
+    bool isEnabled() const noexcept { return numNotes > 0; }
+
+    // Note for a value in 0..1
+    int process(float value) noexcept;
+
+    void reset() noexcept { currentDegree = -1; }
+
+    // Bit n is set if the scale contains the note n semitones above its root
+    static std::uint16_t getScaleMask(Scale scale) noexcept;
+    static juce::String getScaleName(Scale scale);
+
+private:
+    Scale scale = Scale::None;
+    int root = -1;
+    int range = 0;
+
+    std::array<std::uint8_t, 128> notes {};
+    int numNotes = 0;
+    int currentDegree = -1;
+
+    static constexpr float hysteresis = 0.3f;  // Fraction of a degree the value has to pass a boundary by
+};
@@ -0,0 +1,78 @@
+#include "SmoothingFilter.h"
+#include <cmath>
+
+void SmoothingFilter::configure(Type newType, float newFrequency, float newBeta) noexcept
+{
+    newFrequency = std::isfinite(newFrequency) && newFrequency > 0.0f ? newFrequency : 1.0f;
+    newBeta = std::isfinite(newBeta) && newBeta > 0.0f ? newBeta : 0.0f;
+
+    if (newType == type && newFrequency == frequency && newBeta == beta)
+        return;
+
+    type = newType;
+    frequency = newFrequency;
+    beta = newBeta;
+    reset();
+}
+
+float SmoothingFilter::smoothingFactor(float cutoff, double deltaSeconds) noexcept
+{
+    auto tau = 1.0 / (2.0 * juce::MathConstants<double>::pi * static_cast<double>(cutoff));
+    return static_cast<float>(1.0 / (1.0 + tau / deltaSeconds));
+}
+
+float SmoothingFilter::process(float value, double timeSeconds) noexcept
+{
+    target = value;
+
+    if (type == Type::None || !primed)
+    {
+        primed = true;
+        lastTime = timeSeconds;
+        output = value;
+        derivative = 0.0f;
+        return output;
+    }
+
+    auto deltaSeconds = timeSeconds - lastTime;
+    if (deltaSeconds <= 0.0)
+        return output;  // Same timestamp, nothing has elapsed
+
+    lastTime = timeSeconds;
+
+    switch (type)
+    {
+        case Type::OneEuro:
+        {
+            // Speed estimate is itself low passed so a single noisy sample cannot open the filter
+            auto rawDerivative = static_cast<float>((value - output) / deltaSeconds);
+            derivative += smoothingFactor(derivativeCutoff, deltaSeconds) * (rawDerivative - derivative);
+
+            auto cutoff = frequency + beta * std::abs(derivative);
+            output += smoothingFactor(cutoff, deltaSeconds) * (value - output);
+            break;
+        }
+
+        case Type::Ema:
+            output += smoothingFactor(frequency, deltaSeconds) * (value - output);
+            break;
+
+        case Type::Slew:
+        {
+            // Values are normalised to 0..1, so frequency is full range travels per second
+            auto maxStep = static_cast<float>(frequency * deltaSeconds);
+            output += juce::jlimit(-maxStep, maxStep, value - output);
+            break;
+        }
+
+        case Type::None:
+            break;
+    }
+
+    return output;
+}
+
+bool SmoothingFilter::isSettling() const noexcept
+{
+    return type != Type::None && primed && std::abs(target - output) > settledDistance;
+}
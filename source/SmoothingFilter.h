@@ -0,0 +1,52 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "MidiMapping.h"
+
+/**
+ * Per-mapping filter for a continuous control, fed every raw sample.
+ *
+ * One-Euro (Casiez et al.) lowers its cutoff while the input is slow, which
+ * removes sensor jitter, and raises it with speed so fast gestures keep
+ * little lag. EMA is a fixed cutoff low pass and slew limits the rate of
+ * change. Time is passed in so the filters adapt to irregular sample rates.
+ */
+class SmoothingFilter
+{
+public:
+    using Type = MidiMapping::Smoothing;
+
+    // Changing any parameter restarts the filter from the next sample
+    void configure(Type newType, float newFrequency, float newBeta) noexcept;
+    void configure(const MidiMapping& mapping) noexcept
+    {
+        configure(mapping.smoothing, mapping.smoothingFrequency, mapping.smoothingBeta);
+    }
+
+    // Filter one sample taken at timeSeconds (monotonic)
+    float process(float value, double timeSeconds) noexcept;
+
+    void reset() noexcept { primed = false; }
+
+    // True while the output still lags a target that has stopped moving
+    bool isSettling() const noexcept;
+
+    bool isEnabled() const noexcept { return type != Type::None; }
+    float getOutput() const noexcept { return output; }
+
+private:
+    static float smoothingFactor(float cutoff, double deltaSeconds) noexcept;
+
+    Type type = Type::None;
+    float frequency = 1.0f;
+    float beta = 0.0f;
+
+    bool primed = false;
+    double lastTime = 0.0;
+    float target = 0.0f;
+    float output = 0.0f;
+    float derivative = 0.0f;
+
+    static constexpr float derivativeCutoff = 1.0f;   // Hz, as recommended for One-Euro
+    static constexpr float settledDistance = 0.001f;  // Below a 7-bit MIDI step
+};
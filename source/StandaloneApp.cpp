@@ -1,5 +1,6 @@
 #include "StandaloneApp.h"
 #include "components/MidiMappingEditorWindow.h"
+#include "TraceRecorder.h"
 
 StandaloneApp::StandaloneApp()
 {
@@ -11,9 +12,13 @@ StandaloneApp::StandaloneApp()
     
     // Try to load saved mappings
     loadMidiMappings();
+    loadTouchpadZones();
+    loadButtonGestures();
+    loadMidiClock();
+    loadMidiFeedback();
     
     // Create single gamepad component
-    gamepadComponent = std::make_unique<ModernGamepadComponent>(gamepadManager.getGamepadState(0), *this);
+    gamepadComponent = std::make_unique<ModernGamepadComponent>(gamepadManager, *this);
     addAndMakeVisible(gamepadComponent.get());  // Make visible immediately
     
     // Create MIDI device selector
@@ -38,16 +43,26 @@ StandaloneApp::StandaloneApp()
     
     // Add gamepad state change callback
     gamepadManager.addStateChangeCallback([this] { handleGamepadStateChange(); });
+    gamepadManager.setMotionGestureCallback([this](int gamepad, int gesture, bool active) { handleMotionGesture(gamepad, gesture, active); });
     
-    // Start timer to update UI (30fps)
-    startTimer(33);
+    // Needed for the trace capture shortcut
+    setWantsKeyboardFocus(true);
     
     setSize(800, 600);
 }
 
 StandaloneApp::~StandaloneApp()
 {
-    stopTimer();
+    PerformanceStats::getInstance().stopPeriodicDump();
+    
+    // The input, like the clock, is a singleton and outlives this component
+    MidiInputManager::getInstance().onMessage = nullptr;
+    feedbackMap.releaseAll();
+    
+    // The clock is a singleton; it must not keep ticking or listening past the app
+    stepSequencer.stop();
+    MidiClock::getInstance().setSource(MidiClock::Source::Internal);
+    MidiClock::getInstance().stop();
     
     // Remove look and feel from button to avoid dangling pointer
     midiMappingButton.setLookAndFeel(nullptr);
@@ -90,133 +105,170 @@ void StandaloneApp::resized()
     gamepadComponent->setBounds(gamepadArea);
 }
 
-void StandaloneApp::timerCallback()
-{
-    // Always update the gamepad component
-    gamepadComponent->updateState(gamepadManager.getGamepadState(0));
-}
-
 void StandaloneApp::handleGamepadStateChange()
 {
+    GAMEPAD_TRACE_SCOPE("StandaloneApp::handleGamepadStateChange");
+    
     const auto& gamepad = gamepadManager.getGamepadState(0);
     if (!gamepad.connected)
+    {
+        // Nothing will ever lift the fingers of a disconnected pad; released
+        // once as it goes, not on every notification while it stays away
+        if (previousGamepadState.connected)
+        {
+            touchpadZones.releaseAll();
+            buttonGestures.releaseAll();
+            mappingEngine.releaseAll();
+            MidiOutputManager::getInstance().releaseAllNotes();
+            previousGamepadState = {};
+        }
+        
+        followUpTimer.stopTimer();
         return;
+    }
+    
+    previousGamepadState.connected = true;
 
     // If in MIDI learn mode, only process UI-triggered changes
     if (gamepadComponent->isMidiLearnMode())
+    {
+        followUpTimer.stopTimer();
         return;
+    }
 
-    // Process axis changes
-    for (int i = 0; i < GamepadManager::MAX_AXES; ++i)
+    // Unfiltered controls only report changes past the threshold; filtered
+    // ones see every sample so they can tell jitter from motion. Sticks and
+    // motion sensors are -1..1 and go out as 0..1 (halving their speed too),
+    // the touchpad already is. Events carry the time SDL sampled the value, so
+    // filters see the real spacing rather than that of the poll that drained it.
+    auto post = [this](InputEvent::Control control, int index, float value, juce::int64 timestamp, float& previousValue,
+                       float threshold, bool bipolar, bool restart = false, float speed = -1.0f)
     {
-        float currentValue = gamepad.axes[i];
-        float previousValue = previousGamepadState.axes[i];
+        if (mappingEngine.isFiltered(control, index))
+            threshold = 0.0f;
         
-        if (std::abs(currentValue - previousValue) > 0.01f)
-        {
-            // Send MIDI CC for each mapping
-            for (const auto& mapping : axisMappings[static_cast<size_t>(i)])
-            {
-                float normalizedValue = (currentValue + 1.0f) * 0.5f; // Convert from [-1,1] to [0,1]
-                float mappedValue = mapping.minValue + (normalizedValue * (mapping.maxValue - mapping.minValue));
-                int midiValue = static_cast<int>(mappedValue);
-                
-                MidiOutputManager::getInstance().sendControlChange(mapping.channel, mapping.ccNumber, midiValue);
-            }
-            
-            previousGamepadState.axes[i] = currentValue;
-        }
-    }
+        if (!restart && std::abs(value - previousValue) <= threshold)
+            return;
+        
+        auto event = InputEvent::make(InputEvent::Source::Hardware, control, index, bipolar ? (value + 1.0f) * 0.5f : value);
+        event.restart = restart;
+        event.speed = bipolar && speed >= 0.0f ? speed * 0.5f : speed;
+        if (timestamp != 0)
+            event.timestamp = timestamp;
+        mappingEngine.post(event);
+        previousValue = value;
+    };
+    
+    auto now = juce::Time::getMillisecondCounterHiRes() * 0.001;
 
-    // Process button changes
-    for (int i = 0; i < GamepadManager::MAX_BUTTONS; ++i)
+    // Process axis changes; their speed sets the velocity of gated notes
+    for (int i = 0; i < GamepadManager::MAX_AXES; ++i)
     {
-        bool currentState = gamepad.buttons[i];
-        bool previousState = previousGamepadState.buttons[i];
-        
-        if (currentState != previousState)
-        {
-            // Send MIDI messages for each mapping
-            for (const auto& mapping : buttonMappings[static_cast<size_t>(i)])
-            {
-                if (mapping.type == MidiMapping::Type::ControlChange)
-                {
-                    int midiValue = currentState ? static_cast<int>(mapping.maxValue) : static_cast<int>(mapping.minValue);
-                    MidiOutputManager::getInstance().sendControlChange(mapping.channel, mapping.ccNumber, midiValue);
-                }
-                else // Note
-                {
-                    // For buttons, we send note on when pressed and note off when released
-                    if (currentState)
-                    {
-                        MidiOutputManager::getInstance().sendNoteOn(mapping.channel, mapping.noteNumber, mapping.maxValue / 127.0f);
-                    }
-                    else
-                    {
-                        // Send note off with zero velocity
-                        MidiOutputManager::getInstance().sendNoteOn(mapping.channel, mapping.noteNumber, 0.0f);
-                    }
-                }
-            }
-            
-            previousGamepadState.buttons[i] = currentState;
-        }
+        post(InputEvent::Control::Axis, i, gamepad.axes[i], gamepad.axisTimestamps[static_cast<size_t>(i)],
+             previousGamepadState.axes[i], 0.01f, true, false, gamepad.axisSpeeds[static_cast<size_t>(i)]);
     }
 
+    // Gestures see every frame; edges they claim are kept from the plain button mappings
+    auto gestureButtons = buttonGestures.process(gamepad.buttons, now);
+    auto sequencerButtons = stepSequencer.process(gamepad.buttons);
+    
+    // Process button changes, visiting only the buttons whose state flipped
+    auto buttonEdges = (gamepad.buttons ^ previousGamepadState.buttons) & ~(gestureButtons | sequencerButtons);
+    GamepadManager::forEachButton(buttonEdges, [&](int i)
+    {
+        auto event = InputEvent::make(InputEvent::Source::Hardware, InputEvent::Control::Button, i,
+                                      gamepad.isButtonDown(i) ? 1.0f : 0.0f);
+        if (auto timestamp = gamepad.buttonTimestamps[static_cast<size_t>(i)]; timestamp != 0)
+            event.timestamp = timestamp;
+        mappingEngine.post(event);
+    });
+    
+    previousGamepadState.buttons = gamepad.buttons;
+
     // Process gyroscope changes
     if (gamepad.gyroscope.enabled)
     {
-        float gyroValues[3] = {gamepad.gyroscope.x, gamepad.gyroscope.y, gamepad.gyroscope.z};
-        float prevGyroValues[3] = {previousGamepadState.gyroscope.x, previousGamepadState.gyroscope.y, previousGamepadState.gyroscope.z};
-        
-        for (int i = 0; i < 3; ++i)
-        {
-            if (std::abs(gyroValues[i] - prevGyroValues[i]) > 0.01f)
-            {
-                // Send MIDI CC for each mapping
-                for (const auto& mapping : gyroMappings[static_cast<size_t>(i)])
-                {
-                    float normalizedValue = (gyroValues[i] + 1.0f) * 0.5f; // Convert from [-1,1] to [0,1]
-                    float mappedValue = mapping.minValue + (normalizedValue * (mapping.maxValue - mapping.minValue));
-                    int midiValue = static_cast<int>(mappedValue);
-                    
-                    MidiOutputManager::getInstance().sendControlChange(mapping.channel, mapping.ccNumber, midiValue);
-                }
-                
-                prevGyroValues[i] = gyroValues[i];
-            }
-        }
-        
-        previousGamepadState.gyroscope.x = gyroValues[0];
-        previousGamepadState.gyroscope.y = gyroValues[1];
-        previousGamepadState.gyroscope.z = gyroValues[2];
+        auto& previousGyro = previousGamepadState.gyroscope;
+        post(InputEvent::Control::Gyro, 0, gamepad.gyroscope.x, gamepad.gyroscope.timestamp, previousGyro.x, 0.01f, true);
+        post(InputEvent::Control::Gyro, 1, gamepad.gyroscope.y, gamepad.gyroscope.timestamp, previousGyro.y, 0.01f, true);
+        post(InputEvent::Control::Gyro, 2, gamepad.gyroscope.z, gamepad.gyroscope.timestamp, previousGyro.z, 0.01f, true);
     }
 
     // Process accelerometer changes
-    float accelValues[3] = {gamepad.accelerometer.x, gamepad.accelerometer.y, gamepad.accelerometer.z};
-    float prevAccelValues[3] = {previousGamepadState.accelerometer.x, previousGamepadState.accelerometer.y, previousGamepadState.accelerometer.z};
+    auto& previousAccel = previousGamepadState.accelerometer;
+    post(InputEvent::Control::Accel, 0, gamepad.accelerometer.x, gamepad.accelerometer.timestamp, previousAccel.x, 0.01f, true);
+    post(InputEvent::Control::Accel, 1, gamepad.accelerometer.y, gamepad.accelerometer.timestamp, previousAccel.y, 0.01f, true);
+    post(InputEvent::Control::Accel, 2, gamepad.accelerometer.z, gamepad.accelerometer.timestamp, previousAccel.z, 0.01f, true);
+    
+    // Process touchpad changes; motion arrives once per SDL touchpad event
+    const auto& touchpad = gamepad.touchpad;
+    auto& previousTouchpad = previousGamepadState.touchpad;
+    
+    // Position only means something while a finger is down, and a new touch
+    // jumps to where the finger landed rather than gliding there
+    if (touchpad.touched)
+    {
+        bool newTouch = !previousTouchpad.touched;
+        post(InputEvent::Control::Touchpad, TouchpadControl::X, touchpad.x, touchpad.timestamp, previousTouchpad.x, 0.005f, false, newTouch);
+        post(InputEvent::Control::Touchpad, TouchpadControl::Y, touchpad.y, touchpad.timestamp, previousTouchpad.y, 0.005f, false, newTouch);
+    }
+    else if (previousTouchpad.touched)
+    {
+        mappingEngine.releaseControl(InputEvent::Control::Touchpad, TouchpadControl::X);
+        mappingEngine.releaseControl(InputEvent::Control::Touchpad, TouchpadControl::Y);
+    }
     
-    for (int i = 0; i < 3; ++i)
+    post(InputEvent::Control::Touchpad, TouchpadControl::Pressure, touchpad.touched ? touchpad.pressure : 0.0f,
+         touchpad.timestamp, previousTouchpad.pressure, 0.005f, false);
+    previousTouchpad.touched = touchpad.touched;
+    
+    if (touchpad.pressed != previousTouchpad.pressed)
+    {
+        mappingEngine.post(InputEvent::make(InputEvent::Source::Hardware, InputEvent::Control::Touchpad,
+                                            TouchpadControl::Button, touchpad.pressed ? 1.0f : 0.0f));
+        previousTouchpad.pressed = touchpad.pressed;
+    }
+    
+    // Every finger plays the zone grid independently
+    if (touchpadZones.isEnabled())
     {
-        if (std::abs(accelValues[i] - prevAccelValues[i]) > 0.01f)
+        for (int f = 0; f < GamepadManager::MAX_TOUCHPAD_FINGERS; ++f)
         {
-            // Send MIDI CC for each mapping
-            for (const auto& mapping : accelerometerMappings[static_cast<size_t>(i)])
-            {
-                float normalizedValue = (accelValues[i] + 1.0f) * 0.5f; // Convert from [-1,1] to [0,1]
-                float mappedValue = mapping.minValue + (normalizedValue * (mapping.maxValue - mapping.minValue));
-                int midiValue = static_cast<int>(mappedValue);
-                
-                MidiOutputManager::getInstance().sendControlChange(mapping.channel, mapping.ccNumber, midiValue);
-            }
-            
-            prevAccelValues[i] = accelValues[i];
+            const auto& finger = touchpad.fingers[static_cast<size_t>(f)];
+            touchpadZones.updateFinger(f, finger.down, finger.x, finger.y, finger.pressure);
         }
     }
     
-    previousGamepadState.accelerometer.x = accelValues[0];
-    previousGamepadState.accelerometer.y = accelValues[1];
-    previousGamepadState.accelerometer.z = accelValues[2];
+    // Filtered outputs keep moving towards a held input until they arrive, and
+    // long presses and double taps resolve even when nothing else happens
+    bool filtersSettling = mappingEngine.advanceFilters();
+    if (!filtersSettling && !buttonGestures.isWaiting())
+        followUpTimer.stopTimer();
+    else if (!followUpTimer.isTimerRunning())
+        followUpTimer.startTimer(followUpIntervalMs);
+}
+
+void StandaloneApp::handleMotionGesture(int gamepad, int gesture, bool active)
+{
+    // Like the other controls, only the first gamepad plays
+    if (gamepad != 0)
+        return;
+
+    // Gestures cannot be clicked on screen, so in MIDI learn mode performing one picks it
+    if (gamepadComponent != nullptr && gamepadComponent->isMidiLearnMode())
+    {
+        if (active)
+            notifyGamepadControlActivated("Motion", gesture);
+        return;
+    }
+
+    mappingEngine.post(InputEvent::make(InputEvent::Source::Hardware, InputEvent::Control::Motion, gesture, active ? 1.0f : 0.0f));
+}
+
+void StandaloneApp::updateSampleThreshold()
+{
+    // Filters need the raw sample stream; without them the coarser threshold saves work
+    gamepadManager.setSampleThreshold(mappingEngine.hasFilters() ? 0.0f : 0.01f);
 }
 
 void StandaloneApp::setupMidiMappings()
@@ -353,6 +405,40 @@ void StandaloneApp::setupMidiMappings()
         
         accelerometerMappings[i].push_back(accelMapping);
     }
+
+    // Initialize touchpad mappings (X, Y, Pressure, Button)
+    for (int i = 0; i < TouchpadControl::count; ++i)
+    {
+        touchpadMappings[static_cast<size_t>(i)].clear();
+        
+        MidiMapping touchpadMapping;
+        touchpadMapping.type = MidiMapping::Type::ControlChange;
+        touchpadMapping.channel = 1;
+        touchpadMapping.ccNumber = MidiCC::TOUCHPAD_X + i;  // TOUCHPAD_X, _Y, _PRESSURE, _BUTTON
+        touchpadMapping.noteNumber = 0;
+        touchpadMapping.minValue = 0;
+        touchpadMapping.maxValue = 127;
+        touchpadMapping.isButton = i == TouchpadControl::Button;
+        
+        touchpadMappings[static_cast<size_t>(i)].push_back(touchpadMapping);
+    }
+
+    // Initialize motion gesture mappings, on while the gesture lasts
+    for (int i = 0; i < MotionGesture::count; ++i)
+    {
+        motionMappings[static_cast<size_t>(i)].clear();
+        
+        MidiMapping motionMapping;
+        motionMapping.type = MidiMapping::Type::ControlChange;
+        motionMapping.channel = 1;
+        motionMapping.ccNumber = MidiCC::MOTION_SHAKE + i;  // Shake, flicks L/R/U/D, tilt-snaps L/R
+        motionMapping.noteNumber = 0;
+        motionMapping.minValue = 0;
+        motionMapping.maxValue = 127;
+        motionMapping.isButton = true;
+        
+        motionMappings[static_cast<size_t>(i)].push_back(motionMapping);
+    }
 }
 
 void StandaloneApp::handleLogoClick()
@@ -382,6 +468,90 @@ void StandaloneApp::mouseUp(const juce::MouseEvent& event)
     }
 }
 
+bool StandaloneApp::keyPressed(const juce::KeyPress& key)
+{
+    // Cmd/Ctrl+Shift+T starts a trace capture, pressing it again writes it to the desktop
+    if (key.getKeyCode() == 'T'
+        && key.getModifiers().isCommandDown()
+        && key.getModifiers().isShiftDown())
+    {
+        toggleTraceCapture();
+        return true;
+    }
+    
+    // Cmd/Ctrl+Shift+D starts or stops appending pipeline stats to a JSON lines file
+    if (key.getKeyCode() == 'D'
+        && key.getModifiers().isCommandDown()
+        && key.getModifiers().isShiftDown())
+    {
+        toggleStatsDump();
+        return true;
+    }
+    
+    // Cmd/Ctrl+Shift+P silences every note, e.g. after another app left one hanging
+    if (key.getKeyCode() == 'P'
+        && key.getModifiers().isCommandDown()
+        && key.getModifiers().isShiftDown())
+    {
+        MidiOutputManager::getInstance().panic();
+        return true;
+    }
+    
+    // Cmd/Ctrl+Shift+S hands the D-pad and face buttons to the step sequencer and back
+    if (key.getKeyCode() == 'S'
+        && key.getModifiers().isCommandDown()
+        && key.getModifiers().isShiftDown())
+    {
+        stepSequencer.setEditing(!stepSequencer.isEditing());
+        return true;
+    }
+    
+    // Cmd/Ctrl+1..4 arms a loop lane, then stops and clears it
+    if (key.getModifiers().isCommandDown()
+        && !key.getModifiers().isShiftDown()
+        && key.getKeyCode() >= '1' && key.getKeyCode() < '1' + CcLooper::numLanes)
+    {
+        mappingEngine.getLooper().toggleLane(key.getKeyCode() - '1');
+        return true;
+    }
+    
+    return false;
+}
+
+void StandaloneApp::toggleTraceCapture()
+{
+    auto& recorder = TraceRecorder::getInstance();
+    
+    if (!recorder.isEnabled())
+    {
+        recorder.clear();
+        recorder.setEnabled(true);
+        juce::Logger::writeToLog("Trace capture started");
+        return;
+    }
+    
+    recorder.setEnabled(false);
+    
+    auto file = juce::File::getSpecialLocation(juce::File::userDesktopDirectory)
+        .getChildFile("GamepadMIDI_trace_" + juce::Time::getCurrentTime().formatted("%Y%m%d_%H%M%S") + ".json");
+    recorder.dumpToFile(file);
+}
+
+void StandaloneApp::toggleStatsDump()
+{
+    auto& stats = PerformanceStats::getInstance();
+    
+    if (stats.isDumping())
+    {
+        stats.stopPeriodicDump();
+        juce::Logger::writeToLog("Performance stats dump stopped");
+        return;
+    }
+    
+    // Machine-readable pipeline stats, one JSON object per line every second
+    stats.startPeriodicDump(getMidiMappingsFile().getSiblingFile("performance_stats.jsonl"), 1000);
+}
+
 void StandaloneApp::notifyGamepadControlActivated(const juce::String& controlType, int controlIndex)
 {
     if (auto* window = MidiMappingEditorWindow::getExistingInstance())
@@ -395,233 +565,174 @@ void StandaloneApp::notifyGamepadControlActivated(const juce::String& controlTyp
     }
 }
 
-juce::File StandaloneApp::getMidiMappingsFile() const
+void StandaloneApp::loadTouchpadZones()
 {
-    // Get the application data directory
-    juce::File appDataDir = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
-        .getChildFile("PoundingSystems")
-        .getChildFile("Gamepad");
+    auto file = getMidiMappingsFile().getSiblingFile("touchpad_zones.json");
     
-    // Create the directory if it doesn't exist
-    if (!appDataDir.exists())
-        appDataDir.createDirectory();
+    // Write the (disabled) default grid once so there is something to edit
+    if (!file.existsAsFile())
+    {
+        MappingPersistence::writeAtomically(file, juce::JSON::toString(touchpadZones.toVar()));
+        return;
+    }
     
-    // Return the mappings file
-    return appDataDir.getChildFile("midi_mappings.json");
+    if (!touchpadZones.fromVar(juce::JSON::parse(file)))
+        juce::Logger::writeToLog("Invalid touchpad zone file: " + file.getFullPathName());
 }
 
-void StandaloneApp::saveMidiMappings()
+void StandaloneApp::loadButtonGestures()
 {
-    juce::File file = getMidiMappingsFile();
+    auto file = getMidiMappingsFile().getSiblingFile("button_gestures.json");
     
-    juce::DynamicObject::Ptr jsonObj = new juce::DynamicObject();
+    // Write the (disabled) example rules once so there is something to edit
+    if (!file.existsAsFile())
+    {
+        MappingPersistence::writeAtomically(file, juce::JSON::toString(buttonGestures.toVar()));
+        return;
+    }
     
-    // Convert mapping data to JSON
-    juce::Array<juce::var> mappingsArray;
+    if (!buttonGestures.fromVar(juce::JSON::parse(file)))
+        juce::Logger::writeToLog("Invalid button gesture file: " + file.getFullPathName());
+}
+
+void StandaloneApp::loadMidiClock()
+{
+    auto file = getMidiMappingsFile().getSiblingFile("midi_clock.json");
+    auto& clock = MidiClock::getInstance();
     
-    // Save axis mappings
-    for (size_t i = 0; i < axisMappings.size(); ++i)
+    // Stopped, silent and not quantising until someone edits the file
+    if (!file.existsAsFile())
     {
-        if (!axisMappings[i].empty())
-        {
-            juce::DynamicObject::Ptr mappingObj = new juce::DynamicObject();
-            mappingObj->setProperty("controlType", "Axis");
-            mappingObj->setProperty("controlIndex", static_cast<int>(i));
-            
-            juce::Array<juce::var> midiMappingsArray;
-            for (const auto& mapping : axisMappings[i])
-            {
-                juce::DynamicObject::Ptr midiMappingObj = new juce::DynamicObject();
-                midiMappingObj->setProperty("type", static_cast<int>(mapping.type));
-                midiMappingObj->setProperty("channel", mapping.channel);
-                midiMappingObj->setProperty("ccNumber", mapping.ccNumber);
-                midiMappingObj->setProperty("noteNumber", mapping.noteNumber);
-                midiMappingObj->setProperty("minValue", mapping.minValue);
-                midiMappingObj->setProperty("maxValue", mapping.maxValue);
-                midiMappingObj->setProperty("isButton", mapping.isButton);
-                midiMappingsArray.add(juce::var(midiMappingObj));
-            }
-            mappingObj->setProperty("mappings", midiMappingsArray);
-            mappingsArray.add(juce::var(mappingObj));
-        }
+        MappingPersistence::writeAtomically(file, juce::JSON::toString(clock.toVar()));
+        return;
     }
     
-    // Save button mappings
-    for (size_t i = 0; i < buttonMappings.size(); ++i)
+    if (!clock.fromVar(juce::JSON::parse(file)))
+        juce::Logger::writeToLog("Invalid MIDI clock file: " + file.getFullPathName());
+}
+
+void StandaloneApp::loadMidiFeedback()
+{
+    auto file = getMidiMappingsFile().getSiblingFile("midi_feedback.json");
+    
+    // Incoming MIDI is routed either way, so enabling the rules is all it takes
+    MidiInputManager::getInstance().onMessage = [this](const MidiInputManager::Message& message)
     {
-        if (!buttonMappings[i].empty())
-        {
-            juce::DynamicObject::Ptr mappingObj = new juce::DynamicObject();
-            mappingObj->setProperty("controlType", "Button");
-            mappingObj->setProperty("controlIndex", static_cast<int>(i));
-            
-            juce::Array<juce::var> midiMappingsArray;
-            for (const auto& mapping : buttonMappings[i])
-            {
-                juce::DynamicObject::Ptr midiMappingObj = new juce::DynamicObject();
-                midiMappingObj->setProperty("type", static_cast<int>(mapping.type));
-                midiMappingObj->setProperty("channel", mapping.channel);
-                midiMappingObj->setProperty("ccNumber", mapping.ccNumber);
-                midiMappingObj->setProperty("noteNumber", mapping.noteNumber);
-                midiMappingObj->setProperty("minValue", mapping.minValue);
-                midiMappingObj->setProperty("maxValue", mapping.maxValue);
-                midiMappingObj->setProperty("isButton", mapping.isButton);
-                midiMappingsArray.add(juce::var(midiMappingObj));
-            }
-            mappingObj->setProperty("mappings", midiMappingsArray);
-            mappingsArray.add(juce::var(mappingObj));
-        }
+        feedbackMap.handleMessage(message);
+    };
+    
+    // Write the (disabled) example rules once so there is something to edit;
+    // besides the virtual input, one more input can be named
+    if (!file.existsAsFile())
+    {
+        auto state = feedbackMap.toVar();
+        state.getDynamicObject()->setProperty("inputDevice", juce::String());
+        MappingPersistence::writeAtomically(file, juce::JSON::toString(state));
+        return;
     }
     
-    // Save gyro mappings
-    for (size_t i = 0; i < gyroMappings.size(); ++i)
+    auto state = juce::JSON::parse(file);
+    if (!feedbackMap.fromVar(state))
     {
-        if (!gyroMappings[i].empty())
-        {
-            juce::DynamicObject::Ptr mappingObj = new juce::DynamicObject();
-            mappingObj->setProperty("controlType", "Gyro");
-            mappingObj->setProperty("controlIndex", static_cast<int>(i));
-            
-            juce::Array<juce::var> midiMappingsArray;
-            for (const auto& mapping : gyroMappings[i])
-            {
-                juce::DynamicObject::Ptr midiMappingObj = new juce::DynamicObject();
-                midiMappingObj->setProperty("type", static_cast<int>(mapping.type));
-                midiMappingObj->setProperty("channel", mapping.channel);
-                midiMappingObj->setProperty("ccNumber", mapping.ccNumber);
-                midiMappingObj->setProperty("noteNumber", mapping.noteNumber);
-                midiMappingObj->setProperty("minValue", mapping.minValue);
-                midiMappingObj->setProperty("maxValue", mapping.maxValue);
-                midiMappingObj->setProperty("isButton", mapping.isButton);
-                midiMappingsArray.add(juce::var(midiMappingObj));
-            }
-            mappingObj->setProperty("mappings", midiMappingsArray);
-            mappingsArray.add(juce::var(mappingObj));
-        }
+        juce::Logger::writeToLog("Invalid MIDI feedback file: " + file.getFullPathName());
+        return;
     }
     
-    // Save accelerometer mappings
-    for (size_t i = 0; i < accelerometerMappings.size(); ++i)
+    auto inputName = state.getProperty("inputDevice", {}).toString();
+    if (inputName.isEmpty())
+        return;
+    
+    auto& midiInput = MidiInputManager::getInstance();
+    for (const auto& device : midiInput.getAvailableDevices())
     {
-        if (!accelerometerMappings[i].empty())
+        if (device.name == inputName)
         {
-            juce::DynamicObject::Ptr mappingObj = new juce::DynamicObject();
-            mappingObj->setProperty("controlType", "Accel");
-            mappingObj->setProperty("controlIndex", static_cast<int>(i));
-            
-            juce::Array<juce::var> midiMappingsArray;
-            for (const auto& mapping : accelerometerMappings[i])
-            {
-                juce::DynamicObject::Ptr midiMappingObj = new juce::DynamicObject();
-                midiMappingObj->setProperty("type", static_cast<int>(mapping.type));
-                midiMappingObj->setProperty("channel", mapping.channel);
-                midiMappingObj->setProperty("ccNumber", mapping.ccNumber);
-                midiMappingObj->setProperty("noteNumber", mapping.noteNumber);
-                midiMappingObj->setProperty("minValue", mapping.minValue);
-                midiMappingObj->setProperty("maxValue", mapping.maxValue);
-                midiMappingObj->setProperty("isButton", mapping.isButton);
-                midiMappingsArray.add(juce::var(midiMappingObj));
-            }
-            mappingObj->setProperty("mappings", midiMappingsArray);
-            mappingsArray.add(juce::var(mappingObj));
+            midiInput.openDevice(device.identifier);
+            return;
         }
     }
     
-    jsonObj->setProperty("mappings", mappingsArray);
+    juce::Logger::writeToLog("MIDI feedback input not found: " + inputName);
+}
+
+juce::File StandaloneApp::getMidiMappingsFile() const
+{
+    // Get the application data directory
+    juce::File appDataDir = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("PoundingSystems")
+        .getChildFile("Gamepad");
     
-    // Convert to JSON string with proper formatting
-    juce::String jsonString = juce::JSON::toString(juce::var(jsonObj), true);
+    // Create the directory if it doesn't exist
+    if (!appDataDir.exists())
+        appDataDir.createDirectory();
     
-    // Write to file
-    file.replaceWithText(jsonString);
+    // Return the mappings file
+    return appDataDir.getChildFile("midi_mappings.json");
+}
+
+PresetLibrary& StandaloneApp::getPresetLibrary()
+{
+    if (presetLibrary == nullptr)
+        presetLibrary = std::make_unique<PresetLibrary>(getMidiMappingsFile().getSiblingFile("Presets"));
+    
+    return *presetLibrary;
+}
+
+juce::String StandaloneApp::getControllerName() const
+{
+    const auto& gamepad = gamepadManager.getGamepadState(0);
+    return gamepad.connected ? gamepad.name : juce::String();
+}
+
+MidiMappingSet StandaloneApp::getMappingSet() const
+{
+    MidiMappingSet mappings;
+    mappings.axisMappings = axisMappings;
+    mappings.buttonMappings = buttonMappings;
+    mappings.gyroMappings = gyroMappings;
+    mappings.accelerometerMappings = accelerometerMappings;
+    mappings.touchpadMappings = touchpadMappings;
+    mappings.motionMappings = motionMappings;
+    return mappings;
+}
+
+void StandaloneApp::saveMidiMappings()
+{
+    // Serialising and writing happen on the persistence thread so edits never wait on the disk
+    mappingPersistence.scheduleSave(getMappingSet());
 }
 
 void StandaloneApp::loadMidiMappings()
 {
-    juce::File file = getMidiMappingsFile();
+    // The only place the mappings are compiled on start; a current binary
+    // cache is used in place as the engine's table
+    if (auto mappings = MappingPersistence::loadMappings(getMidiMappingsFile(), mappingEngine))
+        applyMappingSet(*mappings);
+    else
+        mappingEngine.compile(getMappingSet());   // The defaults
+    
+    mappingsCompiled();
+}
+
+void StandaloneApp::mappingsCompiled()
+{
+    updateSampleThreshold();
     
-    if (!file.existsAsFile())
-        return;
-        
-    juce::var json = juce::JSON::parse(file);
-    if (json.isVoid())
-        return;
-        
-    if (auto* obj = json.getDynamicObject())
-    {
-        if (auto* mappingsVar = obj->getProperty("mappings").getArray())
-        {
-            // Clear existing mappings
-            for (auto& mappings : axisMappings) mappings.clear();
-            for (auto& mappings : buttonMappings) mappings.clear();
-            for (auto& mappings : gyroMappings) mappings.clear();
-            for (auto& mappings : accelerometerMappings) mappings.clear();
-            
-            // Load mappings
-            for (const auto& mappingVar : *mappingsVar)
-            {
-                if (auto* mappingObj = mappingVar.getDynamicObject())
-                {
-                    juce::String controlType = mappingObj->getProperty("controlType").toString();
-                    int controlIndex = mappingObj->getProperty("controlIndex");
-                    
-                    if (auto* midiMappingsVar = mappingObj->getProperty("mappings").getArray())
-                    {
-                        std::vector<MidiMapping> mappings;
-                        
-                        for (const auto& midiMappingVar : *midiMappingsVar)
-                        {
-                            if (auto* midiMappingObj = midiMappingVar.getDynamicObject())
-                            {
-                                MidiMapping mapping;
-                                
-                                if (midiMappingObj->hasProperty("type"))
-                                {
-                                    mapping.type = static_cast<MidiMapping::Type>(
-                                        midiMappingObj->getProperty("type").operator int());
-                                }
-                                else
-                                {
-                                    mapping.type = MidiMapping::Type::ControlChange;
-                                }
-                                
-                                mapping.channel = midiMappingObj->getProperty("channel");
-                                mapping.ccNumber = midiMappingObj->getProperty("ccNumber");
-                                mapping.noteNumber = midiMappingObj->hasProperty("noteNumber") ? 
-                                    static_cast<int>(midiMappingObj->getProperty("noteNumber")) : 0;
-                                mapping.minValue = midiMappingObj->getProperty("minValue");
-                                mapping.maxValue = midiMappingObj->getProperty("maxValue");
-                                mapping.isButton = midiMappingObj->getProperty("isButton");
-                                
-                                mappings.push_back(mapping);
-                            }
-                        }
-                        
-                        // Store the mappings in the appropriate array
-                        if (controlType == "Axis" && controlIndex >= 0 && controlIndex < GamepadManager::MAX_AXES)
-                        {
-                            axisMappings[static_cast<size_t>(controlIndex)] = mappings;
-                        }
-                        else if (controlType == "Button" && controlIndex >= 0 && controlIndex < GamepadManager::MAX_BUTTONS)
-                        {
-                            buttonMappings[static_cast<size_t>(controlIndex)] = mappings;
-                        }
-                        else if (controlType == "Gyro" && controlIndex >= 0 && controlIndex < 3)
-                        {
-                            gyroMappings[static_cast<size_t>(controlIndex)] = mappings;
-                        }
-                        else if (controlType == "Accel" && controlIndex >= 0 && controlIndex < 3)
-                        {
-                            accelerometerMappings[static_cast<size_t>(controlIndex)] = mappings;
-                        }
-                    }
-                }
-            }
-            
-            // Update the gamepad component
-            updateMidiMappings();
-        }
-    }
+    // A note released after this would look up its note off in the new mappings
+    MidiOutputManager::getInstance().releaseAllNotes();
+    
+    if (gamepadComponent)
+        gamepadComponent->midiMappingsChanged();
+}
+
+void StandaloneApp::applyMappingSet(const MidiMappingSet& mappings)
+{
+    axisMappings = mappings.axisMappings;
+    buttonMappings = mappings.buttonMappings;
+    gyroMappings = mappings.gyroMappings;
+    accelerometerMappings = mappings.accelerometerMappings;
+    touchpadMappings = mappings.touchpadMappings;
+    motionMappings = mappings.motionMappings;
 }
 
 void StandaloneApp::resetMidiMappingsToDefaults()
@@ -631,6 +742,8 @@ void StandaloneApp::resetMidiMappingsToDefaults()
     for (auto& mappings : buttonMappings) mappings.clear();
     for (auto& mappings : gyroMappings) mappings.clear();
     for (auto& mappings : accelerometerMappings) mappings.clear();
+    for (auto& mappings : touchpadMappings) mappings.clear();
+    for (auto& mappings : motionMappings) mappings.clear();
     
     // Set up default mappings
     setupMidiMappings();
@@ -4,17 +4,27 @@
 #include <juce_core/juce_core.h>
 #include "GamepadManager.h"
 #include "MidiOutputManager.h"
+#include "PerformanceStats.h"
 #include "components/ModernGamepadComponent.h"
 #include "components/MidiDeviceSelector.h"
 #include "components/ModernLookAndFeel.h"
 #include "BinaryData.h"
 #include "MidiCCMapping.h"
+#include "MidiMapping.h"
+#include "MappingPersistence.h"
+#include "PresetLibrary.h"
+#include "TouchpadZoneMap.h"
+#include "MappingEngine.h"
+#include "ButtonGestureMap.h"
+#include "MidiClock.h"
+#include "StepSequencer.h"
+#include "FeedbackMap.h"
+#include "MidiInputManager.h"
 
 // Forward declarations
 class MidiMappingEditorWindow;
 
 class StandaloneApp : public juce::Component,
-                      private juce::Timer,
                       private juce::Button::Listener
 {
 public:
@@ -25,37 +35,30 @@ public:
     void resized() override;
     
     // MIDI mapping configuration
-    struct MidiMapping {
-        enum class Type {
-            ControlChange,
-            Note
-        };
-        
-        Type type = Type::ControlChange;
-        int channel;
-        int ccNumber;  // For CC messages
-        int noteNumber;  // For Note messages
-        float minValue;
-        float maxValue;
-        bool isButton;
-    };
+    using MidiMapping = ::MidiMapping;
     
     // Access to mappings for the editor
     std::array<std::vector<MidiMapping>, GamepadManager::MAX_AXES> axisMappings;
     std::array<std::vector<MidiMapping>, GamepadManager::MAX_BUTTONS> buttonMappings;
     std::array<std::vector<MidiMapping>, 3> gyroMappings;  // X, Y, Z
     std::array<std::vector<MidiMapping>, 3> accelerometerMappings;  // X, Y, Z
+    std::array<std::vector<MidiMapping>, TouchpadControl::count> touchpadMappings;  // X, Y, Pressure, Button
+    std::array<std::vector<MidiMapping>, MotionGesture::count> motionMappings;  // Shake, flicks, tilt-snaps
     
     void updateMidiMappings()
     {
-        if (gamepadComponent)
-            gamepadComponent->midiMappingsChanged();
+        mappingEngine.compile(getMappingSet());
+        mappingsCompiled();
     }
     
     // Notify the MIDI editor window when a gamepad control is activated
     void notifyGamepadControlActivated(const juce::String& controlType, int controlIndex);
     
-    // Save and load MIDI mappings
+    // Copy of the current mappings, e.g. for persistence
+    MidiMappingSet getMappingSet() const;
+    void applyMappingSet(const MidiMappingSet& mappings);
+    
+    // Save (debounced, on a background thread) and load MIDI mappings
     void saveMidiMappings();
     void loadMidiMappings();
     void resetMidiMappingsToDefaults();
@@ -63,6 +66,18 @@ public:
     // Get the path to the mappings file
     juce::File getMidiMappingsFile() const;
     
+    // Preset library next to the mappings file, indexed on first use
+    PresetLibrary& getPresetLibrary();
+    
+    // Name of the connected controller, empty when none is connected
+    juce::String getControllerName() const;
+    
+    // Turns input from the gamepad and the on-screen controls into MIDI
+    MappingEngine& getMappingEngine() noexcept { return mappingEngine; }
+    
+    // Programmed and played from the D-pad and face buttons while editing
+    StepSequencer& getStepSequencer() noexcept { return stepSequencer; }
+    
 private:
     // About window component
     class AboutWindow : public juce::DialogWindow
@@ -110,17 +125,26 @@ private:
     };
     
     void handleLogoClick();
-    void timerCallback() override;
     void handleGamepadStateChange();
+    void handleMotionGesture(int gamepad, int gesture, bool active);
+    void updateSampleThreshold();
+    void mappingsCompiled();
     void setupMidiMappings();
+    void loadTouchpadZones();
+    void loadButtonGestures();
+    void loadMidiClock();
+    void loadMidiFeedback();
     void mouseUp(const juce::MouseEvent& event) override;
+    bool keyPressed(const juce::KeyPress& key) override;
+    void toggleTraceCapture();
+    void toggleStatsDump();
     void openMidiMappingEditor();
     void buttonClicked(juce::Button* button) override;
     
     // State tracking for single gamepad
     struct GamepadState {
         float axes[GamepadManager::MAX_AXES] = {};
-        bool buttons[GamepadManager::MAX_BUTTONS] = {};
+        GamepadManager::ButtonMask buttons = 0;
         bool connected = false;
         struct TouchpadState {
             bool touched = false;
@@ -143,6 +167,22 @@ private:
     };
     GamepadState previousGamepadState;
     
+    // Compiled mappings, smoothing state and the input queue every source posts to
+    MappingEngine mappingEngine;
+    
+    // Keeps frames coming while filters converge or gestures wait on a timeout
+    juce::TimedCallback followUpTimer { [this] { handleGamepadStateChange(); } };
+    static constexpr int followUpIntervalMs = 10;
+    
+    // Optional note/CC grid played per finger on the touchpad
+    TouchpadZoneMap touchpadZones;
+    
+    // Optional layers, chords, double taps and long presses on the buttons
+    ButtonGestureMap buttonGestures;
+    
+    // 16 steps on the MIDI clock; takes over the D-pad and face buttons while editing
+    StepSequencer stepSequencer;
+    
     // UI Components
     std::unique_ptr<ModernGamepadComponent> gamepadComponent;
     std::unique_ptr<MidiDeviceSelector> midiDeviceSelector;
@@ -155,5 +195,10 @@ private:
     // Managers
     GamepadManager gamepadManager;
     
+    // Rumble and lightbar driven by MIDI sent back to the app
+    FeedbackMap feedbackMap { gamepadManager };
+    MappingPersistence mappingPersistence { getMidiMappingsFile() };
+    std::unique_ptr<PresetLibrary> presetLibrary;
+    
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StandaloneApp)
 }; 
\ No newline at end of file
@@ -0,0 +1,203 @@
+#include "StepSequencer.h"
+#include "MidiClock.h"
+#include "MidiOutputManager.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    enum SequencerButton
+    {
+        toggleButton = 0,       // A
+        ccButton = 1,           // B
+        transportButton = 2,    // X
+        clearButton = 3,        // Y
+        noteUpButton = 11,
+        noteDownButton = 12,
+        cursorLeftButton = 13,
+        cursorRightButton = 14
+    };
+
+    constexpr StepSequencer::ButtonMask bit(int button) noexcept
+    {
+        return StepSequencer::ButtonMask { 1 } << button;
+    }
+
+    constexpr auto sequencerButtons = bit(toggleButton) | bit(ccButton) | bit(transportButton) | bit(clearButton)
+                                    | bit(noteUpButton) | bit(noteDownButton) | bit(cursorLeftButton) | bit(cursorRightButton);
+
+    // B steps a CC through off and five levels
+    constexpr std::array<std::int8_t, 6> ccLevels { -1, 0, 32, 64, 96, 127 };
+}
+
+StepSequencer::StepSequencer()
+{
+    snapshots.publish(editPattern);
+}
+
+StepSequencer::~StepSequencer()
+{
+    stopTimer();
+}
+
+void StepSequencer::setEditing(bool shouldEdit)
+{
+    editing = shouldEdit;
+    juce::Logger::writeToLog(editing ? "Step sequencer editing on" : "Step sequencer editing off");
+}
+
+StepSequencer::ButtonMask StepSequencer::process(ButtonMask held)
+{
+    auto changed = held ^ previousHeld;
+    auto pressed = changed & held;
+    previousHeld = held;
+
+    if (editing)
+    {
+        GamepadManager::forEachButton(pressed & sequencerButtons, [this](int button)
+        {
+            auto& step = editPattern.steps[static_cast<size_t>(cursor)];
+
+            switch (button)
+            {
+                case toggleButton:
+                    step.active = !step.active;
+                    break;
+
+                case ccButton:
+                {
+                    auto level = std::find(ccLevels.begin(), ccLevels.end(), step.ccValue);
+                    step.ccValue = (level == ccLevels.end() || std::next(level) == ccLevels.end()) ? ccLevels.front() : *std::next(level);
+                    break;
+                }
+
+                case transportButton:
+                    playing ? stop() : start();
+                    return;
+
+                case clearButton:
+                    editPattern.steps = {};
+                    break;
+
+                case noteUpButton:
+                case noteDownButton:
+                    step.note = static_cast<std::uint8_t>(juce::jlimit(0, 127, step.note + (button == noteUpButton ? 1 : -1)));
+                    break;
+
+                case cursorLeftButton:
+                case cursorRightButton:
+                    moveCursor(button == cursorRightButton ? 1 : -1);
+                    return;
+
+                default:
+                    return;
+            }
+
+            snapshots.publish(editPattern);
+        });
+
+        ownedButtons |= pressed & sequencerButtons;
+    }
+
+    // A button pressed for the sequencer is released for it too, even if editing stopped meanwhile
+    auto claimed = changed & ownedButtons;
+    ownedButtons &= held;
+    return claimed;
+}
+
+void StepSequencer::setPattern(const Pattern& newPattern)
+{
+    editPattern = newPattern;
+    snapshots.publish(editPattern);
+}
+
+void StepSequencer::toggleStep(int step)
+{
+    if (!juce::isPositiveAndBelow(step, numSteps))
+        return;
+
+    auto& target = editPattern.steps[static_cast<size_t>(step)];
+    target.active = !target.active;
+    cursor = step;
+    snapshots.publish(editPattern);
+}
+
+void StepSequencer::moveCursor(int delta)
+{
+    cursor = (cursor + delta + numSteps) % numSteps;
+}
+
+void StepSequencer::start()
+{
+    if (playing)
+        return;
+
+    // Playing needs a clock; the internal one is started if nothing drives it
+    auto& clock = MidiClock::getInstance();
+    if (!clock.isRunning() && clock.getSource() == MidiClock::Source::Internal)
+        clock.start();
+
+    playing = true;
+    anchored = false;
+    timerCallback();
+    startTimer(timerIntervalMs);
+}
+
+void StepSequencer::stop()
+{
+    stopTimer();
+    playing = false;
+    playStep.store(-1, std::memory_order_relaxed);
+}
+
+void StepSequencer::timerCallback()
+{
+    MidiClock::TickGrid grid;
+    if (!MidiClock::getInstance().getCurrentGrid(grid))
+    {
+        // Waiting for an external clock to start
+        playStep.store(-1, std::memory_order_relaxed);
+        anchored = false;
+        return;
+    }
+
+    auto now = juce::Time::getMillisecondCounterHiRes();
+    auto position = static_cast<double>(grid.originTick) + (now - grid.origin) / grid.interval;
+    auto stepLength = grid.interval * ticksPerStep;
+
+    // Start on the next step, and again after the clock restarted or stalled for longer than a step
+    if (!anchored
+        || grid.getTickTime(nextStepTick) > now + lookaheadMs + stepLength
+        || grid.getTickTime(nextStepTick) < now - stepLength)
+    {
+        nextStepTick = static_cast<juce::int64>(std::ceil(position / ticksPerStep)) * ticksPerStep;
+        anchored = true;
+    }
+
+    const auto& pattern = snapshots.acquire();
+
+    for (; grid.getTickTime(nextStepTick) < now + lookaheadMs; nextStepTick += ticksPerStep)
+    {
+        auto step = static_cast<int>(((nextStepTick / ticksPerStep) % numSteps + numSteps) % numSteps);
+        scheduleStep(pattern, step, grid.getTickTime(nextStepTick), stepLength);
+    }
+
+    auto current = static_cast<juce::int64>(std::floor(position / ticksPerStep));
+    playStep.store(static_cast<int>((current % numSteps + numSteps) % numSteps), std::memory_order_relaxed);
+}
+
+void StepSequencer::scheduleStep(const Pattern& pattern, int step, double time, double length)
+{
+    const auto& current = pattern.steps[static_cast<size_t>(step)];
+    auto& midiOutput = MidiOutputManager::getInstance();
+
+    if (current.ccValue >= 0)
+        midiOutput.sendMessageAt(juce::MidiMessage::controllerEvent(pattern.channel, pattern.controller, current.ccValue), time);
+
+    if (current.active)
+    {
+        // Half-step gate, so repeated notes retrigger cleanly
+        midiOutput.sendNoteOnAt(pattern.channel, current.note, current.velocity / 127.0f, time);
+        midiOutput.sendNoteOnAt(pattern.channel, current.note, 0.0f, time + length * 0.5);
+    }
+}
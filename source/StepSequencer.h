@@ -0,0 +1,97 @@
+#pragma once
+
+#include <juce_events/juce_events.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include "GamepadManager.h"
+#include "TripleBuffer.h"
+
+/**
+ * A 16-step sequencer programmed and played from the D-pad and face buttons.
+ *
+ * While edit mode is on the D-pad moves the cursor (left/right) and changes
+ * the note of that step (up/down), A toggles the step, B steps through its CC
+ * values, X starts and stops playback and Y clears the pattern; those buttons
+ * stay away from their own mappings meanwhile.
+ *
+ * Playback follows the MIDI clock, one step per sixteenth. Like the clock,
+ * the scheduler hands the output the steps due within a short lookahead with
+ * their exact times. It only ever reads pattern snapshots: every edit is
+ * made on a private copy that is then published by swapping an index in a
+ * triple buffer, so editing never waits for, or tears, a step being played.
+ */
+class StepSequencer : private juce::Timer
+{
+public:
+    using ButtonMask = GamepadManager::ButtonMask;
+
+    static constexpr int numSteps = 16;
+    static constexpr int ticksPerStep = 6;
+
+    struct Step
+    {
+        bool active = false;
+        std::uint8_t note = 60;
+        std::uint8_t velocity = 100;
+        std::int8_t ccValue = -1;   // -1 sends no CC
+
+        bool operator==(const Step&) const = default;
+    };
+
+    struct Pattern
+    {
+        std::array<Step, numSteps> steps;
+        int channel = 1;
+        int controller = 20;
+
+        bool operator==(const Pattern&) const = default;
+    };
+
+    StepSequencer();
+    ~StepSequencer() override;
+
+    void setEditing(bool shouldEdit);
+    bool isEditing() const noexcept { return editing; }
+
+    // Handle this frame's button presses in edit mode. Returns the buttons
+    // that belong to the sequencer and must not reach their own mappings.
+    ButtonMask process(ButtonMask held);
+
+    // Pattern edits (message thread); each one is published to the scheduler
+    const Pattern& getPattern() const noexcept { return editPattern; }
+    void setPattern(const Pattern& newPattern);
+    void toggleStep(int step);
+    void moveCursor(int delta);
+    int getCursor() const noexcept { return cursor; }
+
+    void start();
+    void stop();
+    bool isPlaying() const noexcept { return playing; }
+
+    // The step sounding now, -1 while stopped; safe to poll from any thread
+    int getPlayStep() const noexcept { return playStep.load(std::memory_order_relaxed); }
+
+private:
+    void timerCallback() override;
+    void scheduleStep(const Pattern& pattern, int step, double time, double length);
+
+    static constexpr double lookaheadMs = 20.0;
+    static constexpr int timerIntervalMs = 5;
+
+    // Written by every edit, read by the scheduler
+    TripleBuffer<Pattern> snapshots;
+
+    Pattern editPattern;
+    int cursor = 0;
+    bool editing = false;
+    ButtonMask previousHeld = 0;
+    ButtonMask ownedButtons = 0;    // Held buttons whose press went to the sequencer
+
+    bool playing = false;
+    bool anchored = false;          // nextStepTick is on the current clock
+    juce::int64 nextStepTick = 0;
+    std::atomic<int> playStep { -1 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StepSequencer)
+};
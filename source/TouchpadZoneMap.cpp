@@ -0,0 +1,239 @@
+#include "TouchpadZoneMap.h"
+#include "MidiOutputManager.h"
+#include <algorithm>
+#include <functional>
+
+TouchpadZoneMap::TouchpadZoneMap()
+{
+    // Eight drum pads on channel 10 until configured otherwise
+    setUniformGrid(4, 2, Zone::Type::Note, 10, 36);
+}
+
+void TouchpadZoneMap::setUniformGrid(int columns, int rows, Zone::Type type, int channel, int firstNumber)
+{
+    columns = juce::jlimit(1, 64, columns);
+    rows = juce::jlimit(1, 64, rows);
+
+    std::vector<float> newColumnEdges, newRowEdges;
+    for (int c = 0; c <= columns; ++c)
+        newColumnEdges.push_back(static_cast<float>(c) / static_cast<float>(columns));
+    for (int r = 0; r <= rows; ++r)
+        newRowEdges.push_back(static_cast<float>(r) / static_cast<float>(rows));
+
+    std::vector<Zone> newZones;
+    for (int r = 0; r < rows; ++r)
+    {
+        for (int c = 0; c < columns; ++c)
+        {
+            Zone zone;
+            zone.type = type;
+            zone.channel = channel;
+            zone.number = juce::jlimit(0, 127, firstNumber + (rows - 1 - r) * columns + c);
+            newZones.push_back(zone);
+        }
+    }
+
+    setGrid(std::move(newColumnEdges), std::move(newRowEdges), std::move(newZones));
+}
+
+bool TouchpadZoneMap::setGrid(std::vector<float> newColumnEdges, std::vector<float> newRowEdges, std::vector<Zone> newZones)
+{
+    auto isValidAxis = [](const std::vector<float>& edges)
+    {
+        if (edges.size() < 2 || edges.size() > 65 || edges.front() != 0.0f || edges.back() != 1.0f)
+            return false;
+
+        // Strictly ascending
+        return std::adjacent_find(edges.begin(), edges.end(), std::greater_equal<float>()) == edges.end();
+    };
+
+    if (!isValidAxis(newColumnEdges) || !isValidAxis(newRowEdges)
+        || newZones.size() != (newColumnEdges.size() - 1) * (newRowEdges.size() - 1))
+    {
+        juce::Logger::writeToLog("Ignoring invalid touchpad zone grid");
+        return false;
+    }
+
+    // Notes held by the old layout would never be released otherwise
+    releaseAll();
+
+    columnEdges = std::move(newColumnEdges);
+    rowEdges = std::move(newRowEdges);
+    zones = std::move(newZones);
+    rebuildLookup();
+    return true;
+}
+
+void TouchpadZoneMap::setEnabled(bool shouldBeEnabled)
+{
+    if (!shouldBeEnabled)
+        releaseAll();
+
+    enabled = shouldBeEnabled;
+}
+
+void TouchpadZoneMap::rebuildLookup()
+{
+    auto fill = [](std::array<std::uint8_t, lookupResolution>& table, const std::vector<float>& edges)
+    {
+        size_t cell = 0;
+        for (int i = 0; i < lookupResolution; ++i)
+        {
+            auto position = (static_cast<float>(i) + 0.5f) / static_cast<float>(lookupResolution);
+            while (cell + 2 < edges.size() && position >= edges[cell + 1])
+                ++cell;
+
+            table[static_cast<size_t>(i)] = static_cast<std::uint8_t>(cell);
+        }
+    };
+
+    fill(columnLookup, columnEdges);
+    fill(rowLookup, rowEdges);
+}
+
+float TouchpadZoneMap::getLocalY(int zone, float y) const noexcept
+{
+    auto row = static_cast<size_t>(zone / getNumColumns());
+    auto top = rowEdges[row];
+    auto bottom = rowEdges[row + 1];
+
+    // Up is more
+    return 1.0f - juce::jlimit(0.0f, 1.0f, (y - top) / (bottom - top));
+}
+
+void TouchpadZoneMap::updateFinger(int finger, bool down, float x, float y, float pressure)
+{
+    if (!enabled || !juce::isPositiveAndBelow(finger, static_cast<int>(fingers.size())))
+        return;
+
+    auto& state = fingers[static_cast<size_t>(finger)];
+
+    if (!down)
+    {
+        leaveZone(state);
+        return;
+    }
+
+    auto zone = zoneAt(x, y);
+
+    // Sliding onto another pad releases the old one and plays the new one
+    if (zone != state.zone)
+    {
+        leaveZone(state);
+        enterZone(state, zone, getLocalY(zone, y), pressure);
+    }
+    else
+    {
+        sendZoneValue(state, getLocalY(zone, y));
+    }
+}
+
+void TouchpadZoneMap::enterZone(FingerState& finger, int zone, float localY, float pressure)
+{
+    finger.zone = zone;
+    finger.lastValue = -1;
+
+    const auto& target = zones[static_cast<size_t>(zone)];
+    if (target.type == Zone::Type::Note)
+    {
+        // Many pads report no pressure at all, so fall back to a fixed velocity
+        auto velocity = pressure > 0.0f ? juce::jlimit(0.1f, 1.0f, pressure) : 0.8f;
+        MidiOutputManager::getInstance().sendNoteOn(target.channel, target.number, velocity);
+    }
+    else
+    {
+        sendZoneValue(finger, localY);
+    }
+}
+
+void TouchpadZoneMap::sendZoneValue(FingerState& finger, float localY)
+{
+    const auto& target = zones[static_cast<size_t>(finger.zone)];
+    if (target.type != Zone::Type::ControlChange)
+        return;
+
+    auto value = juce::roundToInt(localY * 127.0f);
+    if (value == finger.lastValue)
+        return;
+
+    finger.lastValue = value;
+    MidiOutputManager::getInstance().sendControlChangeCoalesced(target.channel, target.number, value);
+}
+
+void TouchpadZoneMap::leaveZone(FingerState& finger)
+{
+    if (finger.zone >= 0)
+    {
+        const auto& target = zones[static_cast<size_t>(finger.zone)];
+        if (target.type == Zone::Type::Note)
+            MidiOutputManager::getInstance().sendNoteOn(target.channel, target.number, 0.0f);
+    }
+
+    finger = {};
+}
+
+void TouchpadZoneMap::releaseAll()
+{
+    for (auto& finger : fingers)
+        leaveZone(finger);
+}
+
+juce::var TouchpadZoneMap::toVar() const
+{
+    juce::Array<juce::var> columns, rows, zoneArray;
+    for (auto edge : columnEdges)
+        columns.add(edge);
+    for (auto edge : rowEdges)
+        rows.add(edge);
+
+    for (const auto& zone : zones)
+    {
+        juce::DynamicObject::Ptr zoneObj = new juce::DynamicObject();
+        zoneObj->setProperty("type", zone.type == Zone::Type::Note ? "note" : "cc");
+        zoneObj->setProperty("channel", zone.channel);
+        zoneObj->setProperty("number", zone.number);
+        zoneArray.add(juce::var(zoneObj));
+    }
+
+    juce::DynamicObject::Ptr obj = new juce::DynamicObject();
+    obj->setProperty("enabled", enabled);
+    obj->setProperty("columnEdges", columns);
+    obj->setProperty("rowEdges", rows);
+    obj->setProperty("zones", zoneArray);
+    return juce::var(obj);
+}
+
+bool TouchpadZoneMap::fromVar(const juce::var& state)
+{
+    auto* obj = state.getDynamicObject();
+    if (obj == nullptr)
+        return false;
+
+    auto* columns = obj->getProperty("columnEdges").getArray();
+    auto* rows = obj->getProperty("rowEdges").getArray();
+    auto* zoneArray = obj->getProperty("zones").getArray();
+    if (columns == nullptr || rows == nullptr || zoneArray == nullptr)
+        return false;
+
+    std::vector<float> newColumnEdges, newRowEdges;
+    for (const auto& edge : *columns)
+        newColumnEdges.push_back(static_cast<float>(edge));
+    for (const auto& edge : *rows)
+        newRowEdges.push_back(static_cast<float>(edge));
+
+    std::vector<Zone> newZones;
+    for (const auto& zoneVar : *zoneArray)
+    {
+        Zone zone;
+        zone.type = zoneVar.getProperty("type", "note").toString() == "cc" ? Zone::Type::ControlChange : Zone::Type::Note;
+        zone.channel = juce::jlimit(1, 16, static_cast<int>(zoneVar.getProperty("channel", 1)));
+        zone.number = juce::jlimit(0, 127, static_cast<int>(zoneVar.getProperty("number", 60)));
+        newZones.push_back(zone);
+    }
+
+    if (!setGrid(std::move(newColumnEdges), std::move(newRowEdges), std::move(newZones)))
+        return false;
+
+    setEnabled(static_cast<bool>(obj->getProperty("enabled")));
+    return true;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "GamepadManager.h"
+
+/**
+ * Splits the touchpad into a grid of note and CC zones and plays it per finger.
+ *
+ * Column and row boundaries may be uneven, so both are resolved through
+ * precomputed lookup tables: finding the zone under a finger is two table
+ * reads no matter how the grid is laid out. A finger entering a note zone
+ * plays its note and releases it on leaving; a CC zone sends the finger's
+ * height within the zone while it stays inside.
+ */
+class TouchpadZoneMap
+{
+public:
+    struct Zone
+    {
+        enum class Type
+        {
+            Note,
+            ControlChange
+        };
+
+        Type type = Type::Note;
+        int channel = 1;
+        int number = 60;  // Note or CC number
+
+        bool operator==(const Zone&) const = default;
+    };
+
+    // Table size per axis; finer than any sensible grid
+    static constexpr int lookupResolution = 256;
+
+    TouchpadZoneMap();
+
+    // Evenly spaced grid; notes ascend left to right, then bottom to top
+    void setUniformGrid(int columns, int rows, Zone::Type type, int channel, int firstNumber);
+
+    // Edges are ascending normalised boundaries (columns + 1 and rows + 1 values),
+    // zones are stored row by row from the top
+    bool setGrid(std::vector<float> columnEdges, std::vector<float> rowEdges, std::vector<Zone> zones);
+
+    void setEnabled(bool shouldBeEnabled);
+    bool isEnabled() const noexcept { return enabled; }
+
+    int getNumColumns() const noexcept { return static_cast<int>(columnEdges.size()) - 1; }
+    int getNumRows() const noexcept { return static_cast<int>(rowEdges.size()) - 1; }
+    const Zone& getZone(int index) const { return zones[static_cast<size_t>(index)]; }
+
+    // Zone index under a normalised position (y = 0 at the top, as SDL reports it)
+    int zoneAt(float x, float y) const noexcept
+    {
+        auto column = columnLookup[toLookupIndex(x)];
+        auto row = rowLookup[toLookupIndex(y)];
+        return row * getNumColumns() + column;
+    }
+
+    // Feed one finger's latest state; sends whatever MIDI its zone needs
+    void updateFinger(int finger, bool down, float x, float y, float pressure);
+
+    // Release every held note, e.g. on disconnect or when the grid changes
+    void releaseAll();
+
+    // Persisted next to the mappings as JSON
+    juce::var toVar() const;
+    bool fromVar(const juce::var& state);
+
+private:
+    struct FingerState
+    {
+        int zone = -1;
+        int lastValue = -1;
+    };
+
+    static size_t toLookupIndex(float position) noexcept
+    {
+        auto index = static_cast<int>(position * static_cast<float>(lookupResolution));
+        return static_cast<size_t>(juce::jlimit(0, lookupResolution - 1, index));
+    }
+
+    void rebuildLookup();
+    void enterZone(FingerState& finger, int zone, float localY, float pressure);
+    void leaveZone(FingerState& finger);
+    void sendZoneValue(FingerState& finger, float localY);
+    float getLocalY(int zone, float y) const noexcept;
+
+    std::vector<float> columnEdges;
+    std::vector<float> rowEdges;
+    std::vector<Zone> zones;
+
+    std::array<std::uint8_t, lookupResolution> columnLookup {};
+    std::array<std::uint8_t, lookupResolution> rowLookup {};
+
+    std::array<FingerState, GamepadManager::MAX_TOUCHPAD_FINGERS> fingers;
+    bool enabled = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TouchpadZoneMap)
+};
@@ -0,0 +1,106 @@
+#include "TraceRecorder.h"
+
+TraceRecorder::TraceRecorder()
+    : originTicks(juce::Time::getHighResolutionTicks()),
+      events(std::make_unique<std::array<Event, capacity>>())
+{
+}
+
+void TraceRecorder::setEnabled(bool shouldBeEnabled) noexcept
+{
+    enabled.store(shouldBeEnabled, std::memory_order_relaxed);
+}
+
+void TraceRecorder::clear() noexcept
+{
+    writeIndex.store(0, std::memory_order_relaxed);
+    for (auto& event : *events)
+        event.sequence.store(0, std::memory_order_relaxed);
+}
+
+std::int64_t TraceRecorder::nowNs() const noexcept
+{
+    auto elapsed = juce::Time::getHighResolutionTicks() - originTicks;
+    return static_cast<std::int64_t>(juce::Time::highResolutionTicksToSeconds(elapsed) * 1.0e9);
+}
+
+void TraceRecorder::recordComplete(const char* name, std::int64_t startNs, std::int64_t durationNs) noexcept
+{
+    auto index = writeIndex.fetch_add(1, std::memory_order_relaxed);
+    auto& event = (*events)[static_cast<size_t>(index & (capacity - 1))];
+
+    // Seqlock style publish so a concurrent dump never reads a half written slot
+    event.sequence.store(index * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    event.name.store(name, std::memory_order_relaxed);
+    event.startNs.store(startNs, std::memory_order_relaxed);
+    event.durationNs.store(durationNs, std::memory_order_relaxed);
+    event.threadId.store(static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(juce::Thread::getCurrentThreadId())),
+                         std::memory_order_relaxed);
+
+    event.sequence.store(index * 2 + 2, std::memory_order_release);
+}
+
+void TraceRecorder::writeChromeTrace(juce::OutputStream& stream) const
+{
+    auto end = writeIndex.load(std::memory_order_acquire);
+    auto begin = end > capacity ? end - capacity : 0;
+
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    for (auto index = begin; index < end; ++index)
+    {
+        const auto& event = (*events)[static_cast<size_t>(index & (capacity - 1))];
+
+        auto sequenceBefore = event.sequence.load(std::memory_order_acquire);
+        if (sequenceBefore != index * 2 + 2)
+            continue;  // Still being written or already overwritten
+
+        auto* name = event.name.load(std::memory_order_relaxed);
+        auto startNs = event.startNs.load(std::memory_order_relaxed);
+        auto durationNs = event.durationNs.load(std::memory_order_relaxed);
+        auto threadId = event.threadId.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (event.sequence.load(std::memory_order_relaxed) != sequenceBefore || name == nullptr)
+            continue;
+
+        if (!first)
+            stream << ",";
+        first = false;
+
+        // Chrome expects microseconds; keep sub-microsecond precision as decimals
+        stream << "\n{\"name\":\"" << name << "\",\"cat\":\"gamepad\",\"ph\":\"X\",\"pid\":1"
+               << ",\"tid\":" << juce::String(static_cast<juce::int64>(threadId & 0x7fffffff))
+               << ",\"ts\":" << juce::String(static_cast<double>(startNs) / 1000.0, 3)
+               << ",\"dur\":" << juce::String(static_cast<double>(durationNs) / 1000.0, 3)
+               << "}";
+    }
+
+    stream << "\n]}\n";
+}
+
+bool TraceRecorder::dumpToFile(const juce::File& file) const
+{
+    juce::TemporaryFile tempFile(file);
+
+    {
+        juce::FileOutputStream stream(tempFile.getFile());
+        if (!stream.openedOk())
+        {
+            juce::Logger::writeToLog("Failed to open trace file: " + file.getFullPathName());
+            return false;
+        }
+
+        writeChromeTrace(stream);
+        stream.flush();
+    }
+
+    if (!tempFile.overwriteTargetFileWithTemporary())
+        return false;
+
+    juce::Logger::writeToLog("Trace written to: " + file.getFullPathName());
+    return true;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <array>
+#include <cstdint>
+
+// Set to 0 to compile all trace markers out entirely
+#ifndef GAMEPAD_MIDI_TRACING
+#define GAMEPAD_MIDI_TRACING 1
+#endif
+
+/**
+ * In-memory ring buffer of scoped trace events that can be dumped as Chrome
+ * trace-event JSON (loadable in chrome://tracing and ui.perfetto.dev).
+ * When tracing is off a marker costs a single relaxed atomic load.
+ */
+class TraceRecorder
+{
+public:
+    // Get singleton instance
+    static TraceRecorder& getInstance()
+    {
+        static TraceRecorder instance;
+        return instance;
+    }
+
+    // Number of events kept; older events are overwritten
+    static constexpr std::uint32_t capacity = 1u << 16;
+
+    void setEnabled(bool shouldBeEnabled) noexcept;
+    bool isEnabled() const noexcept { return enabled.load(std::memory_order_relaxed); }
+
+    // Discard everything recorded so far
+    void clear() noexcept;
+
+    // Name must be a string literal (only the pointer is stored)
+    void recordComplete(const char* name, std::int64_t startNs, std::int64_t durationNs) noexcept;
+
+    // Nanoseconds since the recorder was created
+    std::int64_t nowNs() const noexcept;
+
+    // Write all recorded events in Chrome trace-event JSON format
+    void writeChromeTrace(juce::OutputStream& stream) const;
+    bool dumpToFile(const juce::File& file) const;
+
+    /** Records the lifetime of the enclosing scope as a complete ("X") event. */
+    class Scope
+    {
+    public:
+        explicit Scope(const char* eventName) noexcept
+            : name(eventName)
+        {
+            auto& recorder = TraceRecorder::getInstance();
+            if (recorder.isEnabled())
+                startNs = recorder.nowNs();
+        }
+
+        ~Scope()
+        {
+            if (startNs >= 0)
+            {
+                auto& recorder = TraceRecorder::getInstance();
+                recorder.recordComplete(name, startNs, recorder.nowNs() - startNs);
+            }
+        }
+
+    private:
+        const char* name;
+        std::int64_t startNs = -1;
+
+        JUCE_DECLARE_NON_COPYABLE(Scope)
+    };
+
+private:
+    TraceRecorder();
+
+    struct Event
+    {
+        // Odd while a writer is filling the slot, even once it is complete
+        std::atomic<std::uint64_t> sequence { 0 };
+        std::atomic<const char*> name { nullptr };
+        std::atomic<std::int64_t> startNs { 0 };
+        std::atomic<std::int64_t> durationNs { 0 };
+        std::atomic<std::uint64_t> threadId { 0 };
+    };
+
+    std::atomic<bool> enabled { false };
+    std::atomic<std::uint64_t> writeIndex { 0 };
+    juce::int64 originTicks = 0;
+    std::unique_ptr<std::array<Event, capacity>> events;
+
+    JUCE_DECLARE_NON_COPYABLE(TraceRecorder)
+};
+
+#if GAMEPAD_MIDI_TRACING
+#define GAMEPAD_TRACE_SCOPE(name) TraceRecorder::Scope JUCE_JOIN_MACRO(traceScope_, __LINE__)(name)
+#else
+#define GAMEPAD_TRACE_SCOPE(name)
+#endif
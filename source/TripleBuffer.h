@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+/**
+ * Hands the latest value from one writer thread to one reader thread without
+ * locks. The writer fills a slot only it touches and publishes it by swapping
+ * an index; the reader swaps the newest slot in when one is waiting. Neither
+ * side ever waits for the other or sees a value half written, and a reader
+ * that falls behind simply skips to the newest value.
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+    // Writer side: the slot to fill before publishing
+    T& write() noexcept { return buffers[static_cast<size_t>(writeBuffer)]; }
+
+    void publish() noexcept
+    {
+        writeBuffer = sharedBuffer.exchange(writeBuffer | freshFlag, std::memory_order_acq_rel) & ~freshFlag;
+    }
+
+    void publish(const T& value)
+    {
+        write() = value;
+        publish();
+    }
+
+    // Reader side: the newest published value, stable until the next call
+    const T& acquire() noexcept
+    {
+        if ((sharedBuffer.load(std::memory_order_relaxed) & freshFlag) != 0)
+            readBuffer = sharedBuffer.exchange(readBuffer, std::memory_order_acq_rel) & ~freshFlag;
+
+        return buffers[static_cast<size_t>(readBuffer)];
+    }
+
+private:
+    // The writer owns one slot, the reader another, and the third is
+    // exchanged between them together with a "fresh" flag
+    static constexpr int freshFlag = 4;
+    std::array<T, 3> buffers {};
+    std::atomic<int> sharedBuffer { 1 };
+    int writeBuffer = 0;
+    int readBuffer = 2;
+};
@@ -1,4 +1,6 @@
 #include "AnalogStick.h"
+#include "ValueTextCache.h"
+#include "../TraceRecorder.h"
 
 AnalogStick::AnalogStick()
 {
@@ -24,23 +26,29 @@ AnalogStick::AnalogStick(const juce::String& name, bool isStick)
 
 void AnalogStick::setState(const State& newState)
 {
+    if (state == newState)
+        return;
+
+    if (state.pressCC != newState.pressCC)
+        pressCCText = "CC" + juce::String(newState.pressCC);
+
     state = newState;
 
     // Update X axis button with current value
-    xButton.setProperties({
-        "X: " + juce::String(state.xValue, 2),
-        state.xCC,
-        false,  // We don't show pressed state for axis
-        state.isLearnMode
-    });
+    auto xProps = xButton.getProperties();
+    xProps.text = ValueTextCache::forX().get(state.xValue);
+    xProps.ccNumber = state.xCC;
+    xProps.isPressed = false;  // We don't show pressed state for axis
+    xProps.isLearnMode = state.isLearnMode;
+    xButton.setProperties(xProps);
 
     // Update Y axis button with current value
-    yButton.setProperties({
-        "Y: " + juce::String(state.yValue, 2),
-        state.yCC,
-        false,  // We don't show pressed state for axis
-        state.isLearnMode
-    });
+    auto yProps = yButton.getProperties();
+    yProps.text = ValueTextCache::forY().get(state.yValue);
+    yProps.ccNumber = state.yCC;
+    yProps.isPressed = false;  // We don't show pressed state for axis
+    yProps.isLearnMode = state.isLearnMode;
+    yButton.setProperties(yProps);
 
     updateStickPosition();
     repaint();
@@ -84,8 +92,22 @@ void AnalogStick::resized()
 
 void AnalogStick::paint(juce::Graphics& g)
 {
+    GAMEPAD_TRACE_SCOPE("AnalogStick::paint");
+
     if (!state.isEnabled) return;
 
+    // The well, deadzone and axis labels only change on resize
+    backgroundLayer.draw(g, getLocalBounds(), 0, [this](juce::Graphics& layer)
+    {
+        drawBackground(layer);
+        drawLabels(layer);
+    });
+
+    drawStick(g);
+}
+
+void AnalogStick::drawBackground(juce::Graphics& g)
+{
     // Draw stick area background
     g.setColour(juce::Colours::darkgrey);
     g.fillEllipse(stickBounds);
@@ -96,9 +118,6 @@ void AnalogStick::paint(juce::Graphics& g)
     auto centerY = stickBounds.getCentreY();
     g.drawEllipse(centerX - deadZoneRadius, centerY - deadZoneRadius,
                   deadZoneRadius * 2, deadZoneRadius * 2, 1.0f);
-
-    drawLabels(g);
-    drawStick(g);
 }
 
 void AnalogStick::setupCallbacks()
@@ -167,9 +186,8 @@ void AnalogStick::drawStick(juce::Graphics& g)
     if (state.isLearnMode)
     {
         g.setColour(juce::Colours::white);
-        g.setFont(12.0f);
-        juce::String ccText = "CC" + juce::String(state.pressCC);
-        g.drawText(ccText, 
+        g.setFont(labelFont);
+        g.drawText(pressCCText, 
                   stickPosition.x - stickRadius,
                   stickPosition.y - 6.0f,
                   stickRadius * 2,
@@ -181,7 +199,7 @@ void AnalogStick::drawStick(juce::Graphics& g)
 void AnalogStick::drawLabels(juce::Graphics& g)
 {
     g.setColour(juce::Colours::white);
-    g.setFont(12.0f);
+    g.setFont(labelFont);
 
     // Draw axis labels
     auto centerX = stickBounds.getCentreX();
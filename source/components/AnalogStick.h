@@ -3,6 +3,7 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_graphics/juce_graphics.h>
 #include "ClassicButton.h"
+#include "CachedLayer.h"
 
 class AnalogStick : public juce::Component
 {
@@ -18,6 +19,8 @@ public:
         bool isLearnMode = false;
         juce::String name;
         bool isStick = true;
+
+        bool operator==(const State&) const = default;
     };
 
     AnalogStick();
@@ -25,6 +28,7 @@ public:
     ~AnalogStick() override = default;
 
     void setState(const State& newState);
+    const State& getState() const { return state; }
     void resized() override;
     void paint(juce::Graphics& g) override;
     void mouseDown(const juce::MouseEvent& e) override;
@@ -65,8 +69,14 @@ private:
     juce::Point<float> stickPosition;
     juce::Rectangle<float> stickBounds;
 
+    // Static artwork and text resources, built once instead of every paint
+    CachedLayer backgroundLayer;
+    juce::Font labelFont { 12.0f };
+    juce::String pressCCText { "CC0" };
+
     void setupCallbacks();
     void updateStickPosition();
+    void drawBackground(juce::Graphics& g);
     void drawStick(juce::Graphics& g);
     void drawLabels(juce::Graphics& g);
     bool isPointOverStick(juce::Point<float> point) const;
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <cstdint>
+
+/**
+ * Pre-rendered image of the static part of a component (backgrounds, bevels,
+ * grids, fixed labels). The image is only re-rendered when the size, the
+ * display scale or the caller supplied key changes; otherwise drawing it is a
+ * single image blit and only the dynamic overlay needs painting each frame.
+ */
+class CachedLayer
+{
+public:
+    template <typename RenderFunction>
+    void draw(juce::Graphics& g, juce::Rectangle<int> bounds, std::uint64_t key, RenderFunction&& render)
+    {
+        if (bounds.isEmpty())
+            return;
+
+        auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+        if (image.isNull() || bounds != cachedBounds || scale != cachedScale || key != cachedKey)
+        {
+            image = juce::Image(juce::Image::ARGB,
+                                juce::jmax(1, juce::roundToInt(static_cast<float>(bounds.getWidth()) * scale)),
+                                juce::jmax(1, juce::roundToInt(static_cast<float>(bounds.getHeight()) * scale)),
+                                true);
+
+            juce::Graphics imageGraphics(image);
+            imageGraphics.addTransform(juce::AffineTransform::scale(scale)
+                                           .translated(static_cast<float>(-bounds.getX()) * scale,
+                                                       static_cast<float>(-bounds.getY()) * scale));
+            render(imageGraphics);
+
+            cachedBounds = bounds;
+            cachedScale = scale;
+            cachedKey = key;
+        }
+
+        g.drawImage(image, bounds.toFloat());
+    }
+
+    // Force a re-render on the next draw
+    void invalidate() { image = {}; }
+
+private:
+    juce::Image image;
+    juce::Rectangle<int> cachedBounds;
+    float cachedScale = 0.0f;
+    std::uint64_t cachedKey = 0;
+};
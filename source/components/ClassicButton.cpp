@@ -1,26 +1,53 @@
 #include "ClassicButton.h"
+#include "../TraceRecorder.h"
 
 ClassicButton::ClassicButton(const Properties& initialProps)
-    : props(initialProps)
+    : props(initialProps),
+      ccText("CC" + juce::String(initialProps.ccNumber))
 {
     setOpaque(true);
 }
 
 void ClassicButton::setProperties(const Properties& newProps)
 {
+    // Only repaint when something visible actually changed
+    if (props == newProps)
+        return;
+
+    if (props.ccNumber != newProps.ccNumber)
+        ccText = "CC" + juce::String(newProps.ccNumber);
+
     props = newProps;
     repaint();
 }
 
 void ClassicButton::paint(juce::Graphics& g)
 {
-    if (props.isLearnMode && props.ccNumber >= 0)
-        drawLearnStyle(g);
+    GAMEPAD_TRACE_SCOPE("ClassicButton::paint");
+
+    bool learnStyle = props.isLearnMode && props.ccNumber >= 0;
+    bool sunken = props.isPressed || isMouseDown;
+
+    // Background and bevel only depend on style, pressed state, colour and corners
+    std::uint64_t key = static_cast<std::uint64_t>(props.backgroundColor.getARGB()) << 32;
+    key |= static_cast<std::uint64_t>(juce::roundToInt(props.cornerRadius * 16.0f) & 0xffff) << 2;
+    key |= (learnStyle ? 2u : 0u) | (sunken ? 1u : 0u);
+
+    backgroundLayer.draw(g, getLocalBounds(), key, [&](juce::Graphics& layer)
+    {
+        if (learnStyle)
+            drawLearnBackground(layer);
+        else
+            drawClassicBackground(layer, sunken);
+    });
+
+    if (learnStyle)
+        drawLearnText(g);
     else
-        drawClassicStyle(g);
+        drawClassicText(g);
 }
 
-void ClassicButton::drawClassicStyle(juce::Graphics& g)
+void ClassicButton::drawClassicBackground(juce::Graphics& g, bool sunken)
 {
     auto bounds = getLocalBounds().toFloat();
     
@@ -33,38 +60,27 @@ void ClassicButton::drawClassicStyle(juce::Graphics& g)
 
     // Draw 3D effect
     float borderWidth = 1.0f;
-    g.setColour(props.isPressed || isMouseDown ? juce::Colours::darkgrey : juce::Colours::white);
+    g.setColour(sunken ? juce::Colours::darkgrey : juce::Colours::white);
     g.drawLine(bounds.getX(), bounds.getY(), bounds.getRight(), bounds.getY(), borderWidth);  // Top
     g.drawLine(bounds.getX(), bounds.getY(), bounds.getX(), bounds.getBottom(), borderWidth); // Left
 
-    g.setColour(props.isPressed || isMouseDown ? juce::Colours::white : juce::Colours::darkgrey);
+    g.setColour(sunken ? juce::Colours::white : juce::Colours::darkgrey);
     g.drawLine(bounds.getRight(), bounds.getY(), bounds.getRight(), bounds.getBottom(), borderWidth); // Right
     g.drawLine(bounds.getX(), bounds.getBottom(), bounds.getRight(), bounds.getBottom(), borderWidth); // Bottom
+}
 
-    // Draw text
-    if (props.text.isNotEmpty())
-    {
-        g.setColour(props.textColor);
-        g.setFont(juce::Font("MS Sans Serif", 11.0f, juce::Font::plain));
-        
-        // If in learn mode and has CC number, show both text and CC
-        if (props.isLearnMode && props.ccNumber >= 0)
-        {
-            auto textBounds = bounds.reduced(2);
-            g.drawText(props.text, textBounds.removeFromTop(textBounds.getHeight() * 0.6f), 
-                      juce::Justification::centred, false);
-            g.setFont(juce::Font("MS Sans Serif", 9.0f, juce::Font::plain));
-            g.drawText("CC" + juce::String(props.ccNumber), textBounds, 
-                      juce::Justification::centred, false);
-        }
-        else
-        {
-            g.drawText(props.text, bounds, juce::Justification::centred, false);
-        }
-    }
+void ClassicButton::drawClassicText(juce::Graphics& g)
+{
+    if (props.text.isEmpty())
+        return;
+
+    auto bounds = getLocalBounds().toFloat();
+    g.setColour(props.textColor);
+    g.setFont(labelFont);
+    g.drawText(props.text, bounds, juce::Justification::centred, false);
 }
 
-void ClassicButton::drawLearnStyle(juce::Graphics& g)
+void ClassicButton::drawLearnBackground(juce::Graphics& g)
 {
     auto bounds = getLocalBounds().toFloat();
     
@@ -81,24 +97,22 @@ void ClassicButton::drawLearnStyle(juce::Graphics& g)
         g.drawRoundedRectangle(bounds, props.cornerRadius, 1.0f);
     else
         g.drawRect(bounds, 1.0f);
+}
 
-    // Draw text
-    if (props.text.isNotEmpty())
-    {
-        g.setColour(juce::Colours::white);
-        g.setFont(juce::Font("MS Sans Serif", 11.0f, juce::Font::plain));
-        auto textBounds = bounds.reduced(2);
-        
-        g.drawText(props.text, textBounds.removeFromTop(textBounds.getHeight() * 0.6f), 
-                  juce::Justification::centred, false);
-        
-        if (props.ccNumber >= 0)
-        {
-            g.setFont(juce::Font("MS Sans Serif", 9.0f, juce::Font::plain));
-            g.drawText("CC" + juce::String(props.ccNumber), textBounds, 
-                      juce::Justification::centred, false);
-        }
-    }
+void ClassicButton::drawLearnText(juce::Graphics& g)
+{
+    if (props.text.isEmpty())
+        return;
+
+    // Show both the control name and its CC number
+    auto textBounds = getLocalBounds().toFloat().reduced(2);
+    g.setColour(juce::Colours::white);
+    g.setFont(labelFont);
+    g.drawText(props.text, textBounds.removeFromTop(textBounds.getHeight() * 0.6f), 
+              juce::Justification::centred, false);
+    
+    g.setFont(ccFont);
+    g.drawText(ccText, textBounds, juce::Justification::centred, false);
 }
 
 void ClassicButton::mouseDown(const juce::MouseEvent& event)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <juce_gui_basics/juce_gui_basics.h>
+#include "CachedLayer.h"
 
 class ClassicButton : public juce::Component {
 public:
@@ -13,6 +14,8 @@ public:
         juce::Colour textColor = juce::Colours::black;
         float cornerRadius = 0.0f;
 
+        bool operator==(const Properties&) const = default;
+
         static Properties create(const juce::String& text) {
             Properties props;
             props.text = text;
@@ -39,8 +42,16 @@ private:
     Properties props;
     bool isMouseDown = false;
 
-    void drawClassicStyle(juce::Graphics& g);
-    void drawLearnStyle(juce::Graphics& g);
+    // Built once instead of on every paint
+    CachedLayer backgroundLayer;
+    juce::Font labelFont { "MS Sans Serif", 11.0f, juce::Font::plain };
+    juce::Font ccFont { "MS Sans Serif", 9.0f, juce::Font::plain };
+    juce::String ccText;
+
+    void drawClassicBackground(juce::Graphics& g, bool sunken);
+    void drawClassicText(juce::Graphics& g);
+    void drawLearnBackground(juce::Graphics& g);
+    void drawLearnText(juce::Graphics& g);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ClassicButton)
 }; 
\ No newline at end of file
@@ -13,39 +13,38 @@ DirectionalPad::DirectionalPad()
 
 void DirectionalPad::setState(const State& newState)
 {
+    if (state == newState)
+        return;
+
     state = newState;
 
     // Update Up button
-    upButton.setProperties({
-        "Up",
-        state.upCC,
-        state.upPressed,
-        state.isLearnMode
-    });
+    auto upProps = upButton.getProperties();
+    upProps.ccNumber = state.upCC;
+    upProps.isPressed = state.upPressed;
+    upProps.isLearnMode = state.isLearnMode;
+    upButton.setProperties(upProps);
 
     // Update Down button
-    downButton.setProperties({
-        "Down",
-        state.downCC,
-        state.downPressed,
-        state.isLearnMode
-    });
+    auto downProps = downButton.getProperties();
+    downProps.ccNumber = state.downCC;
+    downProps.isPressed = state.downPressed;
+    downProps.isLearnMode = state.isLearnMode;
+    downButton.setProperties(downProps);
 
     // Update Left button
-    leftButton.setProperties({
-        "Left",
-        state.leftCC,
-        state.leftPressed,
-        state.isLearnMode
-    });
+    auto leftProps = leftButton.getProperties();
+    leftProps.ccNumber = state.leftCC;
+    leftProps.isPressed = state.leftPressed;
+    leftProps.isLearnMode = state.isLearnMode;
+    leftButton.setProperties(leftProps);
 
     // Update Right button
-    rightButton.setProperties({
-        "Right",
-        state.rightCC,
-        state.rightPressed,
-        state.isLearnMode
-    });
+    auto rightProps = rightButton.getProperties();
+    rightProps.ccNumber = state.rightCC;
+    rightProps.isPressed = state.rightPressed;
+    rightProps.isLearnMode = state.isLearnMode;
+    rightButton.setProperties(rightProps);
 }
 
 void DirectionalPad::resized()
@@ -18,6 +18,8 @@ public:
         int leftCC = -1;
         int rightCC = -1;
         bool isLearnMode = false;
+
+        bool operator==(const State&) const = default;
     };
 
     DirectionalPad();
@@ -13,39 +13,38 @@ FaceButtons::FaceButtons()
 
 void FaceButtons::setState(const State& newState)
 {
+    if (state == newState)
+        return;
+
     state = newState;
 
     // Update A button
-    aButton.setProperties({
-        "A",
-        state.aCC,
-        state.aPressed,
-        state.isLearnMode
-    });
+    auto aProps = aButton.getProperties();
+    aProps.ccNumber = state.aCC;
+    aProps.isPressed = state.aPressed;
+    aProps.isLearnMode = state.isLearnMode;
+    aButton.setProperties(aProps);
 
     // Update B button
-    bButton.setProperties({
-        "B",
-        state.bCC,
-        state.bPressed,
-        state.isLearnMode
-    });
+    auto bProps = bButton.getProperties();
+    bProps.ccNumber = state.bCC;
+    bProps.isPressed = state.bPressed;
+    bProps.isLearnMode = state.isLearnMode;
+    bButton.setProperties(bProps);
 
     // Update X button
-    xButton.setProperties({
-        "X",
-        state.xCC,
-        state.xPressed,
-        state.isLearnMode
-    });
+    auto xProps = xButton.getProperties();
+    xProps.ccNumber = state.xCC;
+    xProps.isPressed = state.xPressed;
+    xProps.isLearnMode = state.isLearnMode;
+    xButton.setProperties(xProps);
 
     // Update Y button
-    yButton.setProperties({
-        "Y",
-        state.yCC,
-        state.yPressed,
-        state.isLearnMode
-    });
+    auto yProps = yButton.getProperties();
+    yProps.ccNumber = state.yCC;
+    yProps.isPressed = state.yPressed;
+    yProps.isLearnMode = state.isLearnMode;
+    yButton.setProperties(yProps);
 }
 
 void FaceButtons::resized()
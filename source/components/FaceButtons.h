@@ -18,6 +18,8 @@ public:
         bool xPressed = false;
         bool yPressed = false;
         bool isLearnMode = false;
+
+        bool operator==(const State&) const = default;
     };
 
     FaceButtons();
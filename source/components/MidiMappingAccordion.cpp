@@ -1,438 +1,386 @@
 #include "MidiMappingAccordion.h"
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_core/juce_core.h>
+#include "../TraceRecorder.h"
+#include "../MappingBinaryFormat.h"
+#include "../MappingSerializer.h"
+#include "../ScaleQuantiser.h"
 
-// Implementation of ControlItem::MappingsList
-MidiMappingAccordion::ControlItem::MappingsList::MappingsList(const std::vector<StandaloneApp::MidiMapping>& mappings, ControlItem& owner)
-    : mappings(mappings), owner(owner)
+// Implementation of RowComponent
+MidiMappingAccordion::RowComponent::RowComponent(MidiMappingAccordion& accordion)
+    : owner(accordion)
 {
-    // Create remove buttons for each mapping
-    updateRemoveButtons();
+    // Set up expand button in header with improved styling
+    expandButton.setButtonText("+");
+    expandButton.setColour(juce::TextButton::buttonColourId, juce::Colours::transparentBlack);
+    expandButton.onClick = [this] { owner.setExpanded(row.control, !expanded); };
+    addChildComponent(expandButton);
+    
+    removeButton.setColour(juce::TextButton::buttonColourId, juce::Colours::red);
+    removeButton.onClick = [this] { owner.removeMapping(row.control, row.mapping); };
+    addChildComponent(removeButton);
+    
+    addMappingButton.setColour(juce::TextButton::buttonColourId, juce::Colours::lightblue);
+    addMappingButton.onClick = [this] { owner.addMapping(row.control); };
+    addChildComponent(addMappingButton);
 }
 
-void MidiMappingAccordion::ControlItem::MappingsList::updateRemoveButtons()
+void MidiMappingAccordion::RowComponent::update(int newRowNumber)
 {
-    // Clear existing buttons
-    removeButtons.clear();
-    
-    // Create a new button for each mapping
-    for (size_t i = 0; i < mappings.size(); ++i)
+    if (!juce::isPositiveAndBelow(newRowNumber, static_cast<int>(owner.rows.size())))
     {
-        auto button = std::make_unique<juce::TextButton>("X");
-        button->setColour(juce::TextButton::buttonColourId, juce::Colours::red);
-        // button->setColour(juce::TextButton::textColourId, juce::Colours::white);
-        button->addListener(this);
-        addAndMakeVisible(button.get());
-        removeButtons.push_back(std::move(button));
+        setVisible(false);
+        return;
     }
-}
-
-void MidiMappingAccordion::ControlItem::MappingsList::paint(juce::Graphics& g)
-{
-    g.fillAll(juce::Colours::white);
     
-    if (mappings.empty())
+    setVisible(true);
+    
+    auto newRow = owner.rows[static_cast<size_t>(newRowNumber)];
+    const auto& control = owner.controls[static_cast<size_t>(newRow.control)];
+    
+    juce::String newText;
+    juce::String newSummary;
+    
+    switch (newRow.kind)
     {
-        g.setColour(juce::Colours::darkgrey);
-        g.drawText("No mappings", getLocalBounds(), juce::Justification::centred, true);
-        return;
+        case Row::Kind::Header:
+            newText = control.name;
+            
+            // Summary of mappings if not expanded
+            if (!control.expanded && !control.mappings.empty())
+                newSummary = juce::String(control.mappings.size()) + " mapping" + (control.mappings.size() > 1 ? "s" : "");
+            break;
+            
+        case Row::Kind::Mapping:
+            newText = getMappingText(control.mappings[static_cast<size_t>(newRow.mapping)]);
+            break;
+            
+        case Row::Kind::Empty:
+            newText = "No mappings";
+            break;
+            
+        case Row::Kind::AddButton:
+            break;
     }
     
-    g.setColour(juce::Colours::black);
-    g.setFont(14.0f);
+    bool changed = newRow.kind != row.kind
+                || newText != text
+                || newSummary != summary
+                || control.highlighted != highlighted
+                || control.expanded != expanded;
+    
+    row = newRow;
+    text = newText;
+    summary = newSummary;
+    highlighted = control.highlighted;
+    expanded = control.expanded;
+    
+    expandButton.setVisible(row.kind == Row::Kind::Header);
+    expandButton.setButtonText(expanded ? "-" : "+");
+    removeButton.setVisible(row.kind == Row::Kind::Mapping);
+    addMappingButton.setVisible(row.kind == Row::Kind::AddButton);
+    
+    // Recycled rows showing the same content are left alone
+    if (changed)
+        repaint();
+}
+
+void MidiMappingAccordion::RowComponent::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds();
     
-    int y = 5;
-    for (size_t i = 0; i < mappings.size(); ++i)
+    if (row.kind == Row::Kind::Header)
     {
-        const auto& mapping = mappings[i];
-        juce::String mappingText;
+        GAMEPAD_TRACE_SCOPE("MidiMappingAccordion::HeaderRow::paint");
         
-        if (mapping.type == StandaloneApp::MidiMapping::Type::ControlChange)
+        headerLayer.draw(g, bounds, 0, [bounds](juce::Graphics& layer)
         {
-            mappingText = juce::String("Ch:") + juce::String(mapping.channel) +
-                         " CC:" + juce::String(mapping.ccNumber) +
-                         " [" + juce::String(mapping.minValue) + "-" + juce::String(mapping.maxValue) + "]";
-        }
-        else // Note
+            // Draw header background with a subtle gradient
+            juce::ColourGradient gradient(
+                juce::Colours::lightgrey,
+                0.0f, 0.0f,
+                juce::Colours::lightgrey.brighter(0.1f),
+                0.0f, (float)bounds.getHeight(),
+                false);
+            layer.setGradientFill(gradient);
+            layer.fillRect(bounds.toFloat());
+            
+            // Draw a subtle border
+            layer.setColour(juce::Colours::grey.withAlpha(0.5f));
+            layer.drawRect(bounds.toFloat(), 1.0f);
+        });
+        
+        // Flash highlighted controls
+        if (highlighted)
+            g.fillAll(juce::Colours::orange.withAlpha(0.3f));
+        
+        // Draw control name
+        g.setColour(juce::Colours::black);
+        g.setFont(nameFont);
+        g.drawText(text, bounds.reduced(10, 0).withTrimmedRight(30), juce::Justification::centredLeft, true);
+        
+        if (summary.isNotEmpty())
         {
-            mappingText = juce::String("Ch:") + juce::String(mapping.channel) +
-                         " Note:" + juce::String(mapping.noteNumber) +
-                         " [" + juce::String(mapping.minValue) + "-" + juce::String(mapping.maxValue) + "]";
+            g.setFont(summaryFont);
+            g.setColour(juce::Colours::darkgrey);
+            g.drawText(summary, bounds.reduced(10, 0).withTrimmedRight(30), juce::Justification::centredRight, true);
         }
         
+        return;
+    }
+    
+    g.fillAll(juce::Colours::white);
+    
+    if (highlighted)
+        g.fillAll(juce::Colours::lightblue.withAlpha(0.3f));
+    
+    if (row.kind == Row::Kind::Mapping)
+    {
         // Draw a subtle background for each mapping item
         g.setColour(juce::Colours::lightgrey.withAlpha(0.3f));
-        g.fillRect(juce::Rectangle<float>(5.0f, y, getWidth() - 10, 22));
+        g.fillRect(juce::Rectangle<float>(5.0f, 4.0f, getWidth() - 10.0f, 22.0f));
         
         g.setColour(juce::Colours::black);
-        g.drawText(mappingText, 10, y, getWidth() - 35, 22, juce::Justification::centredLeft, true);
-        y += 30;
+        g.setFont(mappingFont);
+        g.drawText(text, 10, 4, getWidth() - 35, 22, juce::Justification::centredLeft, true);
+    }
+    else if (row.kind == Row::Kind::Empty)
+    {
+        g.setColour(juce::Colours::darkgrey);
+        g.drawText(text, bounds, juce::Justification::centred, true);
     }
 }
 
-void MidiMappingAccordion::ControlItem::MappingsList::resized()
+void MidiMappingAccordion::RowComponent::resized()
 {
-    // Position the remove buttons
-    int y = 5;
-    for (size_t i = 0; i < removeButtons.size(); ++i)
-    {
-        removeButtons[i]->setBounds(getWidth() - 25, y, 20, 22);
-        y += 30;
-    }
+    expandButton.setBounds(getWidth() - 25, 2, 20, 26);
+    removeButton.setBounds(getWidth() - 25, 4, 20, 22);
+    addMappingButton.setBounds(5, 5, 100, 20);
 }
 
-void MidiMappingAccordion::ControlItem::MappingsList::updateMappings(const std::vector<StandaloneApp::MidiMapping>& newMappings)
+void MidiMappingAccordion::RowComponent::mouseDown(const juce::MouseEvent&)
 {
-    mappings = newMappings;
-    updateRemoveButtons();
-    repaint();
+    // Toggle expanded state when header is clicked
+    if (row.kind == Row::Kind::Header)
+        owner.setExpanded(row.control, !expanded);
 }
 
-void MidiMappingAccordion::ControlItem::MappingsList::buttonClicked(juce::Button* button)
+// Implementation of MidiMappingAccordion
+MidiMappingAccordion::MidiMappingAccordion(StandaloneApp& app)
+    : app(app)
 {
-    // Find which button was clicked
-    for (size_t i = 0; i < removeButtons.size(); ++i)
+    // Control list is fixed; only the mappings inside it change
+    auto addControls = [this](const juce::String& type, int count)
     {
-        if (button == removeButtons[i].get())
+        for (int i = 0; i < count; ++i)
         {
-            // Remove this specific mapping
-            auto currentMappings = mappings;
-            currentMappings.erase(currentMappings.begin() + i);
-            owner.updateMappings(currentMappings);
-            owner.parent.updateAppMappings();
-            
-            // Force a resize of the parent accordion to adjust for the removed item
-            owner.parent.resized();
-            
-            break;
+            ControlEntry entry;
+            entry.name = getControlName(type, i);
+            entry.type = type;
+            entry.index = i;
+            controls.push_back(std::move(entry));
         }
-    }
+    };
+    
+    addControls("Axis", GamepadManager::MAX_AXES);
+    addControls("Button", GamepadManager::MAX_BUTTONS);
+    addControls("Gyro", 3);
+    addControls("Accel", 3);
+    addControls("Touchpad", TouchpadControl::count);
+    addControls("Motion", MotionGesture::count);
+    
+    listBox.setModel(this);
+    listBox.setRowHeight(rowHeight);
+    listBox.setColour(juce::ListBox::backgroundColourId, juce::Colours::white);
+    listBox.setColour(juce::ListBox::outlineColourId, juce::Colours::grey.withAlpha(0.5f));
+    listBox.setOutlineThickness(1);
+    listBox.getViewport()->setScrollBarThickness(12);
+    addAndMakeVisible(listBox);
+    
+    // Initialize mapping data
+    updateMappingData();
 }
 
-// Implementation of HeaderComponent
-MidiMappingAccordion::ControlItem::HeaderComponent::HeaderComponent(ControlItem& owner)
-    : owner(owner)
+MidiMappingAccordion::~MidiMappingAccordion()
 {
-    // Make the header component mouse clickable
-    setMouseClickGrabsKeyboardFocus(true);
+    listBox.setModel(nullptr);
 }
 
-void MidiMappingAccordion::ControlItem::HeaderComponent::paint(juce::Graphics& g)
+void MidiMappingAccordion::paint(juce::Graphics& g)
 {
-    auto bounds = getLocalBounds();
-    
-    // Draw header background with a subtle gradient
-    juce::ColourGradient gradient(
-        juce::Colours::lightgrey,
-        0.0f, 0.0f,
-        juce::Colours::lightgrey.brighter(0.1f),
-        0.0f, (float)bounds.getHeight(),
-        false);
-    g.setGradientFill(gradient);
-    g.fillRect(bounds.toFloat());
-    
-    // Draw a subtle border
-    g.setColour(juce::Colours::grey.withAlpha(0.5f));
-    g.drawRect(bounds.toFloat(), 1.0f);
-    
-    // Draw control name
-    g.setColour(juce::Colours::black);
-    g.setFont(16.0f);
-    g.drawText(owner.controlName, bounds.reduced(10).withTrimmedRight(30), juce::Justification::centredLeft, true);
-    
-    // Draw summary of mappings if not expanded
-    if (!owner.expanded && !owner.mappings.empty())
-    {
-        g.setFont(14.0f);
-        g.setColour(juce::Colours::darkgrey);
-        
-        juce::String summaryText = juce::String(owner.mappings.size()) + " mapping" + 
-                                  (owner.mappings.size() > 1 ? "s" : "");
-        
-        g.drawText(summaryText, bounds.reduced(10).withTrimmedRight(30), juce::Justification::centredRight, true);
-    }
+    g.fillAll(juce::Colours::white);
 }
 
-void MidiMappingAccordion::ControlItem::HeaderComponent::mouseDown(const juce::MouseEvent&)
+void MidiMappingAccordion::resized()
 {
-    // Toggle expanded state when header is clicked
-    owner.setExpanded(!owner.expanded);
+    listBox.setBounds(getLocalBounds());
 }
 
-// Implementation of ControlItem
-MidiMappingAccordion::ControlItem::ControlItem(const juce::String& name, 
-                                             const juce::String& type, 
-                                             int index, 
-                                             const std::vector<StandaloneApp::MidiMapping>& mappings,
-                                             MidiMappingAccordion& parent)
-    : controlName(name),
-      controlType(type),
-      controlIndex(index),
-      mappings(mappings),
-      parent(parent)
+int MidiMappingAccordion::getNumRows()
 {
-    // Create header component
-    headerComponent = std::make_unique<HeaderComponent>(*this);
-    headerComponent->setSize(100, 30);
-    addAndMakeVisible(headerComponent.get());
-    
-    // Set up expand button in header with improved styling
-    expandButton.setButtonText("+");
-    expandButton.addListener(this);
-    expandButton.setColour(juce::TextButton::buttonColourId, juce::Colours::transparentBlack);
-    // expandButton.setColour(juce::TextButton::textColourId, juce::Colours::black);
-    headerComponent->addAndMakeVisible(expandButton);
-    
-    // Set up add/remove buttons with improved styling
-    addMappingButton.setButtonText("Add Mapping");
-    addMappingButton.addListener(this);
-    addMappingButton.setColour(juce::TextButton::buttonColourId, juce::Colours::lightblue);
-    // addMappingButton.setColour(juce::TextButton::textColourId, juce::Colours::black);
-    addAndMakeVisible(addMappingButton);
-    
-    // Set up mappings list
-    mappingsList = std::make_unique<MappingsList>(mappings, *this);
-    addAndMakeVisible(mappingsList.get());
+    return static_cast<int>(rows.size());
 }
 
-void MidiMappingAccordion::ControlItem::paint(juce::Graphics& g)
+void MidiMappingAccordion::paintListBoxItem(int, juce::Graphics&, int, int, bool)
 {
-    auto bounds = getLocalBounds();
-    
-    // Draw background
-    if (highlighted)
-    {
-        // Flash effect for highlighted controls
-        auto currentTime = juce::Time::getMillisecondCounter();
-        bool isFlashing = (currentTime / 100) % 2 == 0; // Flash every 100ms
-        
-        if (isFlashing)
-            g.fillAll(juce::Colours::orange.withAlpha(0.3f));
-        else
-            g.fillAll(juce::Colours::lightblue.withAlpha(0.3f));
-    }
-    else
-    {
-        g.fillAll(juce::Colours::white);
-    }
-    
-    // Draw a subtle border around the entire control item
-    g.setColour(juce::Colours::grey.withAlpha(0.3f));
-    g.drawRect(bounds.toFloat(), 1.0f);
+    // Rows draw themselves
 }
 
-void MidiMappingAccordion::ControlItem::resized()
+juce::Component* MidiMappingAccordion::refreshComponentForRow(int rowNumber, bool, juce::Component* existingComponentToUpdate)
 {
-    auto bounds = getLocalBounds();
-    
-    // Define header height - reduced from 40 to 30
-    const int headerHeight = 30;
-    
-    // Position header component
-    headerComponent->setBounds(bounds.removeFromTop(headerHeight));
+    auto* rowComponent = dynamic_cast<RowComponent*>(existingComponentToUpdate);
     
-    // Position expand button in header
-    expandButton.setBounds(headerComponent->getWidth() - 25, 2, 20, 26);
-    
-    // Position add/remove buttons if expanded
-    if (expanded)
-    {
-        // Position buttons in the body area
-        auto buttonArea = bounds.removeFromBottom(30).reduced(5);
-        addMappingButton.setBounds(buttonArea.removeFromLeft(100));
-        buttonArea.removeFromLeft(10);
-        
-        // Position mappings list in the body area
-        mappingsList->setBounds(bounds.reduced(5));
-    }
-    else
-    {
-        // Ensure mappings list is hidden when collapsed
-        if (mappingsList != nullptr)
-            mappingsList->setBounds(0, 0, 0, 0);
-    }
-}
-
-void MidiMappingAccordion::ControlItem::buttonClicked(juce::Button* button)
-{
-    if (button == &expandButton)
+    if (rowComponent == nullptr)
     {
-        setExpanded(!expanded);
+        delete existingComponentToUpdate;
+        rowComponent = new RowComponent(*this);
     }
-    else if (button == &addMappingButton)
-    {
-        parent.addMapping(this);
-    }
-}
-
-void MidiMappingAccordion::ControlItem::updateMappings(const std::vector<StandaloneApp::MidiMapping>& newMappings)
-{
-    mappings = newMappings;
-    if (mappingsList != nullptr)
-        mappingsList->updateMappings(mappings);
-    repaint();
+    
+    rowComponent->update(rowNumber);
+    return rowComponent;
 }
 
-void MidiMappingAccordion::ControlItem::setExpanded(bool shouldBeExpanded)
+void MidiMappingAccordion::rebuildRows()
 {
-    if (expanded != shouldBeExpanded)
+    rows.clear();
+    
+    for (int c = 0; c < static_cast<int>(controls.size()); ++c)
     {
-        expanded = shouldBeExpanded;
-        expandButton.setButtonText(expanded ? "-" : "+");
-        
-        // Ensure proper visibility of components
-        if (mappingsList != nullptr)
-            mappingsList->setVisible(expanded);
-        
-        addMappingButton.setVisible(expanded);
+        const auto& control = controls[static_cast<size_t>(c)];
+        rows.push_back({ Row::Kind::Header, c, -1 });
         
-        // Repaint the header component to update the UI
-        if (headerComponent != nullptr)
-            headerComponent->repaint();
+        if (!control.expanded)
+            continue;
         
-        // Store the current viewport position before resizing
-        auto* viewport = findParentComponentOfClass<juce::Viewport>();
-        int scrollY = 0;
-        if (viewport != nullptr)
-            scrollY = viewport->getViewPositionY();
+        if (control.mappings.empty())
+            rows.push_back({ Row::Kind::Empty, c, -1 });
         
-        // Resize this control item
-        resized();
+        for (int m = 0; m < static_cast<int>(control.mappings.size()); ++m)
+            rows.push_back({ Row::Kind::Mapping, c, m });
         
-        // Resize the parent accordion to adjust for the new height
-        parent.resized();
-        
-        // Restore the viewport position after resizing
-        if (viewport != nullptr)
-            viewport->setViewPosition(0, scrollY);
+        rows.push_back({ Row::Kind::AddButton, c, -1 });
     }
 }
 
-void MidiMappingAccordion::ControlItem::setHighlighted(bool shouldBeHighlighted)
+void MidiMappingAccordion::updateMappingData()
 {
-    if (highlighted != shouldBeHighlighted)
+    // Only pick up controls whose mappings actually differ from what we show
+    for (auto& control : controls)
     {
-        highlighted = shouldBeHighlighted;
-        repaint();
+        const auto& current = getAppMappings(control.type, control.index);
+        if (current != control.mappings)
+            control.mappings = current;
     }
+    
+    rebuildRows();
+    listBox.updateContent();
 }
 
-// Implementation of MidiMappingAccordion
-MidiMappingAccordion::MidiMappingAccordion(StandaloneApp& app)
-    : app(app)
+void MidiMappingAccordion::setExpanded(int control, bool shouldBeExpanded)
 {
-    // Initialize mapping data
-    updateMappingData();
+    auto& entry = controls[static_cast<size_t>(control)];
+    if (entry.expanded == shouldBeExpanded)
+        return;
+    
+    entry.expanded = shouldBeExpanded;
+    rebuildRows();
+    listBox.updateContent();
 }
 
-MidiMappingAccordion::~MidiMappingAccordion() = default;
-
-void MidiMappingAccordion::paint(juce::Graphics& g)
+void MidiMappingAccordion::setControlMappings(int control, std::vector<StandaloneApp::MidiMapping> newMappings)
 {
-    g.fillAll(juce::Colours::white);
-    
-    // Draw a subtle border around the entire component
-    g.setColour(juce::Colours::grey.withAlpha(0.5f));
-    g.drawRect(getLocalBounds().toFloat(), 1.0f);
+    controls[static_cast<size_t>(control)].mappings = std::move(newMappings);
+    rebuildRows();
+    listBox.updateContent();
+    updateAppMappings();
 }
 
-void MidiMappingAccordion::resized()
+void MidiMappingAccordion::removeMapping(int control, int mapping)
 {
-    auto area = getLocalBounds();
-    
-    // Position control items with no padding between them
-    int y = 0;
-    
-    for (auto& item : controlItems)
-    {
-        // Calculate height based on expanded state and number of mappings
-        int itemHeight;
-        
-        if (item->isExpanded())
-        {
-            // Base height for header (30px) + button area (30px)
-            itemHeight = 60;
-            
-            // Add height for each mapping (30px per mapping)
-            const auto& mappings = item->getMappings();
-            int mappingsHeight = mappings.empty() ? 30 : static_cast<int>(mappings.size() * 30);
-            
-            // Add some padding at the bottom
-            mappingsHeight += 10;
-            
-            itemHeight += mappingsHeight;
-        }
-        else
-        {
-            // Just the header height when collapsed
-            itemHeight = 30;
-        }
-        
-        // Make items take the full width of the component
-        item->setBounds(0, y, getWidth(), itemHeight);
-        y += itemHeight; // No spacing between items
-    }
+    auto currentMappings = controls[static_cast<size_t>(control)].mappings;
+    if (!juce::isPositiveAndBelow(mapping, static_cast<int>(currentMappings.size())))
+        return;
     
-    // Set the component height based on the total height of all items
-    setSize(getWidth(), y);
+    currentMappings.erase(currentMappings.begin() + mapping);
+    setControlMappings(control, std::move(currentMappings));
 }
 
-void MidiMappingAccordion::buttonClicked(juce::Button* button)
+const std::vector<StandaloneApp::MidiMapping>& MidiMappingAccordion::getAppMappings(const juce::String& controlType, int index) const
 {
-    // Button click handling for other buttons remains
+    auto i = static_cast<size_t>(index);
+    
+    if (controlType == "Axis")
+        return app.axisMappings[i];
+    if (controlType == "Button")
+        return app.buttonMappings[i];
+    if (controlType == "Gyro")
+        return app.gyroMappings[i];
+    if (controlType == "Touchpad")
+        return app.touchpadMappings[i];
+    if (controlType == "Motion")
+        return app.motionMappings[i];
+    
+    return app.accelerometerMappings[i];
 }
 
-void MidiMappingAccordion::updateMappingData()
+juce::String MidiMappingAccordion::getMappingText(const StandaloneApp::MidiMapping& mapping)
 {
-    controlItems.clear();
-    
-    // Add axis mappings
-    for (int i = 0; i < GamepadManager::MAX_AXES; ++i)
-    {
-        auto name = getControlName("Axis", i);
-        auto item = std::make_unique<ControlItem>(name, "Axis", i, app.axisMappings[static_cast<size_t>(i)], *this);
-        controlItems.push_back(std::move(item));
-    }
-    
-    // Add button mappings
-    for (int i = 0; i < GamepadManager::MAX_BUTTONS; ++i)
+    if (mapping.type == StandaloneApp::MidiMapping::Type::ControlChange)
     {
-        auto name = getControlName("Button", i);
-        auto item = std::make_unique<ControlItem>(name, "Button", i, app.buttonMappings[static_cast<size_t>(i)], *this);
-        controlItems.push_back(std::move(item));
+        return juce::String("Ch:") + juce::String(mapping.channel) +
+               " CC:" + juce::String(mapping.ccNumber) +
+               " [" + juce::String(mapping.minValue) + "-" + juce::String(mapping.maxValue) + "]" +
+               getSmoothingText(mapping);
     }
     
-    // Add gyroscope mappings
-    for (int i = 0; i < 3; ++i)
-    {
-        auto name = getControlName("Gyro", i);
-        auto item = std::make_unique<ControlItem>(name, "Gyro", i, app.gyroMappings[static_cast<size_t>(i)], *this);
-        controlItems.push_back(std::move(item));
-    }
+    auto text = juce::String("Ch:") + juce::String(mapping.channel) +
+                " Note:" + juce::String(mapping.noteNumber) +
+                " [" + juce::String(mapping.minValue) + "-" + juce::String(mapping.maxValue) + "]";
     
-    // Add accelerometer mappings
-    for (int i = 0; i < 3; ++i)
+    // Buttons are their own gate
+    if (!mapping.isButton)
     {
-        auto name = getControlName("Accel", i);
-        auto item = std::make_unique<ControlItem>(name, "Accel", i, app.accelerometerMappings[static_cast<size_t>(i)], *this);
-        controlItems.push_back(std::move(item));
+        text += " Gate:" + juce::String(mapping.gateThreshold) + "/" + juce::String(mapping.gateHysteresis) +
+                (mapping.velocitySpeed > 0.0f ? " Vel:" + juce::String(mapping.velocitySpeed) + "/s" : juce::String()) +
+                (mapping.aftertouch ? " AT" : "") +
+                (mapping.scale != StandaloneApp::MidiMapping::Scale::None
+                     ? " " + ScaleQuantiser::getScaleName(mapping.scale) + "/" + juce::String(mapping.scaleRange)
+                     : juce::String()) +
+                getSmoothingText(mapping);
     }
     
-    // Add all items to the component
-    for (auto& item : controlItems)
-    {
-        addAndMakeVisible(item.get());
+    return text;
+}
+
+juce::String MidiMappingAccordion::getSmoothingText(const StandaloneApp::MidiMapping& mapping)
+{
+    switch (mapping.smoothing)
+    {
+        case StandaloneApp::MidiMapping::Smoothing::OneEuro:
+            return " 1Euro:" + juce::String(mapping.smoothingFrequency) + "/" + juce::String(mapping.smoothingBeta);
+        case StandaloneApp::MidiMapping::Smoothing::Ema:
+            return " EMA:" + juce::String(mapping.smoothingFrequency) + "Hz";
+        case StandaloneApp::MidiMapping::Smoothing::Slew:
+            return " Slew:" + juce::String(mapping.smoothingFrequency) + "/s";
+        case StandaloneApp::MidiMapping::Smoothing::None:
+            break;
     }
     
-    resized();
+    return {};
 }
 
-void MidiMappingAccordion::addMapping(ControlItem* controlItem)
+void MidiMappingAccordion::addMapping(int control)
 {
     // Create a dialog to get mapping details
     juce::DialogWindow::LaunchOptions options;
     auto* content = new juce::Component();
-    content->setSize(300, 250);
+    
+    // Smoothing and note gates only apply to continuous controls; the engine
+    // treats the rest as press and release
+    const auto& entry = controls[static_cast<size_t>(control)];
+    bool isButton = MappingBinaryFormat::isButtonSlot(MappingBinaryFormat::getSlot(entry.type, entry.index));
+    bool isContinuous = !isButton;
+    content->setSize(300, isContinuous ? 390 : 250);
     
     auto* channelLabel = new juce::Label("channel", "MIDI Channel:");
     channelLabel->setColour(juce::Label::textColourId, juce::Colours::black);
@@ -519,6 +467,74 @@ void MidiMappingAccordion::addMapping(ControlItem* controlItem)
     maxEditor->setColour(juce::TextEditor::backgroundColourId, juce::Colours::white);
     maxEditor->setText("127");
     
+    auto* smoothingLabel = new juce::Label("smoothing", "Smoothing:");
+    smoothingLabel->setColour(juce::Label::textColourId, juce::Colours::black);
+    auto* smoothingComboBox = new juce::ComboBox("smoothingComboBox");
+    smoothingComboBox->addItem("None", 1);
+    smoothingComboBox->addItem("One-Euro (adaptive)", 2);
+    smoothingComboBox->addItem("EMA (low pass)", 3);
+    smoothingComboBox->addItem("Slew limit", 4);
+    smoothingComboBox->setColour(juce::ComboBox::textColourId, juce::Colours::black);
+    smoothingComboBox->setColour(juce::ComboBox::backgroundColourId, juce::Colours::white);
+    smoothingComboBox->setSelectedId(1);
+    
+    auto* frequencyLabel = new juce::Label("frequency", "Freq:");
+    frequencyLabel->setColour(juce::Label::textColourId, juce::Colours::black);
+    auto* frequencyEditor = new juce::TextEditor();
+    frequencyEditor->setColour(juce::TextEditor::textColourId, juce::Colours::black);
+    frequencyEditor->setColour(juce::TextEditor::backgroundColourId, juce::Colours::white);
+    frequencyEditor->setText("1");
+    
+    auto* betaLabel = new juce::Label("beta", "Beta:");
+    betaLabel->setColour(juce::Label::textColourId, juce::Colours::black);
+    auto* betaEditor = new juce::TextEditor();
+    betaEditor->setColour(juce::TextEditor::textColourId, juce::Colours::black);
+    betaEditor->setColour(juce::TextEditor::backgroundColourId, juce::Colours::white);
+    betaEditor->setText("0.5");
+    
+    auto* gateLabel = new juce::Label("gate", "Gate:");
+    gateLabel->setColour(juce::Label::textColourId, juce::Colours::black);
+    auto* gateEditor = new juce::TextEditor();
+    gateEditor->setColour(juce::TextEditor::textColourId, juce::Colours::black);
+    gateEditor->setColour(juce::TextEditor::backgroundColourId, juce::Colours::white);
+    gateEditor->setText("0.75");
+    
+    auto* hysteresisLabel = new juce::Label("hysteresis", "Hyst:");
+    hysteresisLabel->setColour(juce::Label::textColourId, juce::Colours::black);
+    auto* hysteresisEditor = new juce::TextEditor();
+    hysteresisEditor->setColour(juce::TextEditor::textColourId, juce::Colours::black);
+    hysteresisEditor->setColour(juce::TextEditor::backgroundColourId, juce::Colours::white);
+    hysteresisEditor->setText("0.1");
+    
+    auto* aftertouchToggle = new juce::ToggleButton("Aftertouch while held");
+    aftertouchToggle->setColour(juce::ToggleButton::textColourId, juce::Colours::black);
+    aftertouchToggle->setColour(juce::ToggleButton::tickColourId, juce::Colours::black);
+    
+    // Full range per second that plays the max velocity; 0 uses the value at the crossing
+    auto* velocitySpeedLabel = new juce::Label("velocitySpeed", "Vel. speed:");
+    velocitySpeedLabel->setColour(juce::Label::textColourId, juce::Colours::black);
+    auto* velocitySpeedEditor = new juce::TextEditor();
+    velocitySpeedEditor->setColour(juce::TextEditor::textColourId, juce::Colours::black);
+    velocitySpeedEditor->setColour(juce::TextEditor::backgroundColourId, juce::Colours::white);
+    velocitySpeedEditor->setText("0");
+    
+    // The selected note becomes the root of the scale
+    auto* scaleLabel = new juce::Label("scale", "Scale:");
+    scaleLabel->setColour(juce::Label::textColourId, juce::Colours::black);
+    auto* scaleComboBox = new juce::ComboBox("scaleComboBox");
+    for (int i = 0; i <= static_cast<int>(StandaloneApp::MidiMapping::Scale::Blues); ++i)
+        scaleComboBox->addItem(ScaleQuantiser::getScaleName(static_cast<StandaloneApp::MidiMapping::Scale>(i)), i + 1);
+    scaleComboBox->setColour(juce::ComboBox::textColourId, juce::Colours::black);
+    scaleComboBox->setColour(juce::ComboBox::backgroundColourId, juce::Colours::white);
+    scaleComboBox->setSelectedId(1);
+    
+    auto* scaleRangeLabel = new juce::Label("scaleRange", "Range:");
+    scaleRangeLabel->setColour(juce::Label::textColourId, juce::Colours::black);
+    auto* scaleRangeEditor = new juce::TextEditor();
+    scaleRangeEditor->setColour(juce::TextEditor::textColourId, juce::Colours::black);
+    scaleRangeEditor->setColour(juce::TextEditor::backgroundColourId, juce::Colours::white);
+    scaleRangeEditor->setText("12");
+    
     auto* okButton = new juce::TextButton("OK");
     auto* cancelButton = new juce::TextButton("Cancel");
     
@@ -534,6 +550,40 @@ void MidiMappingAccordion::addMapping(ControlItem* controlItem)
     content->addAndMakeVisible(minEditor);
     content->addAndMakeVisible(maxLabel);
     content->addAndMakeVisible(maxEditor);
+    
+    if (isContinuous)
+    {
+        content->addAndMakeVisible(smoothingLabel);
+        content->addAndMakeVisible(smoothingComboBox);
+        content->addAndMakeVisible(frequencyLabel);
+        content->addAndMakeVisible(frequencyEditor);
+        content->addAndMakeVisible(betaLabel);
+        content->addAndMakeVisible(betaEditor);
+    }
+    else
+    {
+        // Still owned by the content so they are deleted with it
+        content->addChildComponent(smoothingLabel);
+        content->addChildComponent(smoothingComboBox);
+        content->addChildComponent(frequencyLabel);
+        content->addChildComponent(frequencyEditor);
+        content->addChildComponent(betaLabel);
+        content->addChildComponent(betaEditor);
+    }
+    
+    // Shown once Note is selected on a continuous control
+    content->addChildComponent(gateLabel);
+    content->addChildComponent(gateEditor);
+    content->addChildComponent(hysteresisLabel);
+    content->addChildComponent(hysteresisEditor);
+    content->addChildComponent(aftertouchToggle);
+    content->addChildComponent(velocitySpeedLabel);
+    content->addChildComponent(velocitySpeedEditor);
+    content->addChildComponent(scaleLabel);
+    content->addChildComponent(scaleComboBox);
+    content->addChildComponent(scaleRangeLabel);
+    content->addChildComponent(scaleRangeEditor);
+    
     content->addAndMakeVisible(okButton);
     content->addAndMakeVisible(cancelButton);
     
@@ -582,6 +632,46 @@ void MidiMappingAccordion::addMapping(ControlItem* controlItem)
         maxEditor->setBounds(minMaxRow.removeFromLeft(70));
         layoutBounds.removeFromTop(10);
         
+        if (smoothingComboBox->isVisible())
+        {
+            auto smoothingRow = layoutBounds.removeFromTop(20);
+            smoothingLabel->setBounds(smoothingRow.removeFromLeft(70));
+            smoothingComboBox->setBounds(smoothingRow);
+            layoutBounds.removeFromTop(5);
+            
+            auto parameterRow = layoutBounds.removeFromTop(20);
+            frequencyLabel->setBounds(parameterRow.removeFromLeft(70));
+            frequencyEditor->setBounds(parameterRow.removeFromLeft(70));
+            parameterRow.removeFromLeft(5);
+            betaLabel->setBounds(parameterRow.removeFromLeft(70));
+            betaEditor->setBounds(parameterRow.removeFromLeft(70));
+            layoutBounds.removeFromTop(10);
+        }
+        
+        if (gateEditor->isVisible())
+        {
+            auto gateRow = layoutBounds.removeFromTop(20);
+            gateLabel->setBounds(gateRow.removeFromLeft(70));
+            gateEditor->setBounds(gateRow.removeFromLeft(70));
+            gateRow.removeFromLeft(5);
+            hysteresisLabel->setBounds(gateRow.removeFromLeft(70));
+            hysteresisEditor->setBounds(gateRow.removeFromLeft(70));
+            layoutBounds.removeFromTop(5);
+            
+            auto velocityRow = layoutBounds.removeFromTop(20);
+            aftertouchToggle->setBounds(velocityRow.removeFromLeft(145));
+            velocitySpeedLabel->setBounds(velocityRow.removeFromLeft(70));
+            velocitySpeedEditor->setBounds(velocityRow.removeFromLeft(55));
+            layoutBounds.removeFromTop(5);
+            
+            auto scaleRow = layoutBounds.removeFromTop(20);
+            scaleLabel->setBounds(scaleRow.removeFromLeft(70));
+            scaleComboBox->setBounds(scaleRow.removeFromLeft(120));
+            scaleRangeLabel->setBounds(scaleRow.removeFromLeft(50));
+            scaleRangeEditor->setBounds(scaleRow.removeFromLeft(40));
+            layoutBounds.removeFromTop(10);
+        }
+        
         auto buttonArea = layoutBounds.removeFromBottom(30);
         okButton->setBounds(buttonArea.removeFromLeft(100));
         buttonArea.removeFromLeft(10);
@@ -592,7 +682,10 @@ void MidiMappingAccordion::addMapping(ControlItem* controlItem)
     updateLayout();
     
     // Handle type selection change
-    typeComboBox->onChange = [ccEditor, noteComboBox, ccLabel, noteLabel, typeComboBox, updateLayout]() {
+    typeComboBox->onChange = [ccEditor, noteComboBox, ccLabel, noteLabel, typeComboBox, isContinuous,
+                              gateLabel, gateEditor, hysteresisLabel, hysteresisEditor, aftertouchToggle,
+                              velocitySpeedLabel, velocitySpeedEditor, scaleLabel, scaleComboBox, scaleRangeLabel, scaleRangeEditor,
+                              updateLayout]() {
         bool isCC = typeComboBox->getSelectedId() == 1;
         ccEditor->setEnabled(isCC);
         ccEditor->setVisible(isCC);
@@ -601,12 +694,27 @@ void MidiMappingAccordion::addMapping(ControlItem* controlItem)
         noteComboBox->setVisible(!isCC);
         noteLabel->setVisible(!isCC);
         
+        bool isGated = isContinuous && !isCC;
+        gateLabel->setVisible(isGated);
+        gateEditor->setVisible(isGated);
+        hysteresisLabel->setVisible(isGated);
+        hysteresisEditor->setVisible(isGated);
+        aftertouchToggle->setVisible(isGated);
+        velocitySpeedLabel->setVisible(isGated);
+        velocitySpeedEditor->setVisible(isGated);
+        scaleLabel->setVisible(isGated);
+        scaleComboBox->setVisible(isGated);
+        scaleRangeLabel->setVisible(isGated);
+        scaleRangeEditor->setVisible(isGated);
+        
         // Update layout after changing visibility
         updateLayout();
     };
     
     // Handle button clicks
-    okButton->onClick = [this, content, channelEditor, typeComboBox, ccEditor, noteComboBox, minEditor, maxEditor, controlItem]()
+    okButton->onClick = [this, content, channelEditor, typeComboBox, ccEditor, noteComboBox, minEditor, maxEditor,
+                         smoothingComboBox, frequencyEditor, betaEditor, gateEditor, hysteresisEditor, aftertouchToggle, velocitySpeedEditor,
+                         scaleComboBox, scaleRangeEditor, control, isButton]()
     {
         StandaloneApp::MidiMapping mapping;
         mapping.channel = channelEditor->getText().getIntValue();
@@ -627,18 +735,25 @@ void MidiMappingAccordion::addMapping(ControlItem* controlItem)
         
         mapping.minValue = minEditor->getText().getFloatValue();
         mapping.maxValue = maxEditor->getText().getFloatValue();
-        mapping.isButton = (controlItem->getControlType() == "Button");
+        mapping.isButton = isButton;
+        
+        if (!mapping.isButton)
+        {
+            mapping.smoothing = static_cast<StandaloneApp::MidiMapping::Smoothing>(smoothingComboBox->getSelectedId() - 1);
+            mapping.smoothingFrequency = juce::jmax(0.01f, frequencyEditor->getText().getFloatValue());
+            mapping.smoothingBeta = juce::jmax(0.0f, betaEditor->getText().getFloatValue());
+            mapping.gateThreshold = juce::jlimit(0.0f, 1.0f, gateEditor->getText().getFloatValue());
+            mapping.gateHysteresis = juce::jlimit(0.0f, 1.0f, hysteresisEditor->getText().getFloatValue());
+            mapping.aftertouch = aftertouchToggle->getToggleState();
+            mapping.velocitySpeed = juce::jmax(0.0f, velocitySpeedEditor->getText().getFloatValue());
+            mapping.scale = static_cast<StandaloneApp::MidiMapping::Scale>(scaleComboBox->getSelectedId() - 1);
+            mapping.scaleRange = juce::jlimit(0, 127, scaleRangeEditor->getText().getIntValue());
+        }
         
         // Get current mappings and add the new one
-        auto currentMappings = controlItem->getMappings();
+        auto currentMappings = controls[static_cast<size_t>(control)].mappings;
         currentMappings.push_back(mapping);
-        controlItem->updateMappings(currentMappings);
-        
-        // Update app mappings
-        updateAppMappings();
-        
-        // Force a resize of the accordion to adjust for the new item
-        resized();
+        setControlMappings(control, std::move(currentMappings));
         
         if (auto* dialogWindow = content->findParentComponentOfClass<juce::DialogWindow>())
             dialogWindow->closeButtonPressed();
@@ -651,7 +766,7 @@ void MidiMappingAccordion::addMapping(ControlItem* controlItem)
     };
     
     options.content.setOwned(content);
-    options.content->setSize(300, 250);
+    options.content->setSize(300, isContinuous ? 390 : 250);
     options.dialogTitle = "Add MIDI Mapping";
     options.dialogBackgroundColour = juce::Colours::lightgrey;
     options.escapeKeyTriggersCloseButton = true;
@@ -664,36 +779,13 @@ void MidiMappingAccordion::addMapping(ControlItem* controlItem)
 
 void MidiMappingAccordion::updateAppMappings()
 {
-    // Clear existing mappings first
-    for (auto& mappings : app.axisMappings) mappings.clear();
-    for (auto& mappings : app.buttonMappings) mappings.clear();
-    for (auto& mappings : app.gyroMappings) mappings.clear();
-    for (auto& mappings : app.accelerometerMappings) mappings.clear();
-    
-    // Update mappings
-    for (const auto& item : controlItems)
-    {
-        const auto& mappings = item->getMappings();
-        const auto& controlType = item->getControlType();
-        const auto controlIndex = item->getControlIndex();
-        
-        if (controlType == "Axis" && controlIndex >= 0 && controlIndex < GamepadManager::MAX_AXES)
-        {
-            app.axisMappings[static_cast<size_t>(controlIndex)] = mappings;
-        }
-        else if (controlType == "Button" && controlIndex >= 0 && controlIndex < GamepadManager::MAX_BUTTONS)
-        {
-            app.buttonMappings[static_cast<size_t>(controlIndex)] = mappings;
-        }
-        else if (controlType == "Gyro" && controlIndex >= 0 && controlIndex < 3)
-        {
-            app.gyroMappings[static_cast<size_t>(controlIndex)] = mappings;
-        }
-        else if (controlType == "Accel" && controlIndex >= 0 && controlIndex < 3)
-        {
-            app.accelerometerMappings[static_cast<size_t>(controlIndex)] = mappings;
-        }
-    }
+    // Controls not in the list end up with no mappings
+    MidiMappingSet mappings;
+    for (const auto& control : controls)
+        if (auto* target = MappingSerializer::findControl(mappings, control.type, control.index))
+            *target = control.mappings;
+    
+    app.applyMappingSet(mappings);
     
     // Update the gamepad component
     app.updateMidiMappings();
@@ -710,43 +802,14 @@ void MidiMappingAccordion::exportMappings()
                              
     if (chooser.browseForFileToSave(true))
     {
-        juce::File file = chooser.getResult();
-        
-        juce::DynamicObject::Ptr jsonObj = new juce::DynamicObject();
-        
-        // Convert mapping data to JSON
-        juce::Array<juce::var> mappingsArray;
-        for (const auto& item : controlItems)
-        {
-            juce::DynamicObject::Ptr mappingObj = new juce::DynamicObject();
-            mappingObj->setProperty("controlName", item->getName());
-            mappingObj->setProperty("controlType", item->getControlType());
-            mappingObj->setProperty("controlIndex", item->getControlIndex());
-            
-            juce::Array<juce::var> midiMappingsArray;
-            for (const auto& mapping : item->getMappings())
-            {
-                juce::DynamicObject::Ptr midiMappingObj = new juce::DynamicObject();
-                midiMappingObj->setProperty("type", static_cast<int>(mapping.type));
-                midiMappingObj->setProperty("channel", mapping.channel);
-                midiMappingObj->setProperty("ccNumber", mapping.ccNumber);
-                midiMappingObj->setProperty("noteNumber", mapping.noteNumber);
-                midiMappingObj->setProperty("minValue", mapping.minValue);
-                midiMappingObj->setProperty("maxValue", mapping.maxValue);
-                midiMappingObj->setProperty("isButton", mapping.isButton);
-                midiMappingsArray.add(juce::var(midiMappingObj));
-            }
-            mappingObj->setProperty("mappings", midiMappingsArray);
-            mappingsArray.add(juce::var(mappingObj));
-        }
-        
-        jsonObj->setProperty("mappings", mappingsArray);
-        
-        // Convert to JSON string with proper formatting
-        juce::String jsonString = juce::JSON::toString(juce::var(jsonObj), true);
+        // Same layout as the saved mappings, plus readable control names
+        juce::FileOutputStream stream(chooser.getResult());
+        if (!stream.openedOk())
+            return;
         
-        // Write to file
-        file.replaceWithText(jsonString);
+        stream.setPosition(0);
+        stream.truncate();
+        MappingSerializer::write(stream, app.getMappingSet(), {}, &MidiMappingAccordion::getControlName);
     }
 }
 
@@ -758,108 +821,63 @@ void MidiMappingAccordion::loadMappings()
                              
     if (chooser.browseForFileToOpen())
     {
-        juce::File file = chooser.getResult();
-        
-        juce::var json = juce::JSON::parse(file);
-        if (json.isVoid())
-        {
-            return;
-        }
-        
-        if (auto* obj = json.getDynamicObject())
-        {
-            if (auto* mappingsVar = obj->getProperty("mappings").getArray())
-            {
-                // Clear existing mappings
-                for (auto& item : controlItems)
-                {
-                    item->updateMappings(std::vector<StandaloneApp::MidiMapping>());
-                }
-                
-                // Load mappings
-                for (const auto& mappingVar : *mappingsVar)
-                {
-                    if (auto* mappingObj = mappingVar.getDynamicObject())
-                    {
-                        juce::String controlType = mappingObj->getProperty("controlType").toString();
-                        int controlIndex = mappingObj->getProperty("controlIndex");
-                        
-                        // Find the matching control item
-                        for (auto& item : controlItems)
-                        {
-                            if (item->getControlType() == controlType && item->getControlIndex() == controlIndex)
-                            {
-                                if (auto* midiMappingsVar = mappingObj->getProperty("mappings").getArray())
-                                {
-                                    std::vector<StandaloneApp::MidiMapping> mappings;
-                                    
-                                    for (const auto& midiMappingVar : *midiMappingsVar)
-                                    {
-                                        if (auto* midiMappingObj = midiMappingVar.getDynamicObject())
-                                        {
-                                            StandaloneApp::MidiMapping mapping;
-                                            
-                                            if (midiMappingObj->hasProperty("type"))
-                                            {
-                                                mapping.type = static_cast<StandaloneApp::MidiMapping::Type>(
-                                                    midiMappingObj->getProperty("type").operator int());
-                                            }
-                                            else
-                                            {
-                                                mapping.type = StandaloneApp::MidiMapping::Type::ControlChange;
-                                            }
-                                            
-                                            mapping.channel = midiMappingObj->getProperty("channel");
-                                            mapping.ccNumber = midiMappingObj->getProperty("ccNumber");
-                                            mapping.noteNumber = midiMappingObj->hasProperty("noteNumber") ? 
-                                                static_cast<int>(midiMappingObj->getProperty("noteNumber")) : 0;
-                                            mapping.minValue = midiMappingObj->getProperty("minValue");
-                                            mapping.maxValue = midiMappingObj->getProperty("maxValue");
-                                            mapping.isButton = midiMappingObj->getProperty("isButton");
-                                            
-                                            mappings.push_back(mapping);
-                                        }
-                                    }
-                                    
-                                    item->updateMappings(mappings);
-                                }
-                                
-                                break;
-                            }
-                        }
-                    }
-                }
-                
-                updateAppMappings();
-            }
-        }
+        if (auto mappings = MappingSerializer::readFile(chooser.getResult()))
+            applyMappingSet(*mappings);
     }
 }
 
+void MidiMappingAccordion::applyMappingSet(const MidiMappingSet& mappings)
+{
+    // Controls missing from the set end up with no mappings
+    for (auto& control : controls)
+    {
+        if (auto* source = MappingSerializer::findControl(mappings, control.type, control.index))
+            control.mappings = *source;
+        else
+            control.mappings.clear();
+    }
+    
+    rebuildRows();
+    listBox.updateContent();
+    updateAppMappings();
+}
+
 void MidiMappingAccordion::highlightControl(const juce::String& controlType, int controlIndex)
 {
-    // Find the control item that matches the control type and index
-    for (auto& item : controlItems)
+    // Find the control that matches the control type and index
+    for (int c = 0; c < static_cast<int>(controls.size()); ++c)
     {
-        if (item->getControlType() == controlType && item->getControlIndex() == controlIndex)
+        auto& control = controls[static_cast<size_t>(c)];
+        if (control.type != controlType || control.index != controlIndex)
+            continue;
+        
+        // Highlight the control and make it visible
+        control.highlighted = true;
+        control.expanded = true;
+        rebuildRows();
+        listBox.updateContent();
+        
+        // Scroll the header to the top
+        for (int r = 0; r < static_cast<int>(rows.size()); ++r)
         {
-            // Highlight the control and make it visible
-            item->setHighlighted(true);
-            item->setExpanded(true);
-            
-            // Find the parent viewport to scroll to the item
-            if (auto* viewport = findParentComponentOfClass<juce::Viewport>())
+            if (rows[static_cast<size_t>(r)].kind == Row::Kind::Header && rows[static_cast<size_t>(r)].control == c)
             {
-                viewport->setViewPosition(0, item->getY());
+                listBox.getViewport()->setViewPosition(0, r * rowHeight);
+                break;
             }
-            
-            // Start a timer to remove the highlight after a short time
-            juce::Timer::callAfterDelay(1000, [this, item = item.get()]() {
-                item->setHighlighted(false);
-            });
-            
-            break;
         }
+        
+        // Remove the highlight after a short time
+        juce::Timer::callAfterDelay(1000, [safeThis = juce::Component::SafePointer<MidiMappingAccordion>(this), c]()
+        {
+            if (safeThis == nullptr)
+                return;
+            
+            safeThis->controls[static_cast<size_t>(c)].highlighted = false;
+            safeThis->listBox.updateContent();
+        });
+        
+        break;
     }
 }
 
@@ -875,7 +893,7 @@ juce::String MidiMappingAccordion::getMidiNoteName(int midiNoteNumber)
     return juce::String(noteNames[noteIndex]) + juce::String(octave);
 }
 
-juce::String MidiMappingAccordion::getControlName(const juce::String& controlType, int index) const
+juce::String MidiMappingAccordion::getControlName(const juce::String& controlType, int index)
 {
     if (controlType == "Axis")
     {
@@ -932,6 +950,31 @@ juce::String MidiMappingAccordion::getControlName(const juce::String& controlTyp
             default: return "Accel " + juce::String(index);
         }
     }
+    else if (controlType == "Touchpad")
+    {
+        switch (index)
+        {
+            case TouchpadControl::X: return "Touchpad X";
+            case TouchpadControl::Y: return "Touchpad Y";
+            case TouchpadControl::Pressure: return "Touchpad Pressure";
+            case TouchpadControl::Button: return "Touchpad Button";
+            default: return "Touchpad " + juce::String(index);
+        }
+    }
+    else if (controlType == "Motion")
+    {
+        switch (index)
+        {
+            case MotionGesture::Shake: return "Shake";
+            case MotionGesture::FlickLeft: return "Flick Left";
+            case MotionGesture::FlickRight: return "Flick Right";
+            case MotionGesture::FlickUp: return "Flick Up";
+            case MotionGesture::FlickDown: return "Flick Down";
+            case MotionGesture::TiltSnapLeft: return "Tilt-Snap Left";
+            case MotionGesture::TiltSnapRight: return "Tilt-Snap Right";
+            default: return "Motion " + juce::String(index);
+        }
+    }
     
     return controlType + " " + juce::String(index);
 } 
\ No newline at end of file
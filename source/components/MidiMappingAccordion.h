@@ -3,112 +3,121 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_core/juce_core.h>
 #include "../StandaloneApp.h"
+#include "CachedLayer.h"
 
 /**
- * A component that displays and allows editing of MIDI mappings using an accordion-style UI
+ * A component that displays and allows editing of MIDI mappings using an accordion-style UI.
+ * The accordion is flattened into fixed-height rows shown in a juce::ListBox, so only
+ * the rows currently on screen have components and those components are recycled
+ * while scrolling. Mapping changes are diffed per control and only touch the rows
+ * that actually changed.
  */
 class MidiMappingAccordion : public juce::Component,
-                            public juce::Button::Listener
+                            private juce::ListBoxModel
 {
 public:
     MidiMappingAccordion(StandaloneApp& app);
     ~MidiMappingAccordion() override;
-    
+
     void paint(juce::Graphics& g) override;
     void resized() override;
-    
-    // Button::Listener implementation
-    void buttonClicked(juce::Button* button) override;
-    
+
     // Export and load mappings
     void exportMappings();
     void loadMappings();
     
+    // Replace every control's mappings, e.g. with a preset
+    void applyMappingSet(const MidiMappingSet& mappings);
+
     // Highlight a control in the editor
     void highlightControl(const juce::String& controlType, int controlIndex);
     void updateMappingData();
-    
+
 private:
-    // Represents a single control with its mappings
-    class ControlItem : public juce::Component,
-                        public juce::Button::Listener
+    // A single control with its mappings
+    struct ControlEntry
     {
-    public:
-        class MappingsList : public juce::Component,
-                            public juce::Button::Listener
-        {
-        public:
-            MappingsList(const std::vector<StandaloneApp::MidiMapping>& mappings, ControlItem& owner);
-            void paint(juce::Graphics& g) override;
-            void resized() override;
-            void updateMappings(const std::vector<StandaloneApp::MidiMapping>& newMappings);
-            void buttonClicked(juce::Button* button) override;
-            
-        private:
-            void updateRemoveButtons();
-            std::vector<StandaloneApp::MidiMapping> mappings;
-            std::vector<std::unique_ptr<juce::TextButton>> removeButtons;
-            ControlItem& owner;
-        };
-        
-        // Add a custom header component class
-        class HeaderComponent : public juce::Component
+        juce::String name;
+        juce::String type;
+        int index = 0;
+        std::vector<StandaloneApp::MidiMapping> mappings;
+        bool expanded = false;
+        bool highlighted = false;
+    };
+
+    // One visible line of the accordion
+    struct Row
+    {
+        enum class Kind
         {
-        public:
-            HeaderComponent(ControlItem& owner);
-            void paint(juce::Graphics& g) override;
-            void mouseDown(const juce::MouseEvent&) override;
-            
-        private:
-            ControlItem& owner;
+            Header,
+            Mapping,
+            Empty,
+            AddButton
         };
-        
-        ControlItem(const juce::String& name, 
-                   const juce::String& type, 
-                   int index, 
-                   const std::vector<StandaloneApp::MidiMapping>& mappings,
-                   MidiMappingAccordion& parent);
-        
+
+        Kind kind = Kind::Header;
+        int control = 0;
+        int mapping = -1;
+    };
+
+    // Recycled component used for every kind of row
+    class RowComponent : public juce::Component
+    {
+    public:
+        explicit RowComponent(MidiMappingAccordion& accordion);
+
+        void update(int rowNumber);
         void paint(juce::Graphics& g) override;
         void resized() override;
-        void buttonClicked(juce::Button* button) override;
-        
-        void setExpanded(bool shouldBeExpanded);
-        void setHighlighted(bool shouldBeHighlighted);
-        void updateMappings(const std::vector<StandaloneApp::MidiMapping>& newMappings);
-        
-        bool isExpanded() const { return expanded; }
-        const juce::String& getControlType() const { return controlType; }
-        int getControlIndex() const { return controlIndex; }
-        const std::vector<StandaloneApp::MidiMapping>& getMappings() const { return mappings; }
-        const juce::String& getName() const { return controlName; }
-        
-        // Friend declaration to allow MappingsList to access parent
-        friend class MappingsList;
-        
+        void mouseDown(const juce::MouseEvent&) override;
+
     private:
-        juce::String controlName;
-        juce::String controlType;
-        int controlIndex;
-        std::vector<StandaloneApp::MidiMapping> mappings;
-        MidiMappingAccordion& parent;
-        
-        std::unique_ptr<HeaderComponent> headerComponent;
-        juce::TextButton expandButton;
-        juce::TextButton addMappingButton;
-        std::unique_ptr<MappingsList> mappingsList;
-        
-        bool expanded = false;
+        MidiMappingAccordion& owner;
+        Row row;
+
+        // What is currently drawn, so unchanged rows are not repainted
+        juce::String text;
+        juce::String summary;
         bool highlighted = false;
+        bool expanded = false;
+
+        juce::TextButton expandButton;
+        juce::TextButton removeButton { "X" };
+        juce::TextButton addMappingButton { "Add Mapping" };
+
+        // Header gradient and border are rendered once per size
+        CachedLayer headerLayer;
+        juce::Font nameFont { 16.0f };
+        juce::Font summaryFont { 14.0f };
+        juce::Font mappingFont { 14.0f };
+
+        JUCE_DECLARE_NON_COPYABLE(RowComponent)
     };
-    
-    void addMapping(ControlItem* controlItem);
+
+    // ListBoxModel
+    int getNumRows() override;
+    void paintListBoxItem(int rowNumber, juce::Graphics& g, int width, int height, bool rowIsSelected) override;
+    juce::Component* refreshComponentForRow(int rowNumber, bool isRowSelected, juce::Component* existingComponentToUpdate) override;
+
+    void rebuildRows();
+    void setExpanded(int control, bool shouldBeExpanded);
+    void setControlMappings(int control, std::vector<StandaloneApp::MidiMapping> newMappings);
+    void removeMapping(int control, int mapping);
+    void addMapping(int control);
     void updateAppMappings();
-    juce::String getControlName(const juce::String& controlType, int index) const;
+    const std::vector<StandaloneApp::MidiMapping>& getAppMappings(const juce::String& controlType, int index) const;
+    static juce::String getControlName(const juce::String& controlType, int index);
     juce::String getMidiNoteName(int midiNoteNumber);
-    
+    static juce::String getMappingText(const StandaloneApp::MidiMapping& mapping);
+    static juce::String getSmoothingText(const StandaloneApp::MidiMapping& mapping);
+
     StandaloneApp& app;
-    std::vector<std::unique_ptr<ControlItem>> controlItems;
-    
+    std::vector<ControlEntry> controls;
+    std::vector<Row> rows;
+    juce::ListBox listBox;
+
+    static constexpr int rowHeight = 30;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiMappingAccordion)
-}; 
\ No newline at end of file
+};
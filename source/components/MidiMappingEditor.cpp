@@ -5,19 +5,14 @@
 MidiMappingEditor::MidiMappingEditor(StandaloneApp& app)
     : app(app)
 {
-    // Create a viewport to contain the accordion
-    viewport = std::make_unique<juce::Viewport>();
-    viewport->setScrollBarsShown(true, false); // Show vertical scrollbar, hide horizontal
-    viewport->setScrollOnDragEnabled(true);
-    
-    // Create the accordion
+    // The accordion scrolls itself and only builds the rows that are on screen
     accordion = std::make_unique<MidiMappingAccordion>(app);
+    addAndMakeVisible(accordion.get());
     
-    // Add the accordion to the viewport
-    viewport->setViewedComponent(accordion.get(), false);
-    
-    // Add the viewport to this component
-    addAndMakeVisible(viewport.get());
+    // Typing narrows the preset menu; Return opens it
+    presetSearch.setTextToShowWhenEmpty("Search presets", juce::Colours::grey);
+    presetSearch.onReturnKey = [this] { showPresetMenu(); };
+    addAndMakeVisible(presetSearch);
     
     // Set up buttons
     exportButton.setButtonText("Export");
@@ -48,7 +43,10 @@ void MidiMappingEditor::resized()
     auto buttonArea = bounds.removeFromBottom(40);
     buttonArea.reduce(10, 5);
     
-    // Position the buttons
+    // Search box on the left, then the buttons
+    presetSearch.setBounds(buttonArea.removeFromLeft(buttonArea.getWidth() / 3));
+    buttonArea.removeFromLeft(10);
+    
     auto buttonWidth = (buttonArea.getWidth() - 20) / 3; // Three buttons with spacing
     exportButton.setBounds(buttonArea.removeFromLeft(buttonWidth));
     buttonArea.removeFromLeft(10);
@@ -56,18 +54,8 @@ void MidiMappingEditor::resized()
     buttonArea.removeFromLeft(10);
     resetButton.setBounds(buttonArea);
     
-    // Set the viewport to fill the remaining space
-    viewport->setBounds(bounds);
-    
-    // Set a thinner scrollbar
-    viewport->setScrollBarThickness(12);
-    
-    // Set the accordion width to match the viewport width minus the scrollbar width
-    // This ensures content fits within the window width
-    accordion->setSize(viewport->getWidth() - viewport->getScrollBarThickness(), accordion->getHeight());
-    
-    // Make sure the viewport's scrollbars are properly configured
-    viewport->setScrollOnDragEnabled(true);
+    // Let the accordion fill the remaining space
+    accordion->setBounds(bounds);
 }
 
 void MidiMappingEditor::buttonClicked(juce::Button* button)
@@ -78,7 +66,7 @@ void MidiMappingEditor::buttonClicked(juce::Button* button)
     }
     else if (button == &loadButton)
     {
-        loadMappings();
+        showPresetMenu();
     }
     else if (button == &resetButton)
     {
@@ -98,6 +86,91 @@ void MidiMappingEditor::loadMappings()
     app.saveMidiMappings();
 }
 
+void MidiMappingEditor::showPresetMenu()
+{
+    auto& library = app.getPresetLibrary();
+    
+    // Cheap when nothing changed: only new or modified files are opened
+    library.rescan();
+    
+    // Copies, since the library may rescan before the menu returns
+    std::vector<PresetLibrary::Entry> results;
+    for (const auto* entry : library.search(presetSearch.getText()))
+        results.push_back(*entry);
+    
+    juce::PopupMenu menu;
+    int itemId = 1;
+    
+    if (results.empty())
+        menu.addItem(-1, library.getEntries().empty() ? "No presets saved yet" : "No matching presets", false);
+    
+    for (const auto& entry : results)
+    {
+        auto label = entry.name;
+        if (entry.tags.size() > 0)
+            label << "  [" << entry.tags.joinIntoString(", ") << "]";
+        
+        menu.addItem(itemId++, label);
+    }
+    
+    menu.addSeparator();
+    menu.addItem(-2, "Save Current as Preset...");
+    menu.addItem(-3, "Load from File...");
+    
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&loadButton),
+                       [safeThis = juce::Component::SafePointer<MidiMappingEditor>(this), results](int result)
+    {
+        if (safeThis == nullptr || result == 0)
+            return;
+        
+        if (result == -2)
+            safeThis->saveCurrentAsPreset();
+        else if (result == -3)
+            safeThis->loadMappings();
+        else if (result > 0)
+            safeThis->loadPreset(results[static_cast<size_t>(result - 1)]);
+    });
+}
+
+void MidiMappingEditor::loadPreset(const PresetLibrary::Entry& entry)
+{
+    // Only the chosen preset body is parsed
+    if (auto mappings = app.getPresetLibrary().load(entry))
+    {
+        accordion->applyMappingSet(*mappings);
+        app.saveMidiMappings();
+    }
+}
+
+void MidiMappingEditor::saveCurrentAsPreset()
+{
+    auto* window = new juce::AlertWindow("Save Preset", "Name and optional comma separated tags",
+                                         juce::MessageBoxIconType::NoIcon, this);
+    window->addTextEditor("name", {}, "Name");
+    window->addTextEditor("tags", {}, "Tags");
+    window->addButton("Save", 1, juce::KeyPress(juce::KeyPress::returnKey));
+    window->addButton("Cancel", 0, juce::KeyPress(juce::KeyPress::escapeKey));
+    
+    window->enterModalState(true, juce::ModalCallbackFunction::create(
+        [safeThis = juce::Component::SafePointer<MidiMappingEditor>(this), window](int result)
+    {
+        if (safeThis == nullptr || result != 1)
+            return;
+        
+        auto name = window->getTextEditorContents("name").trim();
+        if (name.isEmpty())
+            return;
+        
+        auto tags = juce::StringArray::fromTokens(window->getTextEditorContents("tags"), ",", {});
+        tags.trim();
+        tags.removeEmptyStrings();
+        
+        auto& app = safeThis->app;
+        if (!app.getPresetLibrary().save(name, tags, app.getControllerName(), app.getMappingSet()))
+            juce::Logger::writeToLog("Failed to save preset: " + name);
+    }), true);
+}
+
 void MidiMappingEditor::resetMappings()
 {
     // Reset mappings to defaults
@@ -25,6 +25,11 @@ public:
     void exportMappings();
     void loadMappings();
     
+    // Preset library menu, filtered by the search box
+    void showPresetMenu();
+    void loadPreset(const PresetLibrary::Entry& entry);
+    void saveCurrentAsPreset();
+    
     // Reset mappings to defaults
     void resetMappings();
     
@@ -33,10 +38,10 @@ public:
     
 private:
     StandaloneApp& app;
-    std::unique_ptr<juce::Viewport> viewport;
     std::unique_ptr<MidiMappingAccordion> accordion;
     
     // Buttons
+    juce::TextEditor presetSearch;
     juce::TextButton exportButton;
     juce::TextButton loadButton;
     juce::TextButton resetButton;
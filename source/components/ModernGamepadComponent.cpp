@@ -1,23 +1,19 @@
 #include "ModernGamepadComponent.h"
-#include "MidiCCMapping.h"
 #include "../StandaloneApp.h"
+#include "../TraceRecorder.h"
 
-ModernGamepadComponent::ModernGamepadComponent(const GamepadManager::GamepadState& state, StandaloneApp& app)
-    : gamepadState(state)
+ModernGamepadComponent::ModernGamepadComponent(const GamepadManager& manager, StandaloneApp& app)
+    : gamepadManager(manager)
+    , gamepadState(manager.getGamepadState(0))
     , app(app)
-    , cachedState(state)
     , leftStick("Left Stick", true)   // true indicates it's a stick (not a trigger)
     , rightStick("Right Stick", true)
 {
     setupComponents();
     setupCallbacks();
-    startTimer(33); // ~30fps refresh rate
 }
 
-ModernGamepadComponent::~ModernGamepadComponent()
-{
-    stopTimer();
-}
+ModernGamepadComponent::~ModernGamepadComponent() = default;
 
 void ModernGamepadComponent::setupComponents()
 {
@@ -30,6 +26,9 @@ void ModernGamepadComponent::setupComponents()
     addAndMakeVisible(touchPad);
     addAndMakeVisible(gyroscopeDisplay);
     addAndMakeVisible(accelerometerDisplay);
+    addAndMakeVisible(sequencerStrip);
+    
+    sequencerStrip.onStepClicked = [this](int step) { app.getStepSequencer().toggleStep(step); };
     
     // Add and make visible the control buttons
     addAndMakeVisible(selectButton);
@@ -52,45 +51,55 @@ void ModernGamepadComponent::setupComponents()
     statusLabel.setColour(juce::Label::outlineColourId, juce::Colours::darkgrey);
     statusLabel.setFont(juce::Font(14.0f));
     statusLabel.setBorderSize(juce::BorderSize<int>(1, 10, 1, 1)); // Left: 10px, Others: 1px
+    statusLabel.addMouseListener(this, false);  // Double-click toggles the stats overlay
+    
+    // Stats overlay covers the status label and is hidden until toggled
+    statsLabel.setFont(juce::Font(juce::Font::getDefaultMonospacedFontName(), 11.0f, juce::Font::plain));
+    statsLabel.setJustificationType(juce::Justification::centredLeft);
+    statsLabel.setColour(juce::Label::textColourId, juce::Colours::lime);
+    statsLabel.setColour(juce::Label::backgroundColourId, juce::Colours::black.withAlpha(0.85f));
+    statsLabel.setBorderSize(juce::BorderSize<int>(1, 10, 1, 1));
+    statsLabel.addMouseListener(this, false);
+    addChildComponent(statsLabel);
     
     // Set up button callbacks
     selectButton.onPress = [this]() {
         if (midiLearnMode) {
-            sendMidiCC(MidiCC::SELECT_BUTTON, 1.0f, true);
+            sendInput(InputEvent::Control::Button, 4, 1.0f);
         } else {
-            sendMidiCC(MidiCC::SELECT_BUTTON, 1.0f, true);
-            app.notifyGamepadControlActivated("Button", MidiCC::SELECT_BUTTON);
+            sendInput(InputEvent::Control::Button, 4, 1.0f);
+            app.notifyGamepadControlActivated("Button", 4);
         }
     };
     
     selectButton.onRelease = [this]() {
-        sendMidiCC(MidiCC::SELECT_BUTTON, 0.0f, true);
+        sendInput(InputEvent::Control::Button, 4, 0.0f);
     };
     
     homeButton.onPress = [this]() {
         if (midiLearnMode) {
-            sendMidiCC(MidiCC::HOME_BUTTON, 1.0f, true);
+            sendInput(InputEvent::Control::Button, 5, 1.0f);
         } else {
-            sendMidiCC(MidiCC::HOME_BUTTON, 1.0f, true);
-            app.notifyGamepadControlActivated("Button", MidiCC::HOME_BUTTON);
+            sendInput(InputEvent::Control::Button, 5, 1.0f);
+            app.notifyGamepadControlActivated("Button", 5);
         }
     };
     
     homeButton.onRelease = [this]() {
-        sendMidiCC(MidiCC::HOME_BUTTON, 0.0f, true);
+        sendInput(InputEvent::Control::Button, 5, 0.0f);
     };
     
     cancelButton.onPress = [this]() {
         if (midiLearnMode) {
-            sendMidiCC(MidiCC::CANCEL_BUTTON, 1.0f, true);
+            sendInput(InputEvent::Control::Button, 6, 1.0f);
         } else {
-            sendMidiCC(MidiCC::CANCEL_BUTTON, 1.0f, true);
-            app.notifyGamepadControlActivated("Button", MidiCC::CANCEL_BUTTON);
+            sendInput(InputEvent::Control::Button, 6, 1.0f);
+            app.notifyGamepadControlActivated("Button", 6);
         }
     };
     
     cancelButton.onRelease = [this]() {
-        sendMidiCC(MidiCC::CANCEL_BUTTON, 0.0f, true);
+        sendInput(InputEvent::Control::Button, 6, 0.0f);
     };
 }
 
@@ -102,8 +111,12 @@ void ModernGamepadComponent::setupLayout()
     auto statusArea = bounds.removeFromTop(40);
     auto buttonArea = statusArea.reduced(5).removeFromRight(100);
     statusLabel.setBounds(statusArea.reduced(5).removeFromLeft(statusArea.getWidth() - 115)); // Extra 5px for gap
+    statsLabel.setBounds(statusLabel.getBounds());
     learnModeButton.setBounds(buttonArea);
     
+    // Sequencer steps along the bottom
+    sequencerStrip.setBounds(bounds.removeFromBottom(28).reduced(10, 4));
+    
     // Configure main layout
     mainLayout.flexDirection = juce::FlexBox::Direction::column;
     mainLayout.justifyContent = juce::FlexBox::JustifyContent::flexStart;
@@ -306,19 +319,19 @@ void ModernGamepadComponent::setupCallbacks()
     // ShoulderSection callbacks
     shoulderSection.onButtonStateChanged = [this](const juce::String& button, float value) {
         if (button == "L1") {
-            sendMidiCC(9, value, true);  // L1 is button 9
+            sendInput(InputEvent::Control::Button, 9, value);  // L1 is button 9
             if (value > 0.0f) app.notifyGamepadControlActivated("Button", 9);
         }
         else if (button == "R1") {
-            sendMidiCC(10, value, true);  // R1 is button 10
+            sendInput(InputEvent::Control::Button, 10, value);  // R1 is button 10
             if (value > 0.0f) app.notifyGamepadControlActivated("Button", 10);
         }
         else if (button == "L2") {
-            sendMidiCC(4, value, false);  // L2 is axis 4
+            sendInput(InputEvent::Control::Axis, 4, value);  // L2 is axis 4
             if (value > 0.0f) app.notifyGamepadControlActivated("Axis", 4);
         }
         else if (button == "R2") {
-            sendMidiCC(5, value, false);  // R2 is axis 5
+            sendInput(InputEvent::Control::Axis, 5, value);  // R2 is axis 5
             if (value > 0.0f) app.notifyGamepadControlActivated("Axis", 5);
         }
     };
@@ -326,19 +339,19 @@ void ModernGamepadComponent::setupCallbacks()
     // D-pad callbacks
     dPad.onButtonStateChanged = [this](const juce::String& button, float value) {
         if (button == "Up") {
-            sendMidiCC(11, value, true);  // D-pad Up is button 11
+            sendInput(InputEvent::Control::Button, 11, value);  // D-pad Up is button 11
             if (value > 0.0f) app.notifyGamepadControlActivated("Button", 11);
         }
         else if (button == "Down") {
-            sendMidiCC(12, value, true);  // D-pad Down is button 12
+            sendInput(InputEvent::Control::Button, 12, value);  // D-pad Down is button 12
             if (value > 0.0f) app.notifyGamepadControlActivated("Button", 12);
         }
         else if (button == "Left") {
-            sendMidiCC(13, value, true);  // D-pad Left is button 13
+            sendInput(InputEvent::Control::Button, 13, value);  // D-pad Left is button 13
             if (value > 0.0f) app.notifyGamepadControlActivated("Button", 13);
         }
         else if (button == "Right") {
-            sendMidiCC(14, value, true);  // D-pad Right is button 14
+            sendInput(InputEvent::Control::Button, 14, value);  // D-pad Right is button 14
             if (value > 0.0f) app.notifyGamepadControlActivated("Button", 14);
         }
     };
@@ -346,125 +359,120 @@ void ModernGamepadComponent::setupCallbacks()
     // Face buttons callbacks
     faceButtons.onButtonStateChanged = [this](const juce::String& button, float value) {
         if (button == "A") {
-            sendMidiCC(0, value, true);  // A is button 0
+            sendInput(InputEvent::Control::Button, 0, value);  // A is button 0
             if (value > 0.0f) app.notifyGamepadControlActivated("Button", 0);
         }
         else if (button == "B") {
-            sendMidiCC(1, value, true);  // B is button 1
+            sendInput(InputEvent::Control::Button, 1, value);  // B is button 1
             if (value > 0.0f) app.notifyGamepadControlActivated("Button", 1);
         }
         else if (button == "X") {
-            sendMidiCC(2, value, true);  // X is button 2
+            sendInput(InputEvent::Control::Button, 2, value);  // X is button 2
             if (value > 0.0f) app.notifyGamepadControlActivated("Button", 2);
         }
         else if (button == "Y") {
-            sendMidiCC(3, value, true);  // Y is button 3
+            sendInput(InputEvent::Control::Button, 3, value);  // Y is button 3
             if (value > 0.0f) app.notifyGamepadControlActivated("Button", 3);
         }
     };
 
     // Analog sticks callbacks
     leftStick.onAxisChange = [this](const juce::String& axis, float value) {
-        if (axis == "X") sendMidiCC(0, (value + 1.0f) * 0.5f, false);  // Left stick X is axis 0
-        else if (axis == "Y") sendMidiCC(1, (value + 1.0f) * 0.5f, false);  // Left stick Y is axis 1
+        if (axis == "X") sendInput(InputEvent::Control::Axis, 0, (value + 1.0f) * 0.5f);  // Left stick X is axis 0
+        else if (axis == "Y") sendInput(InputEvent::Control::Axis, 1, (value + 1.0f) * 0.5f);  // Left stick Y is axis 1
     };
 
     leftStick.onLearnClick = [this](const juce::String& control) {
-        if (control == "X") sendMidiCC(0, (gamepadState.axes[0] + 1.0f) * 0.5f, false);
-        else if (control == "Y") sendMidiCC(1, (gamepadState.axes[1] + 1.0f) * 0.5f, false);
-        else if (control == "Press") sendMidiCC(9, gamepadState.buttons[7] ? 1.0f : 0.0f, true);
+        if (control == "X") sendInput(InputEvent::Control::Axis, 0, (gamepadState.axes[0] + 1.0f) * 0.5f);
+        else if (control == "Y") sendInput(InputEvent::Control::Axis, 1, (gamepadState.axes[1] + 1.0f) * 0.5f);
+        else if (control == "Press") sendInput(InputEvent::Control::Button, 7, gamepadState.isButtonDown(7) ? 1.0f : 0.0f);
     };
 
     leftStick.onButtonClick = [this](const juce::String& control) {
         if (control == "X") {
-            sendMidiCC(0, (gamepadState.axes[0] + 1.0f) * 0.5f, false);
+            sendInput(InputEvent::Control::Axis, 0, (gamepadState.axes[0] + 1.0f) * 0.5f);
             app.notifyGamepadControlActivated("Axis", 0);
         }
         else if (control == "Y") {
-            sendMidiCC(1, (gamepadState.axes[1] + 1.0f) * 0.5f, false);
+            sendInput(InputEvent::Control::Axis, 1, (gamepadState.axes[1] + 1.0f) * 0.5f);
             app.notifyGamepadControlActivated("Axis", 1);
         }
         else if (control == "Press") {
-            sendMidiCC(9, gamepadState.buttons[7] ? 1.0f : 0.0f, true);
+            sendInput(InputEvent::Control::Button, 7, gamepadState.isButtonDown(7) ? 1.0f : 0.0f);
             app.notifyGamepadControlActivated("Button", 7);
         }
     };
     
     rightStick.onAxisChange = [this](const juce::String& axis, float value) {
-        if (axis == "X") sendMidiCC(2, (value + 1.0f) * 0.5f, false);  // Right stick X is axis 2
-        else if (axis == "Y") sendMidiCC(3, (value + 1.0f) * 0.5f, false);  // Right stick Y is axis 3
+        if (axis == "X") sendInput(InputEvent::Control::Axis, 2, (value + 1.0f) * 0.5f);  // Right stick X is axis 2
+        else if (axis == "Y") sendInput(InputEvent::Control::Axis, 3, (value + 1.0f) * 0.5f);  // Right stick Y is axis 3
     };
 
     rightStick.onLearnClick = [this](const juce::String& control) {
-        if (control == "X") sendMidiCC(2, (gamepadState.axes[2] + 1.0f) * 0.5f, false);
-        else if (control == "Y") sendMidiCC(3, (gamepadState.axes[3] + 1.0f) * 0.5f, false);
-        else if (control == "Press") sendMidiCC(10, gamepadState.buttons[8] ? 1.0f : 0.0f, true);
+        if (control == "X") sendInput(InputEvent::Control::Axis, 2, (gamepadState.axes[2] + 1.0f) * 0.5f);
+        else if (control == "Y") sendInput(InputEvent::Control::Axis, 3, (gamepadState.axes[3] + 1.0f) * 0.5f);
+        else if (control == "Press") sendInput(InputEvent::Control::Button, 8, gamepadState.isButtonDown(8) ? 1.0f : 0.0f);
     };
 
     rightStick.onButtonClick = [this](const juce::String& control) {
         if (control == "X") {
-            sendMidiCC(2, (gamepadState.axes[2] + 1.0f) * 0.5f, false);
+            sendInput(InputEvent::Control::Axis, 2, (gamepadState.axes[2] + 1.0f) * 0.5f);
             app.notifyGamepadControlActivated("Axis", 2);
         }
         else if (control == "Y") {
-            sendMidiCC(3, (gamepadState.axes[3] + 1.0f) * 0.5f, false);
+            sendInput(InputEvent::Control::Axis, 3, (gamepadState.axes[3] + 1.0f) * 0.5f);
             app.notifyGamepadControlActivated("Axis", 3);
         }
         else if (control == "Press") {
-            sendMidiCC(10, gamepadState.buttons[8] ? 1.0f : 0.0f, true);
+            sendInput(InputEvent::Control::Button, 8, gamepadState.isButtonDown(8) ? 1.0f : 0.0f);
             app.notifyGamepadControlActivated("Button", 8);
         }
     };
     
     // Touchpad callbacks
     touchPad.onButtonStateChanged = [this](const juce::String& control, float value) {
-        if (control == "X") {
-            sendMidiCC(6, value, false);  // Touchpad X is axis 6
-            if (value > 0.0f) app.notifyGamepadControlActivated("Axis", 6);
-        }
-        else if (control == "Y") {
-            sendMidiCC(7, value, false);  // Touchpad Y is axis 7
-            if (value > 0.0f) app.notifyGamepadControlActivated("Axis", 7);
-        }
-        else if (control == "Pressure") {
-            sendMidiCC(8, value, false);  // Touchpad pressure is axis 8
-            if (value > 0.0f) app.notifyGamepadControlActivated("Axis", 8);
-        }
-        else if (control == "Button") {
-            sendMidiCC(15, value, true);  // Touchpad button is button 15
-            if (value > 0.0f) app.notifyGamepadControlActivated("Button", 15);
-        }
+        int index = control == "X" ? TouchpadControl::X
+                  : control == "Y" ? TouchpadControl::Y
+                  : control == "Pressure" ? TouchpadControl::Pressure
+                  : control == "Button" ? TouchpadControl::Button
+                  : -1;
+        
+        if (index < 0)
+            return;
+        
+        sendInput(InputEvent::Control::Touchpad, index, value);
+        if (value > 0.0f) app.notifyGamepadControlActivated("Touchpad", index);
     };
     
     touchPad.onXValueChange = [this](float x) {
-        sendMidiCC(6, (x + 1.0f) * 0.5f, false);  // Touchpad X is axis 6
+        sendInput(InputEvent::Control::Touchpad, TouchpadControl::X, (x + 1.0f) * 0.5f);
     };
     
     touchPad.onYValueChange = [this](float y) {
-        sendMidiCC(7, (y + 1.0f) * 0.5f, false);  // Touchpad Y is axis 7
+        sendInput(InputEvent::Control::Touchpad, TouchpadControl::Y, (y + 1.0f) * 0.5f);
     };
     
     touchPad.onPressureValueChange = [this](float pressure) {
-        sendMidiCC(8, pressure, false);  // Touchpad pressure is axis 8
+        sendInput(InputEvent::Control::Touchpad, TouchpadControl::Pressure, pressure);
     };
 
     touchPad.onButtonValueChange = [this](float value) {
-        sendMidiCC(15, value, true);  // Touchpad button is button 15
+        sendInput(InputEvent::Control::Touchpad, TouchpadControl::Button, value);
     };
     
     // Gyroscope callbacks
     gyroscopeDisplay.onButtonStateChanged = [this](const juce::String& axis, float value) {
         if (!midiLearnMode && value > 0.0f) {
             if (axis == "X") {
-                sendMidiCC(0, (gamepadState.gyroscope.x + 1.0f) * 0.5f, false);
+                sendInput(InputEvent::Control::Gyro, 0, (gamepadState.gyroscope.x + 1.0f) * 0.5f);
                 app.notifyGamepadControlActivated("Gyro", 0);
             }
             else if (axis == "Y") {
-                sendMidiCC(1, (gamepadState.gyroscope.y + 1.0f) * 0.5f, false);
+                sendInput(InputEvent::Control::Gyro, 1, (gamepadState.gyroscope.y + 1.0f) * 0.5f);
                 app.notifyGamepadControlActivated("Gyro", 1);
             }
             else if (axis == "Z") {
-                sendMidiCC(2, (gamepadState.gyroscope.z + 1.0f) * 0.5f, false);
+                sendInput(InputEvent::Control::Gyro, 2, (gamepadState.gyroscope.z + 1.0f) * 0.5f);
                 app.notifyGamepadControlActivated("Gyro", 2);
             }
         }
@@ -474,15 +482,15 @@ void ModernGamepadComponent::setupCallbacks()
     accelerometerDisplay.onButtonStateChanged = [this](const juce::String& axis, float value) {
         if (!midiLearnMode && value > 0.0f) {
             if (axis == "X") {
-                sendMidiCC(3, (gamepadState.accelerometer.x + 1.0f) * 0.5f, false);
+                sendInput(InputEvent::Control::Accel, 0, (gamepadState.accelerometer.x + 1.0f) * 0.5f);
                 app.notifyGamepadControlActivated("Accel", 0);
             }
             else if (axis == "Y") {
-                sendMidiCC(4, (gamepadState.accelerometer.y + 1.0f) * 0.5f, false);
+                sendInput(InputEvent::Control::Accel, 1, (gamepadState.accelerometer.y + 1.0f) * 0.5f);
                 app.notifyGamepadControlActivated("Accel", 1);
             }
             else if (axis == "Z") {
-                sendMidiCC(5, (gamepadState.accelerometer.z + 1.0f) * 0.5f, false);
+                sendInput(InputEvent::Control::Accel, 2, (gamepadState.accelerometer.z + 1.0f) * 0.5f);
                 app.notifyGamepadControlActivated("Accel", 2);
             }
         }
@@ -491,6 +499,8 @@ void ModernGamepadComponent::setupCallbacks()
 
 void ModernGamepadComponent::paint(juce::Graphics& g)
 {
+    GAMEPAD_TRACE_SCOPE("ModernGamepadComponent::paint");
+    
     // Fill background
     g.fillAll(juce::Colours::white);
     
@@ -505,14 +515,17 @@ void ModernGamepadComponent::resized()
 }
 
 void ModernGamepadComponent::updateState(const GamepadManager::GamepadState& newState) {
+    GAMEPAD_TRACE_SCOPE("ModernGamepadComponent::updateState");
+    PerformanceStats::ScopedTiming timing(PerformanceStats::Stage::GuiFrame);
+    
     // Use the already normalized values from GamepadManager
     float l2Value = newState.axes[4];
     float r2Value = newState.axes[5];
 
     // Update shoulder section
     shoulderSection.setState({
-        newState.buttons[9],  // L1
-        newState.buttons[10], // R1
+        newState.isButtonDown(9),  // L1
+        newState.isButtonDown(10), // R1
         l2Value,  // L2
         r2Value,  // R2
         midiLearnMode,
@@ -524,10 +537,10 @@ void ModernGamepadComponent::updateState(const GamepadManager::GamepadState& new
     
     // Update D-pad
     dPad.setState({
-        newState.buttons[11], // Up
-        newState.buttons[12], // Down
-        newState.buttons[13], // Left
-        newState.buttons[14], // Right
+        newState.isButtonDown(11), // Up
+        newState.isButtonDown(12), // Down
+        newState.isButtonDown(13), // Left
+        newState.isButtonDown(14), // Right
         app.buttonMappings[11].empty() ? 0 : app.buttonMappings[11][0].ccNumber,  // Up
         app.buttonMappings[12].empty() ? 0 : app.buttonMappings[12][0].ccNumber,  // Down
         app.buttonMappings[13].empty() ? 0 : app.buttonMappings[13][0].ccNumber,  // Left
@@ -541,62 +554,57 @@ void ModernGamepadComponent::updateState(const GamepadManager::GamepadState& new
         app.buttonMappings[1].empty() ? 0 : app.buttonMappings[1][0].ccNumber,  // B
         app.buttonMappings[2].empty() ? 0 : app.buttonMappings[2][0].ccNumber,  // X
         app.buttonMappings[3].empty() ? 0 : app.buttonMappings[3][0].ccNumber,  // Y
-        newState.buttons[0],  // A
-        newState.buttons[1],  // B
-        newState.buttons[2],  // X
-        newState.buttons[3],  // Y
+        newState.isButtonDown(0),  // A
+        newState.isButtonDown(1),  // B
+        newState.isButtonDown(2),  // X
+        newState.isButtonDown(3),  // Y
         midiLearnMode
     });
 
     // Update select/home/cancel buttons
-    selectButton.setProperties({
-        "Select",
-        app.buttonMappings[MidiCC::SELECT_BUTTON].empty() ? 0 : app.buttonMappings[MidiCC::SELECT_BUTTON][0].ccNumber,
-        false,  // Not pressed by default
-        midiLearnMode
-    });
-    
-    homeButton.setProperties({
-        "Home",
-        app.buttonMappings[MidiCC::HOME_BUTTON].empty() ? 0 : app.buttonMappings[MidiCC::HOME_BUTTON][0].ccNumber,
-        false,  // Not pressed by default
-        midiLearnMode
-    });
-    
-    cancelButton.setProperties({
-        "Cancel",
-        app.buttonMappings[MidiCC::CANCEL_BUTTON].empty() ? 0 : app.buttonMappings[MidiCC::CANCEL_BUTTON][0].ccNumber,
-        false,  // Not pressed by default
-        midiLearnMode
-    });
+    auto selectProps = selectButton.getProperties();
+    selectProps.ccNumber = app.buttonMappings[4].empty() ? 0 : app.buttonMappings[4][0].ccNumber;
+    selectProps.isPressed = false;  // Not pressed by default
+    selectProps.isLearnMode = midiLearnMode;
+    selectButton.setProperties(selectProps);
+    
+    auto homeProps = homeButton.getProperties();
+    homeProps.ccNumber = app.buttonMappings[5].empty() ? 0 : app.buttonMappings[5][0].ccNumber;
+    homeProps.isPressed = false;  // Not pressed by default
+    homeProps.isLearnMode = midiLearnMode;
+    homeButton.setProperties(homeProps);
+    
+    auto cancelProps = cancelButton.getProperties();
+    cancelProps.ccNumber = app.buttonMappings[6].empty() ? 0 : app.buttonMappings[6][0].ccNumber;
+    cancelProps.isPressed = false;  // Not pressed by default
+    cancelProps.isLearnMode = midiLearnMode;
+    cancelButton.setProperties(cancelProps);
 
     // Update analog sticks
     {
-        AnalogStick::State stickState;
+        auto stickState = leftStick.getState();  // Keeps the name without reallocating it
         stickState.isEnabled = true;
         stickState.xValue = juce::jlimit(-1.0f, 1.0f, newState.axes[0]);
         stickState.yValue = juce::jlimit(-1.0f, 1.0f, newState.axes[1]);
-        stickState.isPressed = newState.buttons[7];
+        stickState.isPressed = newState.isButtonDown(7);
         stickState.xCC = app.axisMappings[0].empty() ? 0 : app.axisMappings[0][0].ccNumber;  // Left X
         stickState.yCC = app.axisMappings[1].empty() ? 0 : app.axisMappings[1][0].ccNumber;  // Left Y
         stickState.pressCC = app.buttonMappings[7].empty() ? 0 : app.buttonMappings[7][0].ccNumber;  // Left stick press
         stickState.isLearnMode = midiLearnMode;
-        stickState.name = "Left Stick";
         stickState.isStick = true;
         leftStick.setState(stickState);
     }
 
     {
-        AnalogStick::State stickState;
+        auto stickState = rightStick.getState();  // Keeps the name without reallocating it
         stickState.isEnabled = true;
         stickState.xValue = juce::jlimit(-1.0f, 1.0f, newState.axes[2]);
         stickState.yValue = juce::jlimit(-1.0f, 1.0f, newState.axes[3]);
-        stickState.isPressed = newState.buttons[8];
+        stickState.isPressed = newState.isButtonDown(8);
         stickState.xCC = app.axisMappings[2].empty() ? 0 : app.axisMappings[2][0].ccNumber;  // Right X
         stickState.yCC = app.axisMappings[3].empty() ? 0 : app.axisMappings[3][0].ccNumber;  // Right Y
         stickState.pressCC = app.buttonMappings[8].empty() ? 0 : app.buttonMappings[8][0].ccNumber;  // Right stick press
         stickState.isLearnMode = midiLearnMode;
-        stickState.name = "Right Stick";
         stickState.isStick = true;
         rightStick.setState(stickState);
     }
@@ -610,10 +618,11 @@ void ModernGamepadComponent::updateState(const GamepadManager::GamepadState& new
         padState.pressure = juce::jlimit(0.0f, 1.0f, newState.touchpad.pressure);
         padState.isPressed = newState.touchpad.pressed;
         padState.touched = newState.touchpad.touched;
-        padState.xCC = app.axisMappings[6].empty() ? 0 : app.axisMappings[6][0].ccNumber;  // Touchpad X
-        padState.yCC = app.axisMappings[7].empty() ? 0 : app.axisMappings[7][0].ccNumber;  // Touchpad Y
-        padState.pressureCC = app.axisMappings[8].empty() ? 0 : app.axisMappings[8][0].ccNumber;  // Touchpad pressure
-        padState.buttonCC = app.buttonMappings[15].empty() ? 0 : app.buttonMappings[15][0].ccNumber;  // Touchpad button
+        const auto& touchpad = app.touchpadMappings;
+        padState.xCC = touchpad[TouchpadControl::X].empty() ? 0 : touchpad[TouchpadControl::X][0].ccNumber;
+        padState.yCC = touchpad[TouchpadControl::Y].empty() ? 0 : touchpad[TouchpadControl::Y][0].ccNumber;
+        padState.pressureCC = touchpad[TouchpadControl::Pressure].empty() ? 0 : touchpad[TouchpadControl::Pressure][0].ccNumber;
+        padState.buttonCC = touchpad[TouchpadControl::Button].empty() ? 0 : touchpad[TouchpadControl::Button][0].ccNumber;
         padState.isLearnMode = midiLearnMode;
         touchPad.setState(padState);
     }
@@ -648,14 +657,60 @@ void ModernGamepadComponent::updateState(const GamepadManager::GamepadState& new
         accelerometerDisplay.setState(accelState);
     }
 
-    // Update status label
+    updateStatusLabel(newState);
+}
+
+void ModernGamepadComponent::updateStatusLabel(const GamepadManager::GamepadState& newState)
+{
+    // Only rebuild the text when something it shows has changed
+    if (statusShown
+        && newState.connected == statusConnected
+        && midiLearnMode == statusLearnMode
+        && newState.name == statusName)
+        return;
+
+    statusShown = true;
+    statusConnected = newState.connected;
+    statusLearnMode = midiLearnMode;
+    statusName = newState.name;
+
     statusLabel.setText(newState.connected
         ? "Connected: " + newState.name + (midiLearnMode ? " (Teach Mode)" : "")
         : "Disconnected",
         juce::dontSendNotification);
+}
+
+void ModernGamepadComponent::setStatsOverlayVisible(bool shouldBeVisible)
+{
+    if (shouldBeVisible == statsLabel.isVisible())
+        return;
+    
+    statsLabel.setVisible(shouldBeVisible);
+    
+    if (shouldBeVisible)
+    {
+        previousStats = PerformanceStats::getInstance().getSnapshot();
+        statsLabel.setText("Collecting stats...", juce::dontSendNotification);
+        statsLabel.toFront(false);
+        statsTimer.startTimer(500);
+    }
+    else
+    {
+        statsTimer.stopTimer();
+    }
+}
 
-    cachedState = newState;
-    repaint();
+void ModernGamepadComponent::mouseDoubleClick(const juce::MouseEvent& event)
+{
+    if (event.eventComponent == &statusLabel || event.eventComponent == &statsLabel)
+        setStatsOverlayVisible(!isStatsOverlayVisible());
+}
+
+void ModernGamepadComponent::updateStatsOverlay()
+{
+    auto current = PerformanceStats::getInstance().getSnapshot();
+    statsLabel.setText(PerformanceStats::toSummaryLine(current, previousStats), juce::dontSendNotification);
+    previousStats = current;
 }
 
 void ModernGamepadComponent::setMidiLearnMode(bool enabled)
@@ -688,70 +743,42 @@ void ModernGamepadComponent::setMidiLearnMode(bool enabled)
         cancelProps.isLearnMode = enabled;
         cancelButton.setProperties(cancelProps);
         
-        repaint();
+        // CC labels and the status text depend on learn mode
+        needsUpdate = true;
     }
 }
 
-void ModernGamepadComponent::sendMidiCC(int controlIndex, float value, bool isButton)
+void ModernGamepadComponent::sendInput(InputEvent::Control control, int index, float value)
 {
-    if (isButton)
-    {
-        // Get button mappings
-        const auto& mappings = app.buttonMappings[static_cast<size_t>(controlIndex)];
-        for (const auto& mapping : mappings)
-        {
-            float mappedValue = value * (mapping.maxValue - mapping.minValue) + mapping.minValue;
-            
-            if (mapping.type == StandaloneApp::MidiMapping::Type::ControlChange)
-            {
-                MidiOutputManager::getInstance().sendControlChange(mapping.channel, mapping.ccNumber, static_cast<int>(mappedValue));
-            }
-            else // Note
-            {
-                // For buttons, we send note on when pressed and note off when released
-                if (value > 0.5f)
-                {
-                    MidiOutputManager::getInstance().sendNoteOn(mapping.channel, mapping.noteNumber, mappedValue / 127.0f);
-                }
-                else
-                {
-                    // Send note off with zero velocity
-                    MidiOutputManager::getInstance().sendNoteOn(mapping.channel, mapping.noteNumber, 0.0f);
-                }
-            }
-        }
-    }
-    else
-    {
-        // Get axis mappings
-        const auto& mappings = app.axisMappings[static_cast<size_t>(controlIndex)];
-        for (const auto& mapping : mappings)
-        {
-            float mappedValue = value * (mapping.maxValue - mapping.minValue) + mapping.minValue;
-            
-            if (mapping.type == StandaloneApp::MidiMapping::Type::ControlChange)
-            {
-                MidiOutputManager::getInstance().sendControlChange(mapping.channel, mapping.ccNumber, static_cast<int>(mappedValue));
-            }
-            else // Note
-            {
-                // For axes, we send note on with velocity based on the axis value
-                // We only send note on when the value is above a certain threshold
-                if (mappedValue > 0)
-                {
-                    MidiOutputManager::getInstance().sendNoteOn(mapping.channel, mapping.noteNumber, mappedValue / 127.0f);
-                }
-                else
-                {
-                    // Send note off with zero velocity
-                    MidiOutputManager::getInstance().sendNoteOn(mapping.channel, mapping.noteNumber, 0.0f);
-                }
-            }
-        }
-    }
+    // Same path as the hardware, so on-screen clicks sound exactly like the pad
+    app.getMappingEngine().post(InputEvent::make(InputEvent::Source::Gui, control, index, value));
 }
 
-void ModernGamepadComponent::timerCallback()
+void ModernGamepadComponent::onDisplayRefresh()
 {
+    // The playhead moves without any input, so the strip is checked every frame
+    updateSequencerStrip();
+    
+    // Nothing to do unless the gamepad, the mappings or learn mode changed
+    auto generation = gamepadManager.getStateGeneration();
+    if (generation == lastStateGeneration && !needsUpdate)
+        return;
+    
+    lastStateGeneration = generation;
+    needsUpdate = false;
     updateState(gamepadState);
-} 
\ No newline at end of file
+}
+
+void ModernGamepadComponent::updateSequencerStrip()
+{
+    const auto& sequencer = app.getStepSequencer();
+    const auto& steps = sequencer.getPattern().steps;
+    
+    StepSequencerStrip::State state;
+    for (size_t i = 0; i < steps.size(); ++i)
+        state.activeSteps = static_cast<std::uint16_t>(state.activeSteps | (steps[i].active ? 1u << i : 0u));
+    
+    state.playStep = sequencer.getPlayStep();
+    state.cursor = sequencer.isEditing() ? sequencer.getCursor() : -1;
+    sequencerStrip.setState(state);
+}
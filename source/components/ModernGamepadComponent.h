@@ -13,14 +13,22 @@
 #include "TouchPad.h"
 #include "SensorDisplay.h"
 #include "ClassicButton.h"
+#include "StepSequencerStrip.h"
+#include "MappingEngine.h"
+#include "PerformanceStats.h"
 
 class StandaloneApp;  // Forward declaration
 
-class ModernGamepadComponent : public juce::Component,
-                             private juce::Timer
+/**
+ * Visual representation of the first gamepad. Instead of polling on a timer it
+ * checks the GamepadManager state generation once per display refresh and only
+ * pushes state to the child widgets when something actually changed; each widget
+ * then repaints itself only if its own state differs.
+ */
+class ModernGamepadComponent : public juce::Component
 {
 public:
-    ModernGamepadComponent(const GamepadManager::GamepadState& state, StandaloneApp& app);
+    ModernGamepadComponent(const GamepadManager& manager, StandaloneApp& app);
     ~ModernGamepadComponent() override;
 
     void paint(juce::Graphics& g) override;
@@ -28,15 +36,24 @@ public:
     void updateState(const GamepadManager::GamepadState& newState);
     bool isMidiLearnMode() const { return midiLearnMode; }
     
-    // Call this when MIDI mappings have been updated
-    void midiMappingsChanged() { updateState(gamepadState); }
+    // Call this when MIDI mappings have been updated; picked up on the next frame
+    void midiMappingsChanged() { needsUpdate = true; }
+    
+    // Live pipeline stats over the status label (double-click the label to toggle)
+    void setStatsOverlayVisible(bool shouldBeVisible);
+    bool isStatsOverlayVisible() const { return statsLabel.isVisible(); }
+    void mouseDoubleClick(const juce::MouseEvent& event) override;
 
 private:
     // Reference to gamepad state and app
+    const GamepadManager& gamepadManager;
     const GamepadManager::GamepadState& gamepadState;
     StandaloneApp& app;
-    GamepadManager::GamepadState cachedState;
     bool midiLearnMode = false;
+    
+    // Change tracking, checked once per display refresh
+    std::uint32_t lastStateGeneration = 0;
+    bool needsUpdate = true;
 
     // Child components
     ShoulderSection shoulderSection;
@@ -47,6 +64,7 @@ private:
     TouchPad touchPad;
     SensorDisplay gyroscopeDisplay;
     SensorDisplay accelerometerDisplay;
+    StepSequencerStrip sequencerStrip;
 
     // Layout management
     juce::FlexBox mainLayout;
@@ -57,6 +75,17 @@ private:
     // UI Elements
     juce::TextButton learnModeButton;
     juce::Label statusLabel;
+    
+    // What the status label currently shows
+    bool statusShown = false;
+    bool statusConnected = false;
+    bool statusLearnMode = false;
+    juce::String statusName;
+    
+    // Stats overlay, refreshed twice a second while shown
+    juce::Label statsLabel;
+    PerformanceStats::Snapshot previousStats;
+    juce::TimedCallback statsTimer { [this] { updateStatsOverlay(); } };
 
     // New buttons for select/home/cancel using ClassicButton
     ClassicButton selectButton{ClassicButton::Properties::create("Select")};
@@ -68,8 +97,14 @@ private:
     void setupLayout();
     void setupCallbacks();
     void setMidiLearnMode(bool enabled);
-    void sendMidiCC(int controlIndex, float value, bool isButton);
-    void timerCallback() override;
+    void sendInput(InputEvent::Control control, int index, float value);
+    void updateStatusLabel(const GamepadManager::GamepadState& newState);
+    void updateStatsOverlay();
+    void onDisplayRefresh();
+    void updateSequencerStrip();
+    
+    // Declared last so it is destroyed before anything its callback touches
+    juce::VBlankAttachment vBlankAttachment { this, [this] { onDisplayRefresh(); } };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModernGamepadComponent)
 }; 
\ No newline at end of file
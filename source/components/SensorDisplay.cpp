@@ -1,4 +1,6 @@
 #include "SensorDisplay.h"
+#include "ValueTextCache.h"
+#include "../TraceRecorder.h"
 
 SensorDisplay::SensorDisplay()
 {
@@ -12,11 +14,14 @@ SensorDisplay::SensorDisplay()
 
 void SensorDisplay::setState(const State& newState)
 {
+    if (state == newState)
+        return;
+
     state = newState;
 
     // Update X button
     auto xProps = xButton.getProperties();
-    xProps.text = state.enabled ? "X: " + juce::String(state.x, 2) : "X: --";
+    xProps.text = state.enabled ? ValueTextCache::forX().get(state.x) : ValueTextCache::forX().getUnavailable();
     xProps.ccNumber = state.xCC;
     xProps.isPressed = false;
     xProps.isLearnMode = state.isLearnMode;
@@ -26,7 +31,7 @@ void SensorDisplay::setState(const State& newState)
 
     // Update Y button
     auto yProps = yButton.getProperties();
-    yProps.text = state.enabled ? "Y: " + juce::String(state.y, 2) : "Y: --";
+    yProps.text = state.enabled ? ValueTextCache::forY().get(state.y) : ValueTextCache::forY().getUnavailable();
     yProps.ccNumber = state.yCC;
     yProps.isPressed = false;
     yProps.isLearnMode = state.isLearnMode;
@@ -36,7 +41,7 @@ void SensorDisplay::setState(const State& newState)
 
     // Update Z button
     auto zProps = zButton.getProperties();
-    zProps.text = state.enabled ? "Z: " + juce::String(state.z, 2) : "Z: --";
+    zProps.text = state.enabled ? ValueTextCache::forZ().get(state.z) : ValueTextCache::forZ().getUnavailable();
     zProps.ccNumber = state.zCC;
     zProps.isPressed = false;
     zProps.isLearnMode = state.isLearnMode;
@@ -69,6 +74,8 @@ void SensorDisplay::resized()
 
 void SensorDisplay::paint(juce::Graphics& g)
 {
+    GAMEPAD_TRACE_SCOPE("SensorDisplay::paint");
+
     auto bounds = getLocalBounds().toFloat();
     
     // Draw background
@@ -18,6 +18,8 @@ public:
         int zCC = -1;
         bool isLearnMode = false;
         bool isAccelerometer = false;  // true for accelerometer, false for gyroscope
+
+        bool operator==(const State&) const = default;
     };
 
     SensorDisplay();
@@ -13,23 +13,24 @@ ShoulderSection::ShoulderSection()
 
 void ShoulderSection::setState(const State& newState)
 {
+    if (state == newState)
+        return;
+
     state = newState;
 
     // Update L1 button
-    l1Button.setProperties({
-        "L1",
-        state.l1CC,
-        state.l1Pressed,
-        state.isLearnMode
-    });
+    auto l1Props = l1Button.getProperties();
+    l1Props.ccNumber = state.l1CC;
+    l1Props.isPressed = state.l1Pressed;
+    l1Props.isLearnMode = state.isLearnMode;
+    l1Button.setProperties(l1Props);
 
     // Update R1 button
-    r1Button.setProperties({
-        "R1",
-        state.r1CC,
-        state.r1Pressed,
-        state.isLearnMode
-    });
+    auto r1Props = r1Button.getProperties();
+    r1Props.ccNumber = state.r1CC;
+    r1Props.isPressed = state.r1Pressed;
+    r1Props.isLearnMode = state.isLearnMode;
+    r1Button.setProperties(r1Props);
 
     // Update L2 trigger - preserve existing properties
     auto l2Props = l2Trigger.getProperties();
@@ -19,6 +19,8 @@ public:
         int r1CC = -1;
         int l2CC = -1;
         int r2CC = -1;
+
+        bool operator==(const State&) const = default;
     };
 
     ShoulderSection();
@@ -0,0 +1,76 @@
+#include "StepSequencerStrip.h"
+#include "../TraceRecorder.h"
+
+StepSequencerStrip::StepSequencerStrip()
+{
+    setOpaque(true);
+}
+
+void StepSequencerStrip::setState(const State& newState)
+{
+    if (state == newState)
+        return;
+
+    // Only the cells whose look changed: toggled steps, old and new playhead and cursor
+    auto changedSteps = static_cast<std::uint16_t>(state.activeSteps ^ newState.activeSteps);
+    for (auto step : { state.playStep, newState.playStep, state.cursor, newState.cursor })
+        if (juce::isPositiveAndBelow(step, StepSequencer::numSteps))
+            changedSteps = static_cast<std::uint16_t>(changedSteps | (1u << step));
+
+    state = newState;
+
+    for (int step = 0; step < StepSequencer::numSteps; ++step)
+        if ((changedSteps >> step) & 1)
+            repaint(getCellBounds(step));
+}
+
+void StepSequencerStrip::paint(juce::Graphics& g)
+{
+    GAMEPAD_TRACE_SCOPE("StepSequencerStrip::paint");
+
+    g.fillAll(juce::Colour(192, 192, 192));
+
+    auto clip = g.getClipBounds();
+
+    for (int step = 0; step < StepSequencer::numSteps; ++step)
+    {
+        auto cell = getCellBounds(step);
+        if (!cell.intersects(clip))
+            continue;
+
+        bool active = (state.activeSteps >> step) & 1;
+        auto body = cell.reduced(2);
+
+        // Beats are a shade darker so the bar is easy to read
+        g.setColour(active ? juce::Colour(0, 0, 255) : (step % 4 == 0 ? juce::Colour(200, 200, 200) : juce::Colour(220, 220, 220)));
+        g.fillRect(body);
+
+        if (step == state.playStep)
+        {
+            g.setColour(juce::Colours::orange.withAlpha(0.7f));
+            g.fillRect(body);
+        }
+
+        g.setColour(juce::Colours::darkgrey);
+        g.drawRect(body, step == state.cursor ? 2 : 1);
+    }
+}
+
+void StepSequencerStrip::mouseDown(const juce::MouseEvent& event)
+{
+    for (int step = 0; step < StepSequencer::numSteps; ++step)
+    {
+        if (getCellBounds(step).contains(event.getPosition()))
+        {
+            if (onStepClicked)
+                onStepClicked(step);
+            return;
+        }
+    }
+}
+
+juce::Rectangle<int> StepSequencerStrip::getCellBounds(int step) const
+{
+    auto width = getWidth() / StepSequencer::numSteps;
+    return { step * width, 0, width, getHeight() };
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <cstdint>
+#include "StepSequencer.h"
+
+/**
+ * Row of the sixteen sequencer steps with the playhead and the edit cursor.
+ * A change only repaints the cells it touches, so the moving playhead costs
+ * two small cells per step rather than the whole gamepad view.
+ */
+class StepSequencerStrip : public juce::Component {
+public:
+    struct State {
+        std::uint16_t activeSteps = 0;
+        int playStep = -1;
+        int cursor = -1;    // -1 unless editing
+
+        bool operator==(const State&) const = default;
+    };
+
+    StepSequencerStrip();
+    ~StepSequencerStrip() override = default;
+
+    void setState(const State& newState);
+    const State& getState() const { return state; }
+
+    // Clicking a step toggles it
+    std::function<void(int)> onStepClicked;
+
+    // Component overrides
+    void paint(juce::Graphics& g) override;
+    void mouseDown(const juce::MouseEvent& event) override;
+
+private:
+    State state;
+
+    juce::Rectangle<int> getCellBounds(int step) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StepSequencerStrip)
+};
@@ -1,4 +1,6 @@
 #include "TouchPad.h"
+#include "ValueTextCache.h"
+#include "../TraceRecorder.h"
 
 TouchPad::TouchPad()
 {
@@ -13,42 +15,50 @@ TouchPad::TouchPad()
 
 void TouchPad::setState(const State& newState)
 {
-    state = newState;
+    auto updated = newState;
     
     // Set touched state based on pressure
-    state.touched = state.pressure > 0.0f;
+    updated.touched = updated.pressure > 0.0f;
+    
+    if (state == updated)
+        return;
+    
+    state = updated;
 
     // Update X axis button with value
-    xButton.setProperties({
-        "X: " + juce::String(state.xValue, 2),
-        state.xCC,
-        false,  // We don't show pressed state for axis
-        state.isLearnMode
-    });
+    auto xProps = xButton.getProperties();
+    xProps.text = ValueTextCache::forX().get(state.xValue);
+    xProps.ccNumber = state.xCC;
+    xProps.isPressed = false;  // We don't show pressed state for axis
+    xProps.isLearnMode = state.isLearnMode;
+    xButton.setProperties(xProps);
 
     // Update Y axis button with value
-    yButton.setProperties({
-        "Y: " + juce::String(state.yValue, 2),
-        state.yCC,
-        false,  // We don't show pressed state for axis
-        state.isLearnMode
-    });
+    auto yProps = yButton.getProperties();
+    yProps.text = ValueTextCache::forY().get(state.yValue);
+    yProps.ccNumber = state.yCC;
+    yProps.isPressed = false;  // We don't show pressed state for axis
+    yProps.isLearnMode = state.isLearnMode;
+    yButton.setProperties(yProps);
 
     // Update pressure button
-    pressureButton.setProperties({
-        "P: " + juce::String(state.pressure, 2),
-        state.pressureCC,
-        false,  // We don't show pressed state for pressure
-        state.isLearnMode
-    });
+    auto pressureProps = pressureButton.getProperties();
+    pressureProps.text = ValueTextCache::forPressure().get(state.pressure);
+    pressureProps.ccNumber = state.pressureCC;
+    pressureProps.isPressed = false;  // We don't show pressed state for pressure
+    pressureProps.isLearnMode = state.isLearnMode;
+    pressureButton.setProperties(pressureProps);
 
     // Update button press button
-    buttonPressButton.setProperties({
-        "Button: " + juce::String(state.isPressed ? "On" : "Off"),
-        state.buttonCC,
-        state.isPressed,  // Show pressed state for button
-        state.isLearnMode
-    });
+    static const juce::String buttonOnText("Button: On");
+    static const juce::String buttonOffText("Button: Off");
+    
+    auto buttonPressProps = buttonPressButton.getProperties();
+    buttonPressProps.text = state.isPressed ? buttonOnText : buttonOffText;
+    buttonPressProps.ccNumber = state.buttonCC;
+    buttonPressProps.isPressed = state.isPressed;  // Show pressed state for button
+    buttonPressProps.isLearnMode = state.isLearnMode;
+    buttonPressButton.setProperties(buttonPressProps);
 
     updateTouchPosition();
     repaint();
@@ -95,10 +105,18 @@ void TouchPad::resized()
 
 void TouchPad::paint(juce::Graphics& g)
 {
+    GAMEPAD_TRACE_SCOPE("TouchPad::paint");
+
     if (!state.isEnabled) return;
 
-    drawTouchArea(g);
-    drawLabels(g);
+    // Background and grid only change on resize
+    backgroundLayer.draw(g, getLocalBounds(), 0, [this](juce::Graphics& layer)
+    {
+        drawTouchArea(layer);
+        drawLabels(layer);
+    });
+
+    drawTouchPoint(g);
 }
 
 void TouchPad::setupCallbacks()
@@ -179,7 +197,10 @@ void TouchPad::drawTouchArea(juce::Graphics& g)
         g.drawVerticalLine(static_cast<int>(x), touchArea.getY(), touchArea.getBottom());
         g.drawHorizontalLine(static_cast<int>(y), touchArea.getX(), touchArea.getRight());
     }
+}
 
+void TouchPad::drawTouchPoint(juce::Graphics& g)
+{
     // Draw touch point when touchpad is being touched
     if (state.touched)
     {
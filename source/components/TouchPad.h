@@ -3,6 +3,7 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_graphics/juce_graphics.h>
 #include "ClassicButton.h"
+#include "CachedLayer.h"
 
 class TouchPad : public juce::Component
 {
@@ -19,12 +20,15 @@ public:
         int pressureCC = 0;
         int buttonCC = 0;  // Added for button press
         bool isLearnMode = false;
+
+        bool operator==(const State&) const = default;
     };
 
     TouchPad();
     ~TouchPad() override = default;
 
     void setState(const State& newState);
+    const State& getState() const { return state; }
     void resized() override;
     void paint(juce::Graphics& g) override;
 
@@ -77,9 +81,13 @@ private:
     float touchRadius = 10.0f;
     float pressureBarHeight = 20.0f;
 
+    // Pre-rendered touch area and grid
+    CachedLayer backgroundLayer;
+
     void setupCallbacks();
     void updateTouchPosition();
     void drawTouchArea(juce::Graphics& g);
+    void drawTouchPoint(juce::Graphics& g);
     void drawPressureBar(juce::Graphics& g);
     void drawLabels(juce::Graphics& g);
 
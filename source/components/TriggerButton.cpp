@@ -1,4 +1,5 @@
 #include "TriggerButton.h"
+#include "../TraceRecorder.h"
 
 TriggerButton::TriggerButton(const Properties& initialProps)
     : props(initialProps)
@@ -8,12 +9,18 @@ TriggerButton::TriggerButton(const Properties& initialProps)
 
 void TriggerButton::setProperties(const Properties& newProps)
 {
+    // Only repaint when something visible actually changed
+    if (props == newProps)
+        return;
+
     props = newProps;
     repaint();
 }
 
 void TriggerButton::paint(juce::Graphics& g)
 {
+    GAMEPAD_TRACE_SCOPE("TriggerButton::paint");
+
     if (props.isLearnMode && props.ccNumber >= 0)
         drawLearnStyle(g);
     else
@@ -16,6 +16,8 @@ public:
         juce::Colour progressColor;
         juce::Colour backgroundColor;
         juce::Colour textColor;
+
+        bool operator==(const Properties&) const = default;
     };
 
     explicit TriggerButton(const Properties& initialProps = Properties{
@@ -0,0 +1,40 @@
+#include "ValueTextCache.h"
+
+ValueTextCache::ValueTextCache(const juce::String& prefix)
+    : unavailable(prefix + "--")
+{
+    labels.reserve(static_cast<size_t>(maxHundredths * 2 + 1));
+
+    for (int hundredths = -maxHundredths; hundredths <= maxHundredths; ++hundredths)
+        labels.push_back(prefix + juce::String(hundredths / 100.0, 2));
+}
+
+const juce::String& ValueTextCache::get(float value) const noexcept
+{
+    auto hundredths = juce::jlimit(-maxHundredths, maxHundredths, juce::roundToInt(value * 100.0f));
+    return labels[static_cast<size_t>(hundredths + maxHundredths)];
+}
+
+const ValueTextCache& ValueTextCache::forX()
+{
+    static const ValueTextCache cache("X: ");
+    return cache;
+}
+
+const ValueTextCache& ValueTextCache::forY()
+{
+    static const ValueTextCache cache("Y: ");
+    return cache;
+}
+
+const ValueTextCache& ValueTextCache::forZ()
+{
+    static const ValueTextCache cache("Z: ");
+    return cache;
+}
+
+const ValueTextCache& ValueTextCache::forPressure()
+{
+    static const ValueTextCache cache("P: ");
+    return cache;
+}
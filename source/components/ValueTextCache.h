@@ -0,0 +1,35 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <vector>
+
+/**
+ * Preformatted "<prefix><value>" label strings for values shown with two decimals
+ * in the -1.00 to 1.00 range. Every label is formatted once up front, so widget
+ * updates just copy a reference-counted juce::String and never allocate.
+ */
+class ValueTextCache
+{
+public:
+    explicit ValueTextCache(const juce::String& prefix);
+
+    // Label for a value, clamped to the cached range
+    const juce::String& get(float value) const noexcept;
+
+    // "<prefix>--" for sensors that are not available
+    const juce::String& getUnavailable() const noexcept { return unavailable; }
+
+    // Shared caches for the prefixes used by the gamepad widgets
+    static const ValueTextCache& forX();
+    static const ValueTextCache& forY();
+    static const ValueTextCache& forZ();
+    static const ValueTextCache& forPressure();
+
+private:
+    static constexpr int maxHundredths = 100;
+
+    std::vector<juce::String> labels;
+    juce::String unavailable;
+
+    JUCE_DECLARE_NON_COPYABLE(ValueTextCache)
+};
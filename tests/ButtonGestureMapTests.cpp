@@ -0,0 +1,178 @@
+#include "ButtonGestureMap.h"
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    constexpr ButtonGestureMap::ButtonMask bit (int button)
+    {
+        return ButtonGestureMap::ButtonMask { 1 } << button;
+    }
+
+    const auto a = bit (ButtonGestureMap::findButton ("A"));
+    const auto b = bit (ButtonGestureMap::findButton ("B"));
+    const auto l1 = bit (ButtonGestureMap::findButton ("L1"));
+    const auto r1 = bit (ButtonGestureMap::findButton ("R1"));
+    const auto start = bit (ButtonGestureMap::findButton ("Start"));
+
+    // A map holding just the one rule, enabled, so it is rule 0
+    void useRule (ButtonGestureMap& map, ButtonGestureMap::Kind kind, ButtonGestureMap::ButtonMask buttons, int timeMs = 0)
+    {
+        ButtonGestureMap::Rule rule;
+        rule.kind = kind;
+        rule.buttons = buttons;
+        rule.timeMs = timeMs;
+        rule.action.number = 20;
+
+        REQUIRE (map.setRules ({ rule }));
+        map.setEnabled (true);
+    }
+}
+
+TEST_CASE ("Chords need every button inside the window", "[gestures]")
+{
+    ButtonGestureMap map;
+    useRule (map, ButtonGestureMap::Kind::Chord, a | b);
+
+    SECTION ("Pressed 50 ms apart")
+    {
+        map.process (a, 1.0);
+        CHECK_FALSE (map.isActive (0));
+
+        map.process (a | b, 1.05);
+        CHECK (map.isActive (0));
+
+        map.process (b, 1.1);
+        CHECK_FALSE (map.isActive (0));
+    }
+
+    SECTION ("Pressed in the same frame")
+    {
+        map.process (a | b, 1.0);
+        CHECK (map.isActive (0));
+    }
+
+    SECTION ("Pressed 80 ms apart is too slow")
+    {
+        map.process (a, 1.0);
+        map.process (a | b, 1.08);
+        CHECK_FALSE (map.isActive (0));
+    }
+
+    SECTION ("A longer window of its own")
+    {
+        useRule (map, ButtonGestureMap::Kind::Chord, a | b, 100);
+
+        map.process (a, 1.0);
+        map.process (a | b, 1.08);
+        CHECK (map.isActive (0));
+    }
+}
+
+TEST_CASE ("Double taps need two short presses close together", "[gestures]")
+{
+    ButtonGestureMap map;
+    useRule (map, ButtonGestureMap::Kind::DoubleTap, r1);
+
+    SECTION ("Second press 200 ms after the first")
+    {
+        map.process (r1, 1.0);
+        map.process (0, 1.1);
+        CHECK (map.isWaiting());
+        CHECK_FALSE (map.isActive (0));
+
+        map.process (r1, 1.2);
+        CHECK (map.isActive (0));
+        CHECK_FALSE (map.isWaiting());
+
+        map.process (0, 1.3);
+        CHECK_FALSE (map.isActive (0));
+    }
+
+    SECTION ("Second press after the 300 ms gap")
+    {
+        map.process (r1, 1.0);
+        map.process (0, 1.1);
+        map.process (0, 1.32);
+        CHECK_FALSE (map.isWaiting());
+
+        // Only the first tap of a new pair
+        map.process (r1, 1.35);
+        CHECK_FALSE (map.isActive (0));
+    }
+
+    SECTION ("A first press held too long is not a tap")
+    {
+        map.process (r1, 1.0);
+        map.process (r1, 1.35);
+        map.process (0, 1.4);
+        map.process (r1, 1.45);
+        CHECK_FALSE (map.isActive (0));
+    }
+}
+
+TEST_CASE ("Long presses turn on after the hold time", "[gestures]")
+{
+    ButtonGestureMap map;
+    useRule (map, ButtonGestureMap::Kind::LongPress, start);
+
+    SECTION ("Held for 500 ms")
+    {
+        map.process (start, 1.0);
+        map.process (start, 1.4);
+        CHECK (map.isWaiting());
+        CHECK_FALSE (map.isActive (0));
+
+        map.process (start, 1.5);
+        CHECK (map.isActive (0));
+
+        map.process (0, 1.6);
+        CHECK_FALSE (map.isActive (0));
+    }
+
+    SECTION ("Let go early")
+    {
+        map.process (start, 1.0);
+        map.process (0, 1.3);
+        CHECK_FALSE (map.isWaiting());
+
+        map.process (0, 1.6);
+        CHECK_FALSE (map.isActive (0));
+    }
+}
+
+TEST_CASE ("Layers keep shifted presses from their own mappings", "[gestures]")
+{
+    ButtonGestureMap map;
+
+    ButtonGestureMap::Rule layer;
+    layer.kind = ButtonGestureMap::Kind::Layer;
+    layer.buttons = l1;
+    layer.trigger = ButtonGestureMap::findButton ("A");
+    REQUIRE (map.setRules ({ layer }));
+    map.setEnabled (true);
+
+    SECTION ("Modifier then trigger")
+    {
+        CHECK (map.process (l1, 1.0) == l1);
+        CHECK (map.process (l1 | a, 1.1) == a);
+        CHECK (map.isActive (0));
+
+        // The release is swallowed too, even after the modifier went first
+        CHECK (map.process (a, 1.2) == l1);
+        CHECK_FALSE (map.isActive (0));
+        CHECK (map.process (0, 1.3) == a);
+    }
+
+    SECTION ("The trigger on its own is a plain press")
+    {
+        CHECK (map.process (a, 1.0) == 0);
+        CHECK_FALSE (map.isActive (0));
+    }
+
+    SECTION ("Nothing happens while disabled")
+    {
+        map.setEnabled (false);
+        CHECK (map.process (l1 | a, 1.0) == 0);
+        CHECK_FALSE (map.isActive (0));
+    }
+}
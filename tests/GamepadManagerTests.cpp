@@ -0,0 +1,29 @@
+#include "GamepadManager.h"
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE ("GamepadManager starts with no gamepads", "[gamepad]")
+{
+    GamepadManager manager;
+
+    SECTION ("Initial State")
+    {
+        // Check initial state
+        REQUIRE (manager.getNumConnectedGamepads() == 0);
+
+        // Check invalid index returns not connected
+        REQUIRE_FALSE (manager.isGamepadConnected (-1));
+        REQUIRE_FALSE (manager.isGamepadConnected (GamepadManager::MAX_GAMEPADS));
+
+        // Check first gamepad state
+        const auto& state = manager.getGamepadState (0);
+        REQUIRE_FALSE (state.connected);
+        REQUIRE (state.name.isEmpty());
+
+        // Check all axes are zero
+        for (const auto& axis : state.axes)
+            REQUIRE (axis == 0.0f);
+
+        // No button is pressed
+        REQUIRE (state.buttons == 0);
+    }
+}
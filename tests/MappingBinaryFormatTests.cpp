@@ -0,0 +1,216 @@
+#include "MappingBinaryFormat.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstring>
+
+namespace
+{
+    MidiMapping makeMapping (int seed, bool isButton)
+    {
+        MidiMapping mapping;
+        mapping.type = seed % 2 == 0 ? MidiMapping::Type::ControlChange : MidiMapping::Type::Note;
+        mapping.channel = 1 + seed % 16;
+        mapping.ccNumber = seed % 128;
+        mapping.noteNumber = 36 + seed % 48;
+        mapping.minValue = 0.0f;
+        mapping.maxValue = 100.0f + static_cast<float> (seed % 27);
+        mapping.isButton = isButton;
+        mapping.smoothing = static_cast<MidiMapping::Smoothing> (seed % 4);
+        mapping.smoothingFrequency = 0.5f + static_cast<float> (seed);
+        mapping.smoothingBeta = 0.01f * static_cast<float> (seed);
+        mapping.gateThreshold = 0.6f;
+        mapping.gateHysteresis = 0.05f;
+        mapping.aftertouch = seed % 3 == 0;
+        mapping.velocitySpeed = seed % 5 == 0 ? 4.0f : 0.0f;
+        mapping.scale = static_cast<MidiMapping::Scale> (seed % 8);
+        mapping.scaleRange = 7 + seed % 17;
+        return mapping;
+    }
+
+    // Every group carries mappings, some controls several and some none
+    MidiMappingSet makeLayout()
+    {
+        MidiMappingSet set;
+        int seed = 0;
+
+        auto fill = [&seed] (auto& group, bool isButton) {
+            for (size_t i = 0; i < group.size(); ++i)
+                for (size_t m = 0; m < i % 3; ++m)
+                    group[i].push_back (makeMapping (seed++, isButton));
+        };
+
+        fill (set.axisMappings, false);
+        fill (set.buttonMappings, true);
+        fill (set.gyroMappings, false);
+        fill (set.accelerometerMappings, false);
+        fill (set.touchpadMappings, false);
+        fill (set.motionMappings, true);
+        return set;
+    }
+
+    std::uint32_t fnv1a (const char* bytes, size_t size)
+    {
+        std::uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < size; ++i)
+            hash = (hash ^ static_cast<std::uint8_t> (bytes[i])) * 16777619u;
+        return hash;
+    }
+
+    // Lets a test corrupt the data without the checksum catching it first
+    void updateChecksum (juce::MemoryBlock& block)
+    {
+        using MappingBinaryFormat::Header;
+
+        auto* bytes = static_cast<char*> (block.getData());
+        auto checksum = fnv1a (bytes + sizeof (Header), block.getSize() - sizeof (Header));
+        std::memcpy (bytes + offsetof (Header, checksum), &checksum, sizeof (checksum));
+    }
+
+    bool isValid (const juce::MemoryBlock& block)
+    {
+        return MappingBinaryView (block.getData(), block.getSize()).isValid();
+    }
+}
+
+TEST_CASE ("Binary mappings round trip", "[binary]")
+{
+    auto layout = makeLayout();
+
+    SECTION ("In memory")
+    {
+        auto block = MappingBinaryFormat::encode (layout);
+        MappingBinaryView view (block.getData(), block.getSize());
+
+        REQUIRE (view.isValid());
+        CHECK (view.toMappingSet() == layout);
+
+        CHECK (view.getMappings (MappingBinaryFormat::buttonSlotBase + 2).size() == layout.buttonMappings[2].size());
+        CHECK (view.getMappings (MappingBinaryFormat::motionSlotBase + 1).front().noteNumber == layout.motionMappings[1].front().noteNumber);
+        CHECK (view.getMappings (-1).empty());
+        CHECK (view.getMappings (MappingBinaryFormat::numSlots).empty());
+    }
+
+    SECTION ("Through a memory-mapped file")
+    {
+        juce::TemporaryFile file (".bin");
+        REQUIRE (MappingBinaryFormat::writeFile (layout, file.getFile()));
+
+        MappingBinaryView view (file.getFile());
+        REQUIRE (view.isValid());
+        CHECK (view.toMappingSet() == layout);
+    }
+
+    SECTION ("No mappings at all")
+    {
+        auto block = MappingBinaryFormat::encode (MidiMappingSet {});
+        MappingBinaryView view (block.getData(), block.getSize());
+
+        REQUIRE (view.isValid());
+        CHECK (view.getNumRecords() == 0);
+        CHECK (view.toMappingSet() == MidiMappingSet {});
+    }
+}
+
+TEST_CASE ("Binary mappings reject bad data", "[binary]")
+{
+    using MappingBinaryFormat::Header;
+    using MappingBinaryFormat::Record;
+    using MappingBinaryFormat::Slot;
+
+    auto block = MappingBinaryFormat::encode (makeLayout());
+    REQUIRE (isValid (block));
+
+    auto* bytes = static_cast<char*> (block.getData());
+
+    SECTION ("Nothing or too little")
+    {
+        CHECK_FALSE (MappingBinaryView (nullptr, 0).isValid());
+        CHECK_FALSE (MappingBinaryView (bytes, sizeof (Header) - 1).isValid());
+        CHECK_FALSE (MappingBinaryView (juce::File::getSpecialLocation (juce::File::tempDirectory).getNonexistentChildFile ("missing", ".bin")).isValid());
+    }
+
+    SECTION ("Wrong magic")
+    {
+        bytes[0] = 'X';
+        CHECK_FALSE (isValid (block));
+    }
+
+    SECTION ("Other version")
+    {
+        auto version = static_cast<std::uint16_t> (MappingBinaryFormat::currentVersion - 1);
+        std::memcpy (bytes + offsetof (Header, version), &version, sizeof (version));
+        CHECK_FALSE (isValid (block));
+    }
+
+    SECTION ("Truncated or padded")
+    {
+        CHECK_FALSE (MappingBinaryView (bytes, block.getSize() - sizeof (Record)).isValid());
+
+        block.append ("\0\0\0\0", 4);
+        CHECK_FALSE (isValid (block));
+    }
+
+    SECTION ("A flipped bit fails the checksum")
+    {
+        bytes[block.getSize() - 5] ^= 0x10;
+        CHECK_FALSE (isValid (block));
+    }
+
+    SECTION ("A slot past the records, even with a good checksum")
+    {
+        Header header;
+        std::memcpy (&header, bytes, sizeof (Header));
+
+        Slot slot { header.recordCount, 1 };
+        std::memcpy (bytes + sizeof (Header), &slot, sizeof (Slot));
+        updateChecksum (block);
+        CHECK_FALSE (isValid (block));
+    }
+
+    SECTION ("Misaligned data")
+    {
+        juce::MemoryBlock shifted (block.getSize() + 1);
+        std::memcpy (static_cast<char*> (shifted.getData()) + 1, bytes, block.getSize());
+        CHECK_FALSE (MappingBinaryView (static_cast<char*> (shifted.getData()) + 1, block.getSize()).isValid());
+    }
+
+    SECTION ("A garbage file")
+    {
+        juce::TemporaryFile file (".bin");
+        REQUIRE (file.getFile().replaceWithText ("{ \"mappings\": [] }"));
+        CHECK_FALSE (MappingBinaryView (file.getFile()).isValid());
+    }
+}
+
+TEST_CASE ("Binary mapping slots know their controls", "[binary]")
+{
+    using namespace MappingBinaryFormat;
+
+    auto isButton = [] (const char* controlType, int controlIndex) { return isButtonSlot (getSlot (controlType, controlIndex)); };
+
+    SECTION ("Slots by group name")
+    {
+        CHECK (getSlot ("Axis", 0) == axisSlotBase);
+        CHECK (getSlot ("Button", 2) == buttonSlotBase + 2);
+        CHECK (getSlot ("Motion", MotionGesture::count - 1) == numSlots - 1);
+        CHECK (getSlot ("Touchpad", TouchpadControl::count) == -1);
+        CHECK (getSlot ("Pedal", 0) == -1);
+    }
+
+    SECTION ("Press and release controls")
+    {
+        CHECK (isButton ("Button", 0));
+        CHECK (isButton ("Motion", MotionGesture::Shake));
+        CHECK (isButton ("Motion", MotionGesture::TiltSnapRight));
+        CHECK (isButton ("Touchpad", TouchpadControl::Button));
+    }
+
+    SECTION ("Continuous controls")
+    {
+        CHECK_FALSE (isButton ("Axis", 4));
+        CHECK_FALSE (isButton ("Gyro", 0));
+        CHECK_FALSE (isButton ("Accel", 2));
+        CHECK_FALSE (isButton ("Touchpad", TouchpadControl::Pressure));
+        CHECK_FALSE (isButtonSlot (-1));
+    }
+}
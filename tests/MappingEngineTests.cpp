@@ -0,0 +1,185 @@
+#include "MappingEngine.h"
+#include "MidiRecorder.h"
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    // Axis 0 plays middle C on channel 1, gated at 0.5 and closed again below 0.4
+    MidiMapping makeGate()
+    {
+        MidiMapping mapping;
+        mapping.type = MidiMapping::Type::Note;
+        mapping.channel = 1;
+        mapping.ccNumber = 0;
+        mapping.noteNumber = 60;
+        mapping.minValue = 0.0f;
+        mapping.maxValue = 127.0f;
+        mapping.isButton = false;
+        mapping.gateThreshold = 0.5f;
+        mapping.gateHysteresis = 0.1f;
+        return mapping;
+    }
+
+    MidiMappingSet makeLayout (const MidiMapping& mapping)
+    {
+        MidiMappingSet set;
+        set.axisMappings[0].push_back (mapping);
+        return set;
+    }
+
+    // Posted on the message thread, so it is dispatched before this returns
+    void move (MappingEngine& engine, float value, float speed = -1.0f)
+    {
+        auto event = InputEvent::make (InputEvent::Source::Hardware, InputEvent::Control::Axis, 0, value);
+        event.speed = speed;
+        REQUIRE (engine.post (event));
+    }
+}
+
+TEST_CASE ("Note gate on a continuous control", "[engine]")
+{
+    MidiRecorder recorder;
+    MappingEngine engine;
+    engine.compile (makeLayout (makeGate()));
+
+    SECTION ("Below the threshold nothing plays")
+    {
+        move (engine, 0.3f);
+        move (engine, 0.5f);
+        CHECK (recorder.sent.empty());
+    }
+
+    SECTION ("Rising past the threshold plays one note with the value as velocity")
+    {
+        move (engine, 0.3f);
+        move (engine, 0.6f);
+        move (engine, 0.7f);
+        move (engine, 0.9f);
+
+        REQUIRE (recorder.sent.size() == 1);
+        CHECK (recorder.sent[0].message.isNoteOn());
+        CHECK (recorder.sent[0].message.getChannel() == 1);
+        CHECK (recorder.sent[0].message.getNoteNumber() == 60);
+        CHECK (recorder.sent[0].message.getVelocity() == 76);
+    }
+
+    SECTION ("Inside the hysteresis band the gate stays open")
+    {
+        move (engine, 0.6f);
+        move (engine, 0.45f);
+        move (engine, 0.41f);
+        move (engine, 0.6f);
+
+        CHECK (recorder.sent.size() == 1);
+        CHECK (recorder.noteOffs().empty());
+    }
+
+    SECTION ("Below the threshold minus the hysteresis the gate closes, once")
+    {
+        move (engine, 0.6f);
+        move (engine, 0.35f);
+        move (engine, 0.2f);
+
+        REQUIRE (recorder.sent.size() == 2);
+        CHECK (recorder.sent[1].message.isNoteOff());
+        CHECK (recorder.sent[1].message.getNoteNumber() == 60);
+    }
+
+    SECTION ("A closed gate needs the threshold again to reopen")
+    {
+        move (engine, 0.6f);
+        move (engine, 0.35f);
+        move (engine, 0.45f);
+        CHECK (recorder.noteOns().size() == 1);
+
+        move (engine, 0.55f);
+        CHECK (recorder.noteOns().size() == 2);
+    }
+
+    SECTION ("Releasing ends a held note")
+    {
+        move (engine, 0.6f);
+        engine.releaseAll();
+
+        REQUIRE (recorder.noteOffs().size() == 1);
+        CHECK (recorder.noteOffs()[0].message.getNoteNumber() == 60);
+    }
+}
+
+TEST_CASE ("Note gate velocity from stroke speed", "[engine]")
+{
+    auto mapping = makeGate();
+    mapping.velocitySpeed = 4.0f;
+
+    MidiRecorder recorder;
+    MappingEngine engine;
+    engine.compile (makeLayout (mapping));
+
+    SECTION ("A quarter of the full speed plays a quarter of the range")
+    {
+        move (engine, 0.6f, 1.0f);
+
+        REQUIRE (recorder.noteOns().size() == 1);
+        CHECK (recorder.noteOns()[0].message.getVelocity() == 32);
+    }
+
+    SECTION ("Faster than the full speed plays the maximum")
+    {
+        move (engine, 0.6f, 10.0f);
+
+        REQUIRE (recorder.noteOns().size() == 1);
+        CHECK (recorder.noteOns()[0].message.getVelocity() == 127);
+    }
+
+    SECTION ("A very slow stroke still plays a note")
+    {
+        move (engine, 0.6f, 0.0f);
+
+        REQUIRE (recorder.noteOns().size() == 1);
+        CHECK (recorder.noteOns()[0].message.getVelocity() == 1);
+    }
+
+    SECTION ("Without a measured speed the value is the velocity")
+    {
+        move (engine, 0.6f);
+
+        REQUIRE (recorder.noteOns().size() == 1);
+        CHECK (recorder.noteOns()[0].message.getVelocity() == 76);
+    }
+}
+
+TEST_CASE ("Note gate with a scale moves between notes", "[engine]")
+{
+    // C major over an octave: eight notes, an eighth of the range each, open across all of it
+    auto mapping = makeGate();
+    mapping.scale = MidiMapping::Scale::Major;
+    mapping.scaleRange = 12;
+    mapping.gateThreshold = 0.0f;
+
+    MidiRecorder recorder;
+    MappingEngine engine;
+    engine.compile (makeLayout (mapping));
+
+    move (engine, 0.05f);
+    REQUIRE (recorder.sent.size() == 1);
+    CHECK (recorder.sent[0].message.getNoteNumber() == 60);
+    auto velocity = recorder.sent[0].message.getVelocity();
+
+    SECTION ("Just past a degree boundary keeps the note")
+    {
+        move (engine, 0.13f);
+        CHECK (recorder.sent.size() == 1);
+    }
+
+    SECTION ("Well into the next degree ends the old note, then starts the new one at the opening velocity")
+    {
+        move (engine, 0.2f);
+
+        REQUIRE (recorder.sent.size() == 3);
+        CHECK (recorder.sent[1].message.isNoteOff());
+        CHECK (recorder.sent[1].message.getNoteNumber() == 60);
+        CHECK (recorder.sent[2].message.isNoteOn());
+        CHECK (recorder.sent[2].message.getNoteNumber() == 62);
+        CHECK (recorder.sent[2].message.getVelocity() == velocity);
+    }
+}
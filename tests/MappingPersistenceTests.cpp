@@ -0,0 +1,97 @@
+#include "MappingPersistence.h"
+#include "MappingBinaryFormat.h"
+#include "MappingEngine.h"
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    MidiMappingSet makeLayout (int ccNumber)
+    {
+        MidiMapping mapping;
+        mapping.type = MidiMapping::Type::ControlChange;
+        mapping.channel = 2;
+        mapping.ccNumber = ccNumber;
+        mapping.maxValue = 127.0f;
+
+        MidiMappingSet set;
+        set.axisMappings[0].push_back (mapping);
+        return set;
+    }
+
+    // The JSON and its binary cache next to it, removed again afterwards
+    struct SavedMappings
+    {
+        SavedMappings()
+        {
+            REQUIRE (MappingPersistence::writeMappings (json.getFile(), makeLayout (10)));
+        }
+
+        ~SavedMappings()
+        {
+            cache.deleteFile();
+        }
+
+        void writeCache (const MidiMappingSet& set, juce::Time modified)
+        {
+            REQUIRE (MappingBinaryFormat::writeFile (set, cache));
+            REQUIRE (cache.setLastModificationTime (modified));
+        }
+
+        juce::Time getJsonTime() const { return json.getFile().getLastModificationTime(); }
+
+        juce::TemporaryFile json { ".json" };
+        juce::File cache = MappingBinaryFormat::getCacheFileFor (json.getFile());
+    };
+}
+
+TEST_CASE ("Loading mappings prefers a current binary cache", "[persistence]")
+{
+    SavedMappings saved;
+    MappingEngine engine;
+
+    SECTION ("A cache hit stays compiled from the cache")
+    {
+        // Different from the JSON, so it is clear which one was used
+        saved.writeCache (makeLayout (20), saved.getJsonTime() + juce::RelativeTime::seconds (1.0));
+
+        auto loaded = MappingPersistence::loadMappings (saved.json.getFile(), engine);
+        REQUIRE (loaded.has_value());
+        CHECK (*loaded == makeLayout (20));
+        CHECK (engine.isCompiledFromCache());
+    }
+
+    SECTION ("A cache older than the JSON is ignored and refreshed")
+    {
+        saved.writeCache (makeLayout (20), saved.getJsonTime() - juce::RelativeTime::seconds (10.0));
+
+        auto loaded = MappingPersistence::loadMappings (saved.json.getFile(), engine);
+        REQUIRE (loaded.has_value());
+        CHECK (*loaded == makeLayout (10));
+        CHECK_FALSE (engine.isCompiledFromCache());
+
+        MappingBinaryView view (saved.cache);
+        REQUIRE (view.isValid());
+        CHECK (view.toMappingSet() == makeLayout (10));
+    }
+
+    SECTION ("A broken cache falls back to the JSON")
+    {
+        REQUIRE (saved.cache.replaceWithText ("not a cache"));
+        REQUIRE (saved.cache.setLastModificationTime (saved.getJsonTime() + juce::RelativeTime::seconds (1.0)));
+
+        auto loaded = MappingPersistence::loadMappings (saved.json.getFile(), engine);
+        REQUIRE (loaded.has_value());
+        CHECK (*loaded == makeLayout (10));
+        CHECK_FALSE (engine.isCompiledFromCache());
+    }
+
+    SECTION ("Without a mappings file the engine is left alone")
+    {
+        saved.writeCache (makeLayout (20), saved.getJsonTime() + juce::RelativeTime::seconds (1.0));
+        REQUIRE (MappingPersistence::loadMappings (saved.json.getFile(), engine).has_value());
+
+        auto missing = saved.json.getFile().getSiblingFile ("missing.json");
+        CHECK_FALSE (MappingPersistence::loadMappings (missing, engine).has_value());
+        CHECK (engine.isCompiledFromCache());
+    }
+}
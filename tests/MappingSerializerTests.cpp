@@ -0,0 +1,199 @@
+#include "MappingSerializer.h"
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+namespace
+{
+    // Values with short decimal forms, so they survive being written as text
+    MidiMapping makeMapping (int seed, bool isButton)
+    {
+        MidiMapping mapping;
+        mapping.type = seed % 2 == 0 ? MidiMapping::Type::ControlChange : MidiMapping::Type::Note;
+        mapping.channel = 1 + seed % 16;
+        mapping.ccNumber = seed % 128;
+        mapping.noteNumber = 36 + seed % 48;
+        mapping.minValue = static_cast<float> (seed % 10);
+        mapping.maxValue = 127.0f;
+        mapping.isButton = isButton;
+        mapping.smoothing = static_cast<MidiMapping::Smoothing> (seed % 4);
+        mapping.smoothingFrequency = 2.5f;
+        mapping.smoothingBeta = 0.05f;
+        mapping.gateThreshold = 0.6f;
+        mapping.gateHysteresis = 0.125f;
+        mapping.aftertouch = seed % 3 == 0;
+        mapping.velocitySpeed = seed % 5 == 0 ? 4.5f : 0.0f;
+        mapping.scale = static_cast<MidiMapping::Scale> (seed % 8);
+        mapping.scaleRange = 7 + seed % 17;
+        return mapping;
+    }
+
+    MidiMappingSet makeLayout()
+    {
+        MidiMappingSet set;
+        int seed = 0;
+
+        auto fill = [&seed] (auto& group, bool isButton) {
+            for (size_t i = 0; i < group.size(); ++i)
+                for (size_t m = 0; m < i % 3; ++m)
+                    group[i].push_back (makeMapping (seed++, isButton));
+        };
+
+        fill (set.axisMappings, false);
+        fill (set.buttonMappings, true);
+        fill (set.gyroMappings, false);
+        fill (set.accelerometerMappings, false);
+        fill (set.touchpadMappings, false);
+        fill (set.motionMappings, true);
+        return set;
+    }
+
+    std::optional<MidiMappingSet> readJson (const std::string& json)
+    {
+        return MappingSerializer::read (json.data(), json.size());
+    }
+
+    juce::String nameControl (const juce::String& controlType, int controlIndex)
+    {
+        return controlType + " \"" + juce::String (controlIndex) + "\"";
+    }
+}
+
+TEST_CASE ("Mapping JSON round trip", "[serializer]")
+{
+    auto layout = makeLayout();
+
+    SECTION ("Every field and control group")
+    {
+        auto json = MappingSerializer::toJson (layout);
+        CHECK (readJson (json.toStdString()) == layout);
+
+        // The text is plain JSON that juce can parse as well
+        CHECK (juce::JSON::parse (json)["mappings"].isArray());
+    }
+
+    SECTION ("Metadata and control names are written but not read back")
+    {
+        auto metadata = std::make_unique<juce::DynamicObject>();
+        metadata->setProperty ("name", "Test \"preset\"");
+        metadata->setProperty ("version", 3);
+
+        juce::MemoryOutputStream stream;
+        MappingSerializer::write (stream, layout, juce::var (metadata.release()), nameControl);
+
+        auto parsed = juce::JSON::parse (stream.toString());
+        CHECK (parsed["name"] == juce::var ("Test \"preset\""));
+        CHECK (parsed["mappings"][0]["controlName"].toString().startsWith ("Axis"));
+        CHECK (readJson (stream.toString().toStdString()) == layout);
+    }
+
+    SECTION ("No mappings")
+    {
+        CHECK (readJson (MappingSerializer::toJson (MidiMappingSet {}).toStdString()) == MidiMappingSet {});
+    }
+
+    SECTION ("Through a file with a byte order mark")
+    {
+        auto json = MappingSerializer::toJson (layout).toStdString();
+
+        juce::MemoryBlock data ("\xef\xbb\xbf", 3);
+        data.append (json.data(), json.size());
+
+        juce::TemporaryFile file (".json");
+        REQUIRE (file.getFile().replaceWithData (data.getData(), data.getSize()));
+        CHECK (MappingSerializer::readFile (file.getFile()) == layout);
+    }
+}
+
+TEST_CASE ("Mapping JSON reading is forgiving but not blind", "[serializer]")
+{
+    SECTION ("Malformed or missing mappings")
+    {
+        CHECK_FALSE (MappingSerializer::read (nullptr, 0).has_value());
+        CHECK_FALSE (readJson ("").has_value());
+        CHECK_FALSE (readJson ("{ \"name\": \"no mappings\" }").has_value());
+        CHECK_FALSE (readJson ("{ \"mappings\": [ { \"controlType\": \"Axis\", ").has_value());
+        CHECK_FALSE (readJson ("[]").has_value());
+
+        auto json = MappingSerializer::toJson (makeLayout()).toStdString();
+        CHECK_FALSE (readJson (json.substr (0, json.size() / 2)).has_value());
+    }
+
+    SECTION ("Unknown keys, groups and indices are skipped")
+    {
+        auto set = readJson (R"({
+            "future": { "nested": [1, 2, { "a": null }] },
+            "mappings": [
+                { "controlType": "Pedal", "controlIndex": 0, "mappings": [ { "channel": 2 } ] },
+                { "controlType": "Axis", "controlIndex": 99, "mappings": [ { "channel": 3 } ] },
+                { "controlType": "Button", "controlIndex": 1, "extra": "x",
+                  "mappings": [ { "type": 1, "channel": 4, "noteNumber": 60, "unknown": [true], "smoothing": 9, "scale": -1 } ] }
+            ]
+        })");
+
+        REQUIRE (set.has_value());
+
+        MidiMappingSet expected;
+        MidiMapping mapping {};
+        mapping.type = MidiMapping::Type::Note;
+        mapping.channel = 4;
+        mapping.noteNumber = 60;
+        expected.buttonMappings[1].push_back (mapping);
+
+        CHECK (*set == expected);
+    }
+
+    SECTION ("Booleans may be numbers")
+    {
+        auto set = readJson (R"({ "mappings": [ { "controlType": "Button", "controlIndex": 0, "mappings": [ { "isButton": 1, "aftertouch": 0 } ] } ] })");
+
+        REQUIRE (set.has_value());
+        REQUIRE (set->buttonMappings[0].size() == 1);
+        CHECK (set->buttonMappings[0][0].isButton);
+        CHECK_FALSE (set->buttonMappings[0][0].aftertouch);
+    }
+}
+
+TEST_CASE ("Mapping JSON metadata is read without the mappings", "[serializer]")
+{
+    auto metadata = std::make_unique<juce::DynamicObject>();
+    metadata->setProperty ("name", "Test \"preset\"");
+    metadata->setProperty ("tags", juce::var (juce::StringArray { "drums", "live" }));
+    metadata->setProperty ("version", 3);
+
+    SECTION ("Properties of every kind")
+    {
+        auto json = MappingSerializer::toJson (makeLayout(), juce::var (metadata.release())).toStdString();
+        auto parsed = MappingSerializer::readMetadata (json.data(), json.size());
+
+        CHECK (parsed["name"] == juce::var ("Test \"preset\""));
+        CHECK (parsed["tags"][1] == juce::var ("live"));
+        CHECK (static_cast<int> (parsed["version"]) == 3);
+        CHECK_FALSE (parsed.hasProperty ("mappings"));
+    }
+
+    SECTION ("The mappings after the metadata are never looked at")
+    {
+        std::string json = R"({ "name": "cut short", "mappings": [ { "controlType": )";
+        CHECK (MappingSerializer::readMetadata (json.data(), json.size())["name"] == juce::var ("cut short"));
+    }
+
+    SECTION ("Broken before the mappings start")
+    {
+        std::string json = R"({ "name": "x", "version": )";
+        CHECK (MappingSerializer::readMetadata (json.data(), json.size()).isVoid());
+        CHECK (MappingSerializer::readMetadata (nullptr, 0).isVoid());
+    }
+
+    SECTION ("From a file, whether the metadata fits the first read or not")
+    {
+        metadata->setProperty ("notes", juce::String::repeatedString ("long ", 2000));
+        juce::var expected (metadata.release());
+
+        juce::TemporaryFile file (".json");
+        REQUIRE (file.getFile().replaceWithText (MappingSerializer::toJson (makeLayout(), expected)));
+
+        auto parsed = MappingSerializer::readMetadataFile (file.getFile());
+        CHECK (parsed["notes"] == expected["notes"]);
+        CHECK (parsed["name"] == juce::var ("Test \"preset\""));
+    }
+}
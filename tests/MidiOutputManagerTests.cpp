@@ -0,0 +1,145 @@
+#include "MidiOutputManager.h"
+#include "MidiRecorder.h"
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    // Either side of the boundary between a channel's two words, and the last note
+    constexpr int channels[] = { 1, 16 };
+    constexpr int notes[] = { 63, 64, 127 };
+
+    int countActive (const MidiOutputManager& output)
+    {
+        int count = 0;
+        for (int channel = 1; channel <= 16; ++channel)
+            for (int note = 0; note < 128; ++note)
+                count += output.isNoteActive (channel, note) ? 1 : 0;
+
+        return count;
+    }
+}
+
+TEST_CASE ("Sounding notes are tracked per channel and note", "[output]")
+{
+    MidiRecorder recorder;
+    auto& output = MidiOutputManager::getInstance();
+
+    for (auto channel : channels)
+        for (auto note : notes)
+            output.sendNoteOn (channel, note, 1.0f);
+
+    SECTION ("Exactly the notes played are sounding")
+    {
+        for (auto channel : channels)
+            for (auto note : notes)
+                CHECK (output.isNoteActive (channel, note));
+
+        CHECK (countActive (output) == 6);
+        CHECK_FALSE (output.isNoteActive (1, 62));
+        CHECK_FALSE (output.isNoteActive (1, 65));
+        CHECK_FALSE (output.isNoteActive (2, 63));
+        CHECK_FALSE (output.isNoteActive (15, 127));
+        CHECK_FALSE (output.isNoteActive (0, 64));
+        CHECK_FALSE (output.isNoteActive (17, 64));
+        CHECK_FALSE (output.isNoteActive (1, 128));
+    }
+
+    SECTION ("A note on with zero velocity is a release")
+    {
+        output.sendNoteOn (16, 64, 0.0f);
+        CHECK_FALSE (output.isNoteActive (16, 64));
+        CHECK (output.isNoteActive (16, 63));
+        CHECK (output.isNoteActive (1, 64));
+
+        // A velocity that rounds to zero goes out as a note off too
+        output.sendNoteOn (1, 127, 0.001f);
+        CHECK_FALSE (output.isNoteActive (1, 127));
+        CHECK (countActive (output) == 4);
+    }
+
+    SECTION ("Releasing ends exactly the notes still sounding, once")
+    {
+        output.sendNoteOn (1, 63, 0.0f);
+        recorder.sent.clear();
+
+        output.releaseAllNotes();
+        CHECK (countActive (output) == 0);
+
+        auto offs = recorder.noteOffs();
+        REQUIRE (offs.size() == 5);
+        CHECK (offs.size() == recorder.sent.size());
+
+        for (const auto& off : offs)
+        {
+            CHECK (off.time == 0.0);
+            CHECK_FALSE ((off.message.getChannel() == 1 && off.message.getNoteNumber() == 63));
+        }
+
+        recorder.sent.clear();
+        output.releaseAllNotes();
+        CHECK (recorder.sent.empty());
+    }
+}
+
+TEST_CASE ("Releasing a scheduled note waits for its last pending message", "[output]")
+{
+    MidiRecorder recorder;
+    auto& output = MidiOutputManager::getInstance();
+    auto now = juce::Time::getMillisecondCounterHiRes();
+
+    SECTION ("A note whose note off is still to come is ended at that time")
+    {
+        output.sendNoteOnAt (2, 64, 1.0f, now + 5000.0);
+        output.sendNoteOnAt (2, 64, 0.0f, now + 10000.0);
+        CHECK (output.getScheduledNoteOnTime (2, 64) == now + 5000.0);
+        recorder.sent.clear();
+
+        // The pending note on must not be left sounding after its own note off went out
+        output.releaseAllNotes();
+
+        REQUIRE (recorder.sent.size() == 1);
+        CHECK (recorder.sent[0].message.isNoteOff());
+        CHECK (recorder.sent[0].message.getChannel() == 2);
+        CHECK (recorder.sent[0].message.getNoteNumber() == 64);
+        CHECK (recorder.sent[0].time == now + 10000.0);
+    }
+
+    SECTION ("A scheduled note on still to come is ended after it")
+    {
+        output.sendNoteOnAt (16, 127, 1.0f, now + 5000.0);
+        CHECK (output.isNoteActive (16, 127));
+        recorder.sent.clear();
+
+        output.releaseAllNotes();
+
+        REQUIRE (recorder.sent.size() == 1);
+        CHECK (recorder.sent[0].message.isNoteOff());
+        CHECK (recorder.sent[0].time == now + 5000.0);
+        CHECK_FALSE (output.isNoteActive (16, 127));
+    }
+
+    SECTION ("A scheduled note that is already due is ended now")
+    {
+        output.sendNoteOnAt (1, 63, 1.0f, now - 1.0);
+        recorder.sent.clear();
+
+        output.releaseAllNotes();
+
+        REQUIRE (recorder.sent.size() == 1);
+        CHECK (recorder.sent[0].message.isNoteOff());
+        CHECK (recorder.sent[0].time == 0.0);
+    }
+
+    SECTION ("Only the latest due time counts")
+    {
+        output.sendNoteOnAt (1, 64, 1.0f, now + 8000.0);
+        output.sendNoteOnAt (1, 64, 0.0f, now + 9000.0);
+        output.sendNoteOnAt (1, 64, 1.0f, now + 6000.0);
+        recorder.sent.clear();
+
+        output.releaseAllNotes();
+
+        REQUIRE (recorder.sent.size() == 1);
+        CHECK (recorder.sent[0].time == now + 9000.0);
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "MidiOutputManager.h"
+#include <vector>
+
+// Takes the place of the device for as long as it lives and keeps everything
+// sent, so a test sees exactly what would have gone out and when
+struct MidiRecorder : MidiOutputManager::Destination
+{
+    struct Sent
+    {
+        juce::MidiMessage message;
+        double time = 0.0;  // 0 for immediate sends
+    };
+
+    MidiRecorder()
+    {
+        MidiOutputManager::getInstance().setDestination (this);
+    }
+
+    ~MidiRecorder() override
+    {
+        MidiOutputManager::getInstance().setDestination (nullptr);
+    }
+
+    void send (const juce::MidiMessage& message, double millisecondCounter) override
+    {
+        sent.push_back ({ message, millisecondCounter });
+    }
+
+    // Note ons with a velocity; note offs include note ons with a velocity of 0
+    std::vector<Sent> noteOns() const { return filter ([] (const auto& m) { return m.isNoteOn(); }); }
+    std::vector<Sent> noteOffs() const { return filter ([] (const auto& m) { return m.isNoteOff(); }); }
+
+    std::vector<Sent> sent;
+
+private:
+    template <typename Predicate>
+    std::vector<Sent> filter (Predicate&& predicate) const
+    {
+        std::vector<Sent> matching;
+        for (const auto& s : sent)
+            if (predicate (s.message))
+                matching.push_back (s);
+
+        return matching;
+    }
+};
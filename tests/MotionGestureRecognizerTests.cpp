@@ -0,0 +1,178 @@
+#include "MotionGestureRecognizer.h"
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr double pi = 3.14159265358979323846;
+    constexpr double gravity = 9.81;
+
+    struct Gestures
+    {
+        std::vector<int> onsets = std::vector<int> (MotionGesture::count, 0);
+        std::vector<int> releases = std::vector<int> (MotionGesture::count, 0);
+    };
+
+    // Feeds a noisy stream built from functions of time at the given rate and
+    // counts every gesture turning on and off
+    template <typename Gyro, typename Accel>
+    Gestures run (double seconds, Gyro&& gyro, Accel&& accel, double rateHz = 1000.0)
+    {
+        MotionGestureRecognizer recognizer;
+        Gestures gestures;
+        std::mt19937 random (7);
+        std::normal_distribution<float> noise (0.0f, 0.05f);
+
+        for (int i = 0; i < static_cast<int> (seconds * rateHz); ++i)
+        {
+            auto t = i / rateHz;
+            auto timestampNs = static_cast<std::uint64_t> (1.0e6 + t * 1.0e9);
+
+            float gyroSample[3] = { noise (random), noise (random), noise (random) };
+            float accelSample[3] = { noise (random), noise (random), noise (random) };
+            gyro (t, gyroSample);
+            accel (t, accelSample);
+
+            auto changed = recognizer.addGyro (gyroSample, timestampNs) | recognizer.addAccel (accelSample, timestampNs);
+            for (int gesture = 0; gesture < MotionGesture::count; ++gesture)
+            {
+                if (((changed >> gesture) & 1) == 0)
+                    continue;
+
+                auto on = ((recognizer.getActive() >> gesture) & 1) != 0;
+                ++(on ? gestures.onsets : gestures.releases)[static_cast<size_t> (gesture)];
+            }
+        }
+
+        return gestures;
+    }
+
+    auto still = [] (double, float*) {};
+    auto level = [] (double, float* accel) { accel[1] += static_cast<float> (gravity); };
+
+    // A 40 ms half-sine on one gyro axis starting at 0.3 s
+    auto pulse (int axis, double peak)
+    {
+        return [=] (double t, float* gyro)
+        {
+            if (t > 0.3 && t < 0.34)
+                gyro[axis] += static_cast<float> (peak * std::sin ((t - 0.3) / 0.04 * pi));
+        };
+    }
+
+    // Roll to the given angle at the given time, right side down for positive angles
+    auto roll (double start, double duration, double degrees)
+    {
+        return [=] (double t, float* accel)
+        {
+            auto angle = degrees * std::clamp ((t - start) / duration, 0.0, 1.0) * pi / 180.0;
+            accel[0] += static_cast<float> (-gravity * std::sin (angle));
+            accel[1] += static_cast<float> (gravity * std::cos (angle));
+        };
+    }
+
+    int total (const std::vector<int>& counts)
+    {
+        return std::accumulate (counts.begin(), counts.end(), 0);
+    }
+}
+
+TEST_CASE ("Flicks from synthetic gyro streams", "[motion]")
+{
+    SECTION ("A yaw pulse is one flick, and it lets go again")
+    {
+        auto gestures = run (1.0, pulse (1, 8.0), level);
+
+        CHECK (gestures.onsets[MotionGesture::FlickLeft] == 1);
+        CHECK (gestures.releases[MotionGesture::FlickLeft] == 1);
+        CHECK (total (gestures.onsets) == 1);
+    }
+
+    SECTION ("Each direction on each axis")
+    {
+        CHECK (run (1.0, pulse (1, -8.0), level).onsets[MotionGesture::FlickRight] == 1);
+        CHECK (run (1.0, pulse (0, 8.0), level).onsets[MotionGesture::FlickUp] == 1);
+        CHECK (run (1.0, pulse (0, -8.0), level).onsets[MotionGesture::FlickDown] == 1);
+    }
+
+    SECTION ("The same flick at a lower sensor rate")
+    {
+        auto gestures = run (1.0, pulse (1, 8.0), level, 250.0);
+
+        CHECK (gestures.onsets[MotionGesture::FlickLeft] == 1);
+        CHECK (total (gestures.onsets) == 1);
+    }
+
+    SECTION ("Too weak a pulse is no flick")
+    {
+        CHECK (total (run (1.0, pulse (1, 3.0), level).onsets) == 0);
+    }
+
+    SECTION ("A slow turn is no flick")
+    {
+        auto gestures = run (2.0, [] (double t, float* gyro)
+        {
+            if (t > 0.3 && t < 1.3)
+                gyro[1] += static_cast<float> (6.0 * std::sin ((t - 0.3) * pi));
+        }, level);
+
+        CHECK (total (gestures.onsets) == 0);
+    }
+
+    SECTION ("Sensor noise alone is nothing")
+    {
+        CHECK (total (run (2.0, still, level).onsets) == 0);
+    }
+}
+
+TEST_CASE ("Shakes from synthetic accelerometer streams", "[motion]")
+{
+    SECTION ("Shaking side to side is one shake until it stops")
+    {
+        auto gestures = run (2.0, still, [] (double t, float* accel)
+        {
+            accel[1] += static_cast<float> (gravity);
+            if (t > 0.5 && t < 1.2)
+                accel[0] += static_cast<float> (25.0 * std::sin (2.0 * pi * 6.0 * t));
+        });
+
+        CHECK (gestures.onsets[MotionGesture::Shake] == 1);
+        CHECK (gestures.releases[MotionGesture::Shake] == 1);
+        CHECK (total (gestures.onsets) == 1);
+    }
+
+    SECTION ("A single bump is no shake")
+    {
+        auto gestures = run (2.0, still, [] (double t, float* accel)
+        {
+            accel[1] += static_cast<float> (gravity);
+            if (t > 0.5 && t < 0.6)
+                accel[0] += static_cast<float> (25.0 * std::sin ((t - 0.5) / 0.1 * 2.0 * pi));
+        });
+
+        CHECK (gestures.onsets[MotionGesture::Shake] == 0);
+    }
+
+    SECTION ("Shaking too gently is no shake")
+    {
+        auto gestures = run (2.0, still, [] (double t, float* accel)
+        {
+            accel[1] += static_cast<float> (gravity);
+            if (t > 0.5 && t < 1.2)
+                accel[0] += static_cast<float> (8.0 * std::sin (2.0 * pi * 6.0 * t));
+        });
+
+        CHECK (gestures.onsets[MotionGesture::Shake] == 0);
+    }
+}
+
+TEST_CASE ("Tilt-snaps from synthetic accelerometer streams", "[motion]")
+{
+    CHECK (run (2.0, still, roll (0.5, 0.15, 60.0)).onsets[MotionGesture::TiltSnapRight] == 1);
+    CHECK (run (2.0, still, roll (0.5, 0.15, -60.0)).onsets[MotionGesture::TiltSnapLeft] == 1);
+    CHECK (total (run (4.0, still, roll (0.5, 2.0, 60.0)).onsets) == 0);
+}
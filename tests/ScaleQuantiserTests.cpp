@@ -0,0 +1,181 @@
+#include "ScaleQuantiser.h"
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+namespace
+{
+    using Scale = MidiMapping::Scale;
+
+    struct ScaleCase
+    {
+        Scale scale;
+        std::vector<int> intervals;  // Semitones above the root within one octave
+    };
+
+    const std::vector<ScaleCase> scales {
+        { Scale::Chromatic,       { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 } },
+        { Scale::Major,           { 0, 2, 4, 5, 7, 9, 11 } },
+        { Scale::Minor,           { 0, 2, 3, 5, 7, 8, 10 } },
+        { Scale::Dorian,          { 0, 2, 3, 5, 7, 9, 10 } },
+        { Scale::MajorPentatonic, { 0, 2, 4, 7, 9 } },
+        { Scale::MinorPentatonic, { 0, 3, 5, 7, 10 } },
+        { Scale::Blues,           { 0, 3, 5, 6, 7, 10 } },
+    };
+
+    std::uint16_t toMask (const std::vector<int>& intervals)
+    {
+        std::uint16_t mask = 0;
+        for (auto interval : intervals)
+            mask = static_cast<std::uint16_t> (mask | (1 << interval));
+
+        return mask;
+    }
+
+    // Every note the quantiser can play, lowest first, each found from a fresh start
+    std::vector<int> sweep (ScaleQuantiser& quantiser, int steps = 1000)
+    {
+        std::vector<int> played;
+        for (int i = 0; i <= steps; ++i)
+        {
+            quantiser.reset();
+            auto note = quantiser.process (static_cast<float> (i) / static_cast<float> (steps));
+            if (played.empty() || played.back() != note)
+                played.push_back (note);
+        }
+
+        return played;
+    }
+}
+
+TEST_CASE ("Scale masks hold the intervals of each scale", "[quantiser]")
+{
+    for (const auto& c : scales)
+    {
+        INFO (ScaleQuantiser::getScaleName (c.scale));
+        CHECK (ScaleQuantiser::getScaleMask (c.scale) == toMask (c.intervals));
+    }
+
+    CHECK (ScaleQuantiser::getScaleMask (Scale::None) == 0);
+}
+
+TEST_CASE ("The range is split evenly between the notes of the scale", "[quantiser]")
+{
+    for (const auto& c : scales)
+    {
+        INFO (ScaleQuantiser::getScaleName (c.scale));
+
+        // An octave from C4 is every interval once, and the octave on top
+        auto expected = c.intervals;
+        expected.push_back (12);
+        for (auto& note : expected)
+            note += 60;
+
+        ScaleQuantiser quantiser;
+        quantiser.configure (c.scale, 60, 12);
+        REQUIRE (quantiser.isEnabled());
+        CHECK (sweep (quantiser) == expected);
+    }
+
+    SECTION ("Without a scale there is nothing to quantise")
+    {
+        ScaleQuantiser quantiser;
+        quantiser.configure (Scale::None, 60, 12);
+        CHECK_FALSE (quantiser.isEnabled());
+    }
+}
+
+TEST_CASE ("Scales stop at the top of the MIDI range", "[quantiser]")
+{
+    ScaleQuantiser quantiser;
+
+    SECTION ("A range past note 127 is cut there")
+    {
+        quantiser.configure (Scale::Chromatic, 120, 24);
+        CHECK (sweep (quantiser) == std::vector<int> { 120, 121, 122, 123, 124, 125, 126, 127 });
+    }
+
+    SECTION ("Only the notes of the scale below 127 remain")
+    {
+        quantiser.configure (Scale::Major, 125, 12);
+        CHECK (sweep (quantiser) == std::vector<int> { 125, 127 });
+
+        quantiser.configure (Scale::Blues, 120, 24);
+        CHECK (sweep (quantiser) == std::vector<int> { 120, 123, 125, 126, 127 });
+    }
+
+    SECTION ("A root out of range is clamped to the last note")
+    {
+        quantiser.configure (Scale::Major, 200, 12);
+        CHECK (sweep (quantiser) == std::vector<int> { 127 });
+    }
+
+    SECTION ("Values outside 0..1 play the ends of the range")
+    {
+        quantiser.configure (Scale::Chromatic, 120, 24);
+        CHECK (quantiser.process (2.0f) == 127);
+
+        quantiser.reset();
+        CHECK (quantiser.process (-1.0f) == 120);
+    }
+
+    SECTION ("A range of 0 is the root alone")
+    {
+        quantiser.configure (Scale::Minor, 64, 0);
+        CHECK (sweep (quantiser) == std::vector<int> { 64 });
+    }
+}
+
+TEST_CASE ("Scale degrees change only clearly past a boundary", "[quantiser]")
+{
+    // Ten chromatic notes, a tenth of the range each
+    ScaleQuantiser quantiser;
+    quantiser.configure (Scale::Chromatic, 60, 9);
+    REQUIRE (quantiser.process (0.05f) == 60);
+
+    SECTION ("Just past the boundary keeps the note")
+    {
+        CHECK (quantiser.process (0.101f) == 60);
+        CHECK (quantiser.process (0.12f) == 60);
+    }
+
+    SECTION ("Past the hysteresis moves up, and back down the same way")
+    {
+        CHECK (quantiser.process (0.135f) == 61);
+        CHECK (quantiser.process (0.095f) == 61);
+        CHECK (quantiser.process (0.075f) == 61);
+        CHECK (quantiser.process (0.065f) == 60);
+    }
+
+    SECTION ("A value resting on a boundary does not trill")
+    {
+        int changes = 0;
+        int last = 60;
+        for (int i = 0; i < 1000; ++i)
+        {
+            auto note = quantiser.process (i % 2 == 0 ? 0.098f : 0.102f);
+            changes += note != last ? 1 : 0;
+            last = note;
+        }
+
+        CHECK (changes == 0);
+    }
+
+    SECTION ("A jump skips straight to the new note")
+    {
+        CHECK (quantiser.process (0.85f) == 68);
+    }
+
+    SECTION ("Configuring the same scale again keeps the current note")
+    {
+        quantiser.process (0.135f);
+        quantiser.configure (Scale::Chromatic, 60, 9);
+        CHECK (quantiser.process (0.095f) == 61);
+    }
+
+    SECTION ("Resetting forgets the current note")
+    {
+        quantiser.process (0.135f);
+        quantiser.reset();
+        CHECK (quantiser.process (0.095f) == 60);
+    }
+}
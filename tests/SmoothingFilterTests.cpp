@@ -0,0 +1,227 @@
+#include "SmoothingFilter.h"
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using Type = SmoothingFilter::Type;
+
+    // Filters a signal sampled at the given rate and returns every output
+    template <typename Signal>
+    std::vector<float> run (SmoothingFilter& filter, double seconds, Signal&& signal, double rateHz = 1000.0)
+    {
+        std::vector<float> outputs;
+        for (int i = 0; i <= static_cast<int> (seconds * rateHz); ++i)
+        {
+            auto t = i / rateHz;
+            outputs.push_back (filter.process (signal (t), 10.0 + t));
+        }
+
+        return outputs;
+    }
+
+    SmoothingFilter make (Type type, float frequency, float beta = 0.0f)
+    {
+        SmoothingFilter filter;
+        filter.configure (type, frequency, beta);
+        return filter;
+    }
+
+    auto step = [] (double t) { return t < 0.001 ? 0.0f : 1.0f; };
+
+    // Peak to peak of the last part of a signal, once the start has settled
+    float spread (const std::vector<float>& values, size_t last)
+    {
+        auto [low, high] = std::minmax_element (values.end() - static_cast<std::ptrdiff_t> (last), values.end());
+        return *high - *low;
+    }
+}
+
+TEST_CASE ("Every filter starts at its first sample", "[smoothing]")
+{
+    for (auto type : { Type::None, Type::OneEuro, Type::Ema, Type::Slew })
+    {
+        auto filter = make (type, 1.0f, 1.0f);
+        CHECK (filter.process (0.7f, 5.0) == 0.7f);
+        CHECK_FALSE (filter.isSettling());
+
+        // After a reset the next sample primes it again
+        filter.process (0.2f, 5.1);
+        filter.reset();
+        CHECK (filter.process (0.4f, 5.2) == 0.4f);
+        CHECK_FALSE (filter.isSettling());
+    }
+}
+
+TEST_CASE ("Without smoothing every sample passes through", "[smoothing]")
+{
+    auto filter = make (Type::None, 1.0f);
+    CHECK_FALSE (filter.isEnabled());
+
+    CHECK (filter.process (0.1f, 1.0) == 0.1f);
+    CHECK (filter.process (0.9f, 1.0) == 0.9f);
+    CHECK (filter.process (0.3f, 0.5) == 0.3f);
+    CHECK_FALSE (filter.isSettling());
+}
+
+TEST_CASE ("Samples without elapsed time do not move a filter", "[smoothing]")
+{
+    for (auto type : { Type::OneEuro, Type::Ema, Type::Slew })
+    {
+        auto filter = make (type, 5.0f, 1.0f);
+        REQUIRE (filter.isEnabled());
+        filter.process (0.0f, 1.0);
+        auto moved = filter.process (0.5f, 1.01);
+        REQUIRE (moved > 0.0f);
+
+        // Neither the same timestamp nor one in the past moves it, whatever the value
+        CHECK (filter.process (1.0f, 1.01) == moved);
+        CHECK (filter.process (1.0f, 1.0) == moved);
+        CHECK (filter.process (0.0f, 0.0) == moved);
+
+        // It still heads for the value it was last given once time moves on
+        CHECK (filter.isSettling());
+        CHECK (filter.process (0.0f, 1.02) < moved);
+    }
+}
+
+TEST_CASE ("Changing the parameters restarts a filter", "[smoothing]")
+{
+    auto filter = make (Type::Ema, 1.0f);
+    filter.process (0.0f, 1.0);
+    filter.process (1.0f, 1.01);
+
+    filter.configure (Type::Ema, 2.0f, 0.0f);
+    CHECK (filter.process (0.5f, 1.02) == 0.5f);
+
+    SECTION ("The same parameters again leave it running")
+    {
+        filter.configure (Type::Ema, 2.0f, 0.0f);
+        CHECK (filter.process (1.0f, 1.03) < 1.0f);
+    }
+
+    SECTION ("Frequencies that are not positive fall back to 1 Hz")
+    {
+        auto reference = make (Type::Ema, 1.0f);
+        auto zero = make (Type::Ema, 0.0f);
+        auto negative = make (Type::Ema, -3.0f);
+        auto notANumber = make (Type::Ema, std::nanf (""));
+
+        for (auto* f : { &reference, &zero, &negative, &notANumber })
+        {
+            f->process (0.0f, 1.0);
+            f->process (1.0f, 1.05);
+        }
+
+        CHECK (zero.getOutput() == reference.getOutput());
+        CHECK (negative.getOutput() == reference.getOutput());
+        CHECK (notANumber.getOutput() == reference.getOutput());
+    }
+}
+
+TEST_CASE ("EMA follows a step with the lag of its cutoff", "[smoothing]")
+{
+    // A 5 Hz cutoff has a time constant of about 32 ms
+    auto filter = make (Type::Ema, 5.0f);
+    auto outputs = run (filter, 1.0, step);
+
+    CHECK (std::is_sorted (outputs.begin(), outputs.end()));
+    CHECK (outputs[32] > 0.55f);
+    CHECK (outputs[32] < 0.7f);
+    CHECK (outputs[100] > 0.9f);
+    CHECK (outputs.back() <= 1.0f);
+    CHECK_FALSE (filter.isSettling());
+
+    SECTION ("The lag is the same at a lower sample rate")
+    {
+        auto slower = make (Type::Ema, 5.0f);
+        auto slowerOutputs = run (slower, 1.0, step, 250.0);
+        CHECK (std::abs (slowerOutputs[25] - outputs[100]) < 0.03f);
+    }
+
+    SECTION ("It settles while the target stands still")
+    {
+        auto settling = make (Type::Ema, 5.0f);
+        run (settling, 0.05, step);
+        CHECK (settling.isSettling());
+    }
+}
+
+TEST_CASE ("Slew limits the rate of change", "[smoothing]")
+{
+    // Two full ranges per second
+    auto filter = make (Type::Slew, 2.0f);
+    auto outputs = run (filter, 1.0, step);
+
+    CHECK (std::abs (outputs[250] - 0.5f) < 0.005f);
+    CHECK (std::abs (outputs[500] - 1.0f) < 0.00001f);
+    CHECK (outputs.back() == 1.0f);
+    CHECK_FALSE (filter.isSettling());
+
+    for (size_t i = 1; i < outputs.size(); ++i)
+        CHECK (outputs[i] - outputs[i - 1] <= 0.0021f);
+
+    SECTION ("Irregular sample intervals keep the same rate")
+    {
+        auto irregular = make (Type::Slew, 2.0f);
+        irregular.process (0.0f, 0.0);
+        irregular.process (1.0f, 0.001);
+        irregular.process (1.0f, 0.1);
+        CHECK (std::abs (irregular.process (1.0f, 0.25) - 0.5f) < 0.001f);
+        CHECK (irregular.isSettling());
+    }
+
+    SECTION ("Going down is limited the same")
+    {
+        auto down = make (Type::Slew, 2.0f);
+        auto downOutputs = run (down, 1.0, [] (double t) { return t < 0.001 ? 1.0f : 0.0f; });
+        CHECK (std::abs (downOutputs[250] - 0.5f) < 0.005f);
+        CHECK (std::abs (downOutputs[500]) < 0.00001f);
+    }
+}
+
+TEST_CASE ("One-Euro removes jitter at rest and keeps up with motion", "[smoothing]")
+{
+    std::mt19937 random (3);
+    std::uniform_real_distribution<float> noise (-0.01f, 0.01f);
+    auto noisy = [&] (float value) { return value + noise (random); };
+
+    SECTION ("A resting control with sensor noise barely moves")
+    {
+        auto filter = make (Type::OneEuro, 1.0f, 0.5f);
+        auto outputs = run (filter, 2.0, [&] (double) { return noisy (0.5f); });
+
+        // Input spread is 0.02
+        CHECK (spread (outputs, 1000) < 0.004f);
+        CHECK (std::abs (outputs.back() - 0.5f) < 0.005f);
+    }
+
+    SECTION ("Speed opens the filter, so a fast sweep lags less than with a fixed cutoff")
+    {
+        auto sweep = [] (double t) { return static_cast<float> (std::min (1.0, t * 2.0)); };
+
+        auto adaptive = make (Type::OneEuro, 1.0f, 10.0f);
+        auto fixed = make (Type::OneEuro, 1.0f, 0.0f);
+        auto adaptiveLag = sweep (0.3) - run (adaptive, 0.3, sweep).back();
+        auto fixedLag = sweep (0.3) - run (fixed, 0.3, sweep).back();
+
+        CHECK (adaptiveLag > 0.0f);
+        CHECK (adaptiveLag < 0.05f);
+        CHECK (adaptiveLag < fixedLag / 4.0f);
+    }
+
+    SECTION ("It settles after a step, then stops settling")
+    {
+        auto moving = make (Type::OneEuro, 1.0f, 0.0f);
+        run (moving, 0.05, step);
+        CHECK (moving.isSettling());
+
+        auto settled = make (Type::OneEuro, 1.0f, 0.0f);
+        auto outputs = run (settled, 5.0, step);
+        CHECK (outputs.back() <= 1.0f);
+        CHECK_FALSE (settled.isSettling());
+    }
+}
@@ -0,0 +1,255 @@
+#include "TouchpadZoneMap.h"
+#include "MidiRecorder.h"
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    using Zone = TouchpadZoneMap::Zone;
+
+    // Three uneven columns over two uneven rows; notes 60..65 row by row from the top
+    const std::vector<float> columnEdges { 0.0f, 0.1f, 0.5f, 1.0f };
+    const std::vector<float> rowEdges { 0.0f, 0.7f, 1.0f };
+
+    std::vector<Zone> makeZones (int count)
+    {
+        std::vector<Zone> zones;
+        for (int i = 0; i < count; ++i)
+            zones.push_back ({ Zone::Type::Note, 1, 60 + i });
+
+        return zones;
+    }
+
+    void setUneven (TouchpadZoneMap& map)
+    {
+        REQUIRE (map.setGrid (columnEdges, rowEdges, makeZones (6)));
+    }
+
+    // Index of the band the position falls in, by comparing with every edge
+    int band (const std::vector<float>& edges, float position)
+    {
+        auto above = std::upper_bound (edges.begin() + 1, edges.end() - 1, position);
+        return static_cast<int> (above - edges.begin()) - 1;
+    }
+
+    float distanceToInnerEdge (const std::vector<float>& edges, float position)
+    {
+        auto distance = 1.0f;
+        for (auto edge = edges.begin() + 1; edge != edges.end() - 1; ++edge)
+            distance = std::min (distance, std::abs (position - *edge));
+
+        return distance;
+    }
+}
+
+TEST_CASE ("Touchpad zones are found through the lookup tables", "[touchpad]")
+{
+    TouchpadZoneMap map;
+
+    SECTION ("The default grid is eight pads ascending from the bottom left")
+    {
+        CHECK (map.getNumColumns() == 4);
+        CHECK (map.getNumRows() == 2);
+        CHECK (map.getZone (map.zoneAt (0.01f, 0.99f)).number == 36);
+        CHECK (map.getZone (map.zoneAt (0.99f, 0.99f)).number == 39);
+        CHECK (map.getZone (map.zoneAt (0.01f, 0.01f)).number == 40);
+        CHECK (map.getZone (map.zoneAt (0.99f, 0.01f)).number == 43);
+        CHECK (map.getZone (0).channel == 10);
+    }
+
+    setUneven (map);
+
+    SECTION ("Uneven edges place each zone where it was laid out")
+    {
+        CHECK (map.zoneAt (0.05f, 0.35f) == 0);
+        CHECK (map.zoneAt (0.3f, 0.35f) == 1);
+        CHECK (map.zoneAt (0.75f, 0.35f) == 2);
+        CHECK (map.zoneAt (0.05f, 0.85f) == 3);
+        CHECK (map.zoneAt (0.3f, 0.85f) == 4);
+        CHECK (map.zoneAt (0.75f, 0.85f) == 5);
+    }
+
+    SECTION ("Away from the edges the tables agree with the edges exactly")
+    {
+        // Closer than one table cell to an edge either neighbour is right
+        constexpr auto cell = 1.0f / static_cast<float> (TouchpadZoneMap::lookupResolution);
+
+        for (int i = 0; i <= 2000; ++i)
+        {
+            auto position = static_cast<float> (i) / 2000.0f;
+            auto column = map.zoneAt (position, 0.35f);
+            auto row = map.zoneAt (0.05f, position) / map.getNumColumns();
+
+            if (distanceToInnerEdge (columnEdges, position) > cell)
+                CHECK (column == band (columnEdges, position));
+            else
+                CHECK (std::abs (column - band (columnEdges, position)) <= 1);
+
+            if (distanceToInnerEdge (rowEdges, position) > cell)
+                CHECK (row == band (rowEdges, position));
+            else
+                CHECK (std::abs (row - band (rowEdges, position)) <= 1);
+        }
+    }
+
+    SECTION ("An edge on a table cell boundary belongs to the zone above it")
+    {
+        CHECK (map.zoneAt (0.5f, 0.35f) == 2);
+        CHECK (map.zoneAt (0.5f - 0.001f, 0.35f) == 1);
+    }
+
+    SECTION ("Positions off the pad land in the outermost zones")
+    {
+        CHECK (map.zoneAt (-0.5f, -0.5f) == 0);
+        CHECK (map.zoneAt (1.0f, 1.0f) == 5);
+        CHECK (map.zoneAt (1.5f, 0.35f) == 2);
+    }
+}
+
+TEST_CASE ("Touchpad zone grids are validated", "[touchpad]")
+{
+    TouchpadZoneMap map;
+    setUneven (map);
+
+    SECTION ("Edges have to ascend strictly")
+    {
+        CHECK_FALSE (map.setGrid ({ 0.0f, 0.5f, 0.4f, 1.0f }, rowEdges, makeZones (6)));
+        CHECK_FALSE (map.setGrid ({ 0.0f, 0.5f, 0.5f, 1.0f }, rowEdges, makeZones (6)));
+        CHECK_FALSE (map.setGrid (columnEdges, { 1.0f, 0.0f }, makeZones (3)));
+    }
+
+    SECTION ("Edges have to span the whole pad")
+    {
+        CHECK_FALSE (map.setGrid ({ 0.1f, 0.5f, 1.0f }, rowEdges, makeZones (4)));
+        CHECK_FALSE (map.setGrid ({ 0.0f, 0.5f, 0.9f }, rowEdges, makeZones (4)));
+        CHECK_FALSE (map.setGrid ({ 0.0f }, rowEdges, {}));
+    }
+
+    SECTION ("There has to be one zone per cell of the grid")
+    {
+        CHECK_FALSE (map.setGrid (columnEdges, rowEdges, makeZones (5)));
+        CHECK_FALSE (map.setGrid (columnEdges, rowEdges, makeZones (7)));
+        CHECK_FALSE (map.setGrid (columnEdges, rowEdges, {}));
+    }
+
+    SECTION ("No more than 64 columns")
+    {
+        std::vector<float> edges;
+        for (int i = 0; i <= 65; ++i)
+            edges.push_back (static_cast<float> (i) / 65.0f);
+
+        CHECK_FALSE (map.setGrid (edges, { 0.0f, 1.0f }, makeZones (65)));
+    }
+
+    // A rejected grid leaves the old one in place
+    CHECK (map.getNumColumns() == 3);
+    CHECK (map.getNumRows() == 2);
+    CHECK (map.zoneAt (0.3f, 0.85f) == 4);
+}
+
+TEST_CASE ("Touchpad fingers play the zones under them", "[touchpad]")
+{
+    MidiRecorder recorder;
+    TouchpadZoneMap map;
+    setUneven (map);
+    map.setEnabled (true);
+
+    // Finger 0 down in the top left zone
+    map.updateFinger (0, true, 0.05f, 0.35f, 0.0f);
+    REQUIRE (recorder.sent.size() == 1);
+    CHECK (recorder.sent[0].message.isNoteOn());
+    CHECK (recorder.sent[0].message.getNoteNumber() == 60);
+    CHECK (recorder.sent[0].message.getVelocity() == 102);
+
+    SECTION ("Moving inside a zone sends nothing more")
+    {
+        map.updateFinger (0, true, 0.08f, 0.1f, 0.0f);
+        map.updateFinger (0, true, 0.02f, 0.6f, 0.0f);
+        CHECK (recorder.sent.size() == 1);
+    }
+
+    SECTION ("Sliding into another zone releases the old note before playing the new one")
+    {
+        map.updateFinger (0, true, 0.3f, 0.35f, 0.0f);
+
+        REQUIRE (recorder.sent.size() == 3);
+        CHECK (recorder.sent[1].message.isNoteOff());
+        CHECK (recorder.sent[1].message.getNoteNumber() == 60);
+        CHECK (recorder.sent[2].message.isNoteOn());
+        CHECK (recorder.sent[2].message.getNoteNumber() == 61);
+
+        // And across the uneven row edge
+        map.updateFinger (0, true, 0.3f, 0.75f, 0.0f);
+        REQUIRE (recorder.sent.size() == 5);
+        CHECK (recorder.sent[3].message.getNoteNumber() == 61);
+        CHECK (recorder.sent[3].message.isNoteOff());
+        CHECK (recorder.sent[4].message.getNoteNumber() == 64);
+        CHECK (MidiOutputManager::getInstance().isNoteActive (1, 64));
+        CHECK_FALSE (MidiOutputManager::getInstance().isNoteActive (1, 61));
+    }
+
+    SECTION ("Lifting the finger releases its note, once")
+    {
+        map.updateFinger (0, false, 0.05f, 0.35f, 0.0f);
+        map.updateFinger (0, false, 0.05f, 0.35f, 0.0f);
+
+        REQUIRE (recorder.sent.size() == 2);
+        CHECK (recorder.sent[1].message.isNoteOff());
+        CHECK (recorder.sent[1].message.getNoteNumber() == 60);
+    }
+
+    SECTION ("Each finger holds its own note")
+    {
+        map.updateFinger (1, true, 0.75f, 0.85f, 0.25f);
+        REQUIRE (recorder.sent.size() == 2);
+        CHECK (recorder.sent[1].message.getNoteNumber() == 65);
+        CHECK (recorder.sent[1].message.getVelocity() == 32);
+
+        map.updateFinger (1, false, 0.75f, 0.85f, 0.0f);
+        REQUIRE (recorder.sent.size() == 3);
+        CHECK (recorder.sent[2].message.getNoteNumber() == 65);
+        CHECK (MidiOutputManager::getInstance().isNoteActive (1, 60));
+    }
+
+    SECTION ("Disabling releases held notes and ignores fingers")
+    {
+        map.setEnabled (false);
+        REQUIRE (recorder.sent.size() == 2);
+        CHECK (recorder.sent[1].message.isNoteOff());
+
+        map.updateFinger (0, true, 0.3f, 0.35f, 0.0f);
+        CHECK (recorder.sent.size() == 2);
+    }
+
+    SECTION ("A new grid releases held notes, a rejected one does not")
+    {
+        CHECK_FALSE (map.setGrid (columnEdges, rowEdges, makeZones (2)));
+        CHECK (recorder.sent.size() == 1);
+
+        map.setUniformGrid (2, 2, Zone::Type::Note, 1, 48);
+        REQUIRE (recorder.sent.size() == 2);
+        CHECK (recorder.sent[1].message.isNoteOff());
+        CHECK (recorder.sent[1].message.getNoteNumber() == 60);
+    }
+
+    SECTION ("A control change zone sends the finger's height within it")
+    {
+        auto zones = makeZones (6);
+        zones[5] = { Zone::Type::ControlChange, 2, 74 };
+        REQUIRE (map.setGrid (columnEdges, rowEdges, zones));
+        recorder.sent.clear();
+
+        // Three quarters of the way up the bottom row
+        map.updateFinger (0, true, 0.75f, 0.775f, 0.0f);
+        REQUIRE (recorder.sent.size() == 1);
+        CHECK (recorder.sent[0].message.isController());
+        CHECK (recorder.sent[0].message.getChannel() == 2);
+        CHECK (recorder.sent[0].message.getControllerNumber() == 74);
+        CHECK (recorder.sent[0].message.getControllerValue() == 95);
+
+        // Leaving it sends no note off
+        map.updateFinger (0, false, 0.75f, 0.775f, 0.0f);
+        CHECK (recorder.sent.size() == 1);
+    }
+}
@@ -0,0 +1,106 @@
+#include "TripleBuffer.h"
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <array>
+#include <thread>
+
+namespace
+{
+    // Every element carries the same number, so a torn copy shows up as a mismatch
+    struct Snapshot
+    {
+        std::array<int, 64> values {};
+
+        void fill (int value) { values.fill (value); }
+        bool isWhole() const { return std::all_of (values.begin(), values.end(), [this] (int v) { return v == values.front(); }); }
+    };
+}
+
+TEST_CASE ("Triple buffer hands over the newest value", "[tripleBuffer]")
+{
+    TripleBuffer<int> buffer;
+
+    SECTION ("Nothing published reads the initial value")
+    {
+        CHECK (buffer.acquire() == 0);
+    }
+
+    SECTION ("A publish is seen by the next acquire")
+    {
+        buffer.publish (1);
+        CHECK (buffer.acquire() == 1);
+
+        buffer.publish (2);
+        CHECK (buffer.acquire() == 2);
+    }
+
+    SECTION ("Without a publish the reader keeps its value")
+    {
+        buffer.publish (1);
+        CHECK (buffer.acquire() == 1);
+        CHECK (buffer.acquire() == 1);
+    }
+
+    SECTION ("A reader that falls behind skips to the newest")
+    {
+        for (int value = 1; value <= 5; ++value)
+            buffer.publish (value);
+
+        CHECK (buffer.acquire() == 5);
+        CHECK (buffer.acquire() == 5);
+    }
+
+    SECTION ("The value read stays put while the writer carries on")
+    {
+        buffer.publish (1);
+        const auto& read = buffer.acquire();
+
+        buffer.publish (2);
+        buffer.publish (3);
+        CHECK (read == 1);
+        CHECK (buffer.acquire() == 3);
+    }
+
+    SECTION ("Filling the write slot in place")
+    {
+        buffer.write() = 7;
+        CHECK (buffer.acquire() == 0);
+
+        buffer.publish();
+        CHECK (buffer.acquire() == 7);
+    }
+}
+
+TEST_CASE ("Triple buffer across two threads", "[tripleBuffer]")
+{
+    constexpr int count = 200000;
+    TripleBuffer<Snapshot> buffer;
+
+    std::thread writer ([&buffer]
+    {
+        for (int value = 1; value <= count; ++value)
+        {
+            buffer.write().fill (value);
+            buffer.publish();
+        }
+    });
+
+    // Values only ever move forwards and are never seen half written
+    int last = 0;
+    bool whole = true;
+    bool ordered = true;
+
+    while (last < count)
+    {
+        const auto& snapshot = buffer.acquire();
+        whole = whole && snapshot.isWhole();
+        ordered = ordered && snapshot.values.front() >= last;
+        last = snapshot.values.front();
+    }
+
+    writer.join();
+
+    CHECK (whole);
+    CHECK (ordered);
+    CHECK (buffer.acquire().values.front() == count);
+}